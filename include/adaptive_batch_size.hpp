@@ -0,0 +1,156 @@
+#ifndef ADAPTIVE_BATCH_SIZE_HPP
+#define ADAPTIVE_BATCH_SIZE_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "ucb_child.hpp"
+
+namespace monte_carlo
+{
+
+// adaptive_batch_size<IFloat>
+//
+// IComputeBatchSize policy that sizes each dbuct grant from the node's child
+// statistics instead of its dispatch count alone, so a node whose choice is
+// settled hands out big grants and one still undecided hands out grants of
+// one.  dbuct looks for the extended signature
+//
+//   compute_batch_size(size_t dispatch_count, size_t parent_visits, size_t n,
+//                      size_t chosen, IFloat c, IStats&& stats) -> size_t
+//
+// and, when present, calls it after selection with the node's visits, the
+// number of children selection scanned, the chosen index, the exploration
+// constant and the same stats(i) -> ucb_child reader selection used.
+//
+// Signals:
+//   batch_signal::ucb_gap     -- the number of consecutive selections UCB1
+//                                would give the chosen child if every mean
+//                                stayed put: its explore term shrinks with
+//                                each visit while its siblings' grow with
+//                                ln N, and the grant runs until a sibling's
+//                                score overtakes it.  A close call grants 1.
+//                                Exact for the engines' default UCB1 scores,
+//                                a heuristic with other ISelect policies.
+//   batch_signal::visit_share -- the chosen child's visits per visit to the
+//                                rest of the node, n_i / (N - n_i): a child
+//                                holding 90% of the visits is granted 9, so
+//                                the grant keeps its share where it is.
+//
+// Any unvisited sibling (which UCB1 would expand next) or a chosen child
+// that is being expanded grants 1, as do the first warmup dispatches of a
+// node, where either signal is noise.  Grants are capped at cap; dbuct still
+// clips them to the frame's remaining budget.  ucb_gap reads every child
+// once more per grant and binary-searches the run length, O(n log cap).
+
+enum class batch_signal
+{
+    ucb_gap,
+    visit_share
+};
+
+template<typename IFloat>
+struct adaptive_batch_size
+{
+    adaptive_batch_size(batch_signal signal, size_t cap, size_t warmup = 0);
+
+    template<typename IStats>
+    size_t compute_batch_size(size_t   dispatch_count,
+                              size_t   parent_visits,
+                              size_t   n,
+                              size_t   chosen,
+                              IFloat   c,
+                              IStats&& stats);
+
+private:
+    batch_signal                   signal_;
+    size_t                         cap_;
+    size_t                         warmup_;
+    std::vector<ucb_child<IFloat>> others_;   // reused scratch for ucb_gap
+};
+
+// ---------------------------------------------------------------------------
+// member function definitions
+// ---------------------------------------------------------------------------
+
+template<typename IFloat>
+adaptive_batch_size<IFloat>::adaptive_batch_size(batch_signal signal, size_t cap, size_t warmup)
+    : signal_(signal)
+    , cap_(cap == 0 ? 1 : cap)
+    , warmup_(warmup)
+{}
+
+template<typename IFloat>
+template<typename IStats>
+size_t adaptive_batch_size<IFloat>::compute_batch_size(size_t   dispatch_count,
+                                                       size_t   parent_visits,
+                                                       size_t   n,
+                                                       size_t   chosen,
+                                                       IFloat   c,
+                                                       IStats&& stats)
+{
+    if (dispatch_count < warmup_ || cap_ == 1)
+        return 1;
+
+    const ucb_child<IFloat> mine = stats(chosen);
+    if (mine.n == 0 || mine.proven)
+        return 1;
+
+    if (signal_ == batch_signal::visit_share)
+    {
+        const size_t rest  = parent_visits > mine.n ? parent_visits - mine.n : 1;
+        const size_t grant = mine.n / rest;
+        return grant < 1 ? 1 : grant < cap_ ? grant : cap_;
+    }
+
+    others_.clear();
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (i == chosen)
+            continue;
+        const ucb_child<IFloat> child = stats(i);
+        if (child.proven)
+            continue;
+        if (child.n == 0)
+            return 1;
+        others_.push_back(child);
+    }
+    if (others_.empty())
+        return cap_;
+
+    // Does the chosen child still win after k more visits to it alone?
+    auto wins = [&](size_t k)
+    {
+        const IFloat ln_parent = std::log(static_cast<IFloat>(parent_visits + k));
+        const IFloat score     = mine.exploit + c * std::sqrt(ln_parent / static_cast<IFloat>(mine.n + k));
+        for (const ucb_child<IFloat>& other : others_)
+            if (other.exploit + c * std::sqrt(ln_parent / static_cast<IFloat>(other.n)) > score)
+                return false;
+        return true;
+    };
+
+    // wins(0) holds: selection just chose it.  Gallop, then bisect, for the
+    // last k below cap at which it still wins.
+    size_t lo = 0;
+    size_t hi = 1;
+    while (hi < cap_ && wins(hi))
+    {
+        lo = hi;
+        hi = hi > cap_ / 2 ? cap_ : 2 * hi;
+    }
+    while (hi - lo > 1)
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (wins(mid))
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return lo + 1;
+}
+
+} // namespace monte_carlo
+
+#endif // ADAPTIVE_BATCH_SIZE_HPP
@@ -0,0 +1,84 @@
+#ifndef AMAF_TABLE_HPP
+#define AMAF_TABLE_HPP
+
+#include <cstddef>
+#include <map>
+#include <utility>
+
+namespace monte_carlo
+{
+
+// amaf_table<NodeHandle, IChoice, IFloat, Map>
+//
+// All-moves-as-first (AMAF) statistics for rave: per (node, choice) visits
+// and accumulated value, credited whenever the choice is played anywhere
+// after the node in an episode, not only directly from it.  sim updates it
+// in terminate() from the episode's whole choice sequence, rollout moves
+// included.
+//
+// Provides:
+//   get_amaf(const NodeHandle&, const IChoice&) -> amaf_stats<IFloat>  ({0, 0} if unseen)
+//   add_amaf(const NodeHandle&, const IChoice&, IFloat delta) -> void  (visits + 1, value + delta)
+//
+// Map parameter: as for edge_map_table, keyed by std::pair<NodeHandle, IChoice>,
+// e.g. std::map, or an unordered map with a pair hash.
+
+template<typename IFloat>
+struct amaf_stats
+{
+    size_t visits;
+    IFloat value;
+};
+
+template<
+    typename NodeHandle,
+    typename IChoice,
+    typename IFloat,
+    template<typename...> typename Map
+>
+struct amaf_table
+{
+    amaf_stats<IFloat> get_amaf(const NodeHandle& node, const IChoice& choice) const;
+    void               add_amaf(const NodeHandle& node, const IChoice& choice, IFloat delta);
+
+    // Pre-sizes the Map for n entries when it has reserve(); no-op otherwise.
+    void reserve(size_t n);
+
+    size_t size() const { return stats_.size(); }
+
+private:
+    Map<std::pair<NodeHandle, IChoice>, amaf_stats<IFloat>> stats_;
+};
+
+// ---------------------------------------------------------------------------
+// member function definitions
+// ---------------------------------------------------------------------------
+
+template<typename NodeHandle, typename IChoice, typename IFloat, template<typename...> typename Map>
+amaf_stats<IFloat> amaf_table<NodeHandle, IChoice, IFloat, Map>::get_amaf(
+    const NodeHandle& node, const IChoice& choice) const
+{
+    auto it = stats_.find({node, choice});
+    if (it == stats_.end()) return {0, IFloat{0}};
+    return it->second;
+}
+
+template<typename NodeHandle, typename IChoice, typename IFloat, template<typename...> typename Map>
+void amaf_table<NodeHandle, IChoice, IFloat, Map>::add_amaf(
+    const NodeHandle& node, const IChoice& choice, IFloat delta)
+{
+    amaf_stats<IFloat>& s = stats_[{node, choice}];
+    ++s.visits;
+    s.value += delta;
+}
+
+template<typename NodeHandle, typename IChoice, typename IFloat, template<typename...> typename Map>
+void amaf_table<NodeHandle, IChoice, IFloat, Map>::reserve(size_t n)
+{
+    if constexpr (requires { stats_.reserve(n); })
+        stats_.reserve(n);
+}
+
+} // namespace monte_carlo
+
+#endif // AMAF_TABLE_HPP
@@ -0,0 +1,87 @@
+#ifndef CHOICE_SPAN_HPP
+#define CHOICE_SPAN_HPP
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+namespace monte_carlo
+{
+
+// choice_span<IChoice, Extent>
+//
+// Unchecked, read-only view of a contiguous choice set, for passing to sim /
+// dbuct choose() as both the IGetChoiceCount and IGetChoiceAt argument:
+//
+//   const std::array<int, 3> jumps = {1, 2, 3};
+//   monte_carlo::choice_span<int, 3> cs(jumps);
+//   s.choose(cs, cs);
+//
+// at(i) indexes the data directly, where std::vector::at and
+// std::array::at bounds-check every call in the selection loop.  With a
+// fixed Extent the view also carries a static arity (below), so the engine
+// passes the choice count to select_child as a compile-time constant and
+// the scoring loop is fully unrolled for the small branching factors of
+// most games (see select_child.hpp).  With std::dynamic_extent the view is
+// only unchecked.
+//
+// The view holds a pointer; the choices must outlive it, and with a fixed
+// Extent there must be exactly Extent of them.
+
+template<typename IChoice, size_t Extent = std::dynamic_extent>
+struct choice_span
+{
+    template<typename IChoices>
+    explicit choice_span(const IChoices& choices) : choices_(choices) {}
+
+    constexpr size_t size()       const { return choices_.size(); }
+    const IChoice&   at(size_t i) const { return choices_[i]; }
+
+private:
+    std::span<const IChoice, Extent> choices_;
+};
+
+// choice_arity_v<IGetChoiceCount>
+//
+// The choice count known at compile time, or 0 if it is only known at run
+// time.  Taken from a static constexpr size_t arity member if the type has
+// one, from choice_span<T, N> and from std::array<T, N>.  A type with
+// widened_size() (progressive_widening) scans a varying prefix and has
+// none.  Both engines select over integral_constant<size_t, arity> when it
+// is nonzero.
+
+template<typename IGetChoiceCount>
+struct choice_arity : std::integral_constant<size_t, 0> {};
+
+template<typename IGetChoiceCount>
+    requires requires { { IGetChoiceCount::arity } -> std::convertible_to<size_t>; }
+struct choice_arity<IGetChoiceCount> : std::integral_constant<size_t, IGetChoiceCount::arity> {};
+
+template<typename IChoice, size_t Extent>
+struct choice_arity<choice_span<IChoice, Extent>>
+    : std::integral_constant<size_t, Extent == std::dynamic_extent ? 0 : Extent> {};
+
+template<typename IChoice, size_t N>
+struct choice_arity<std::array<IChoice, N>> : std::integral_constant<size_t, N> {};
+
+template<typename IGetChoiceCount>
+inline constexpr size_t choice_arity_v =
+    requires (const IGetChoiceCount& c, size_t v) { c.widened_size(v); }
+        ? 0 : choice_arity<IGetChoiceCount>::value;
+
+// The count select_child iterates over: integral_constant<size_t, arity>
+// for a fixed arity, n otherwise.
+template<typename IGetChoiceCount>
+auto selection_count(size_t n)
+{
+    if constexpr (choice_arity_v<IGetChoiceCount> != 0)
+        return std::integral_constant<size_t, choice_arity_v<IGetChoiceCount>>{};
+    else
+        return n;
+}
+
+} // namespace monte_carlo
+
+#endif // CHOICE_SPAN_HPP
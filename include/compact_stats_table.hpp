@@ -0,0 +1,200 @@
+#ifndef COMPACT_STATS_TABLE_HPP
+#define COMPACT_STATS_TABLE_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace monte_carlo
+{
+
+// compact_stats_table<NodeHandle, IFloat, Map, Counter, Value>
+//
+// Per-node visits and accumulated value packed into one record, keyed by
+// NodeHandle.  A visits_table + value_table pair pays for two map entries per
+// node and stores a size_t and an IFloat; this table pays for one entry
+// holding a Counter and a Value (uint32_t + float = 8 bytes by default).
+// When Value is narrower than IFloat the record holds the mean, not the sum,
+// and get_value() returns mean * visits in IFloat: a float sum of unit rewards
+// stops growing near 2^24 updates and its mean then decays, while a float
+// mean only stops moving once each update is below its precision.  A Value as
+// wide as IFloat holds the sum, as value_table does.
+//
+// Satisfies:
+//   IGetVisits: get_visits(const NodeHandle&) -> size_t  (0 if unseen)
+//   IGetValue:  get_value(const NodeHandle&)  -> IFloat  (IFloat{} if unseen)
+//   ISetVisits: set_visits(const NodeHandle&, size_t) -> void
+//   ISetValue:  set_value(const NodeHandle&, IFloat)  -> void
+//
+// Pass the same compact_stats_table object for all four sim / dbuct
+// visit and value parameters.
+//
+// Saturation: visit counts above the Counter range are stored as its maximum
+// and saturated() turns true.  Counts never wrap, so a heavily visited node is
+// never mistaken for an unexpanded one.  The set_value() that follows a
+// clamped set_visits() for the same node (the order sim and dbuct back up in)
+// is scaled by the stored count over the count that was asked for, so
+// value / visits stays the true running mean past saturation.  The engines keep their own arithmetic in
+// size_t / IFloat and only narrow on store.
+
+template<
+    typename NodeHandle,
+    typename IFloat,
+    template<typename...> typename Map,
+    typename Counter = uint32_t,
+    typename Value   = float
+>
+struct compact_stats_table
+{
+    struct record
+    {
+        Counter visits;
+        Value   value;    // the mean if stores_mean (the value itself while visits is 0)
+    };
+
+    static constexpr bool stores_mean = sizeof(Value) < sizeof(IFloat);
+
+    compact_stats_table() = default;
+
+    // Forwards to the Map constructor, e.g. a spill_config for spill_map.
+    template<typename... MapArgs>
+        requires std::constructible_from<Map<NodeHandle, record>, MapArgs...>
+    explicit compact_stats_table(MapArgs&&... args)
+        : records_(std::forward<MapArgs>(args)...)
+    {}
+
+    size_t get_visits(const NodeHandle& h) const;
+    IFloat get_value(const NodeHandle& h)  const;
+    void   set_visits(const NodeHandle& h, size_t v);
+    void   set_value(const NodeHandle& h, IFloat v);
+
+    // Pre-sizes the Map for n entries when it has reserve(); no-op otherwise.
+    void reserve(size_t n);
+
+    // Cache hint for a lookup of h soon after; only when the Map has
+    // prefetch() (incremental_hash_map).  sim / dbuct issue it for every
+    // child before scoring.
+    void prefetch(const NodeHandle& h) const
+        requires requires (const Map<NodeHandle, record>& m) { m.prefetch(h); }
+    {
+        records_.prefetch(h);
+    }
+
+    // Calls f(handle, size_t visits) for every entry written so far.
+    template<typename F>
+    void for_each(F&& f) const;
+
+    bool saturated() const { return saturated_; }
+
+private:
+    static IFloat sum_of(const record& r);
+
+    Map<NodeHandle, record>   records_;
+    bool                      saturated_ = false;
+    std::optional<NodeHandle> clamped_;            // last set_visits() above the Counter range
+    size_t                    clamped_visits_ = 0; // the count it asked for
+};
+
+// ---------------------------------------------------------------------------
+// member function definitions
+// ---------------------------------------------------------------------------
+
+template<typename NodeHandle, typename IFloat, template<typename...> typename Map,
+         typename Counter, typename Value>
+size_t compact_stats_table<NodeHandle, IFloat, Map, Counter, Value>::get_visits(
+    const NodeHandle& h) const
+{
+    auto it = records_.find(h);
+    if (it == records_.end()) return 0;
+    return it->second.visits;
+}
+
+template<typename NodeHandle, typename IFloat, template<typename...> typename Map,
+         typename Counter, typename Value>
+IFloat compact_stats_table<NodeHandle, IFloat, Map, Counter, Value>::get_value(
+    const NodeHandle& h) const
+{
+    auto it = records_.find(h);
+    if (it == records_.end()) return IFloat{};
+    return sum_of(it->second);
+}
+
+template<typename NodeHandle, typename IFloat, template<typename...> typename Map,
+         typename Counter, typename Value>
+void compact_stats_table<NodeHandle, IFloat, Map, Counter, Value>::set_visits(
+    const NodeHandle& h, size_t v)
+{
+    clamped_.reset();
+    if (v > std::numeric_limits<Counter>::max())
+    {
+        clamped_        = h;
+        clamped_visits_ = v;
+        v               = std::numeric_limits<Counter>::max();
+        saturated_      = true;
+    }
+
+    record& r = records_[h];
+    if constexpr (stores_mean)
+    {
+        // Keep the value: rescale the mean to the new count.
+        const IFloat sum = sum_of(r);
+        r.value = static_cast<Value>(v == 0 ? sum : sum / static_cast<IFloat>(v));
+    }
+    r.visits = static_cast<Counter>(v);
+}
+
+template<typename NodeHandle, typename IFloat, template<typename...> typename Map,
+         typename Counter, typename Value>
+void compact_stats_table<NodeHandle, IFloat, Map, Counter, Value>::set_value(
+    const NodeHandle& h, IFloat v)
+{
+    record& r = records_[h];
+    size_t  n = r.visits;
+    if (clamped_ && *clamped_ == h)
+    {
+        n = clamped_visits_;
+        clamped_.reset();
+    }
+
+    if constexpr (stores_mean)
+        r.value = static_cast<Value>(n == 0 ? v : v / static_cast<IFloat>(n));
+    else if (n != r.visits)
+        r.value = static_cast<Value>(v * static_cast<IFloat>(r.visits) / static_cast<IFloat>(n));
+    else
+        r.value = static_cast<Value>(v);
+}
+
+template<typename NodeHandle, typename IFloat, template<typename...> typename Map,
+         typename Counter, typename Value>
+IFloat compact_stats_table<NodeHandle, IFloat, Map, Counter, Value>::sum_of(const record& r)
+{
+    if (!stores_mean || r.visits == 0)
+        return static_cast<IFloat>(r.value);
+    return static_cast<IFloat>(r.value) * static_cast<IFloat>(r.visits);
+}
+
+template<typename NodeHandle, typename IFloat, template<typename...> typename Map,
+         typename Counter, typename Value>
+void compact_stats_table<NodeHandle, IFloat, Map, Counter, Value>::reserve(size_t n)
+{
+    if constexpr (requires { records_.reserve(n); })
+        records_.reserve(n);
+}
+
+template<typename NodeHandle, typename IFloat, template<typename...> typename Map,
+         typename Counter, typename Value>
+template<typename F>
+void compact_stats_table<NodeHandle, IFloat, Map, Counter, Value>::for_each(F&& f) const
+{
+    for (const auto& [h, r] : records_)
+        f(h, static_cast<size_t>(r.visits));
+}
+
+} // namespace monte_carlo
+
+#endif // COMPACT_STATS_TABLE_HPP
@@ -1,13 +1,83 @@
 #ifndef DBUCT_HPP
 #define DBUCT_HPP
 
+#include <algorithm>
 #include <cmath>
+#include <concepts>
 #include <limits>
-#include <stack>
+#include <utility>
+#include <vector>
+
+#include "choice_span.hpp"
+#include "inline_stack.hpp"
+#include "no_accumulator.hpp"
+#include "no_edge_visits.hpp"
+#include "select_child.hpp"
+#include "ucb1.hpp"
+#include "ucb_child.hpp"
 
 namespace monte_carlo
 {
 
+// Optional IEdgeVisits (default no_edge_visits): with an edge table, selection
+// uses the edge visit count in the explore term exactly as sim does (see
+// "Transpositions" in sim.hpp).  Edge counts follow the parent's node visits:
+// a child frame's visit lump is added to edge (parent, child) when the frame
+// is popped by backstep(), so when choose() runs at a frame, every edge out
+// of it is as current as the frame's own visit count.
+//
+// Like sim, selection honours an optional widened_size(parent_visits) on the
+// IGetChoiceCount argument (progressive widening, see progressive_widening.hpp),
+// a choice count fixed at compile time (std::array, choice_span, see
+// choice_span.hpp), and an optional get_first_play_urgency(parent, parent_mean) or select()
+// on the ISelect policy (see first_play_urgency.hpp and
+// ucb_argmax_table.hpp).  Score-based ISelect policies (ucb1, ucb1_tuned,
+// puct) run through the same select_child() loop as in sim; with a
+// value_moments_table the squared deltas are lumped and backed up per frame
+// alongside the value lump.  With a proof_table, a proof found at the top
+// frame is carried by a flag on the frame and reported to the parent when
+// backstep() pops it, so it reaches the root as the lumps do.
+//
+// Grants: IComputeBatchSize::compute_batch_size(D) sizes each grant from the
+// node's pre-increment dispatch count D (linear_batch_increment,
+// geometric_batch_increment).  A policy that instead provides
+//   compute_batch_size(D, parent_visits, n, chosen, c, stats) -> size_t
+// is called after selection with the node's visits, the n children scanned,
+// the chosen index, the exploration constant and the stats(i) reader, so it
+// can size the grant from how settled the choice is (adaptive_batch_size).
+//
+// Prefetch: with read tables that provide prefetch(const INodeHandle&),
+// choose() hints every child's entries before scoring them, as in sim.
+// Backprop touches one frame's node per backstep() and is left alone.
+
+// Frames: the frame stack is an inline_stack holding MaxDepth frames inside
+// the dbuct object (default 64); deeper searches spill to a heap vector that
+// keeps its capacity.  Together with reset(root), which ends the current
+// search between episodes and starts another on the same object, a long
+// training loop runs with no heap allocations per simulation in the engine
+// once its stack has reached its deepest point.
+//
+// Accumulators: with an IAccumulator value type (default no_accumulator,
+// which costs nothing), every frame also holds a caller value for the path
+// from the root to it.  choose(count, at, accumulate) computes a new
+// frame's value from its parent's, accumulate(prefix, child, choice), and
+// backstep() discards it with the frame; accumulated() reads the top
+// frame's.  A cumulative reward or a running state digest of the camped
+// prefix is then read in O(1) when an episode resumes, instead of being
+// recomputed over the path.  Rollout choices push no frame and are not
+// accumulated.
+//
+// Forced moves: with a choice type that has a static folds_forced_moves
+// (forced_moves), an in-tree step with a single choice pushes no frame; the
+// engine follows the chain's handles (and accumulator) past the top frame
+// and scores the next decision as the top frame's children.  See
+// forced_moves.hpp.
+//
+// Resuming: after terminate() the next episode starts at the top frame,
+// depth() - 1 in-tree choices below the root.  search_driver tracks them
+// and brings a game model there by undo() (make/unmake) or by replay from
+// the root; see search_driver.hpp.
+
 template<
     typename INodeHandle,
     typename IChoice,
@@ -24,7 +94,10 @@ template<
     typename IGetChoiceAt,
     typename IRolloutChoose,
     typename IGetValueDelta,
-    typename IGetExplorationConstant
+    typename ISelect,
+    typename IEdgeVisits  = no_edge_visits,
+    typename IAccumulator = no_accumulator,
+    size_t   MaxDepth     = 64
 >
 struct dbuct
 {
@@ -38,26 +111,136 @@ struct dbuct
           IWalker&                 walker,
           IRolloutChoose&          rollout,
           IGetValueDelta&          value_delta,
-          IGetExplorationConstant& get_exploration_constant,
+          ISelect&                 select,
+          INodeHandle              root)
+        requires std::same_as<IEdgeVisits, no_edge_visits>;
+
+    dbuct(IGetVisits&              get_visits,
+          IGetValue&               get_value,
+          ISetVisits&              set_visits,
+          ISetValue&               set_value,
+          IGetDispatches&          get_dispatches,
+          ISetDispatches&          set_dispatches,
+          IComputeBatchSize&       compute_batch_size,
+          IWalker&                 walker,
+          IRolloutChoose&          rollout,
+          IGetValueDelta&          value_delta,
+          ISelect&                 select,
+          IEdgeVisits&             edge_visits,
           INodeHandle              root);
 
     IChoice choose(const IGetChoiceCount& get_choice_count,
-                   const IGetChoiceAt&    get_choice_at);
+                   const IGetChoiceAt&    get_choice_at)
+    {
+        return choose(get_choice_count, get_choice_at,
+                      [](const IAccumulator& prefix, const INodeHandle&, const IChoice&) { return prefix; });
+    }
+
+    // As above; an in-tree choice pushes its frame with
+    // accumulate(parent's accumulated(), child handle, choice).
+    template<typename IAccumulate>
+    IChoice choose(const IGetChoiceCount& get_choice_count,
+                   const IGetChoiceAt&    get_choice_at,
+                   const IAccumulate&     accumulate);
 
     void terminate();
 
     void backstep();
 
+    // Flushes every frame's pending lumps up to the old root, then starts
+    // over at root with a single frame, reusing the frame stack.
+    void reset(INodeHandle root);
+
     size_t depth() const { return stack_.size(); }
+
+    // The top frame's accumulator: the value for the path to the frame the
+    // next episode starts from (IAccumulator{} at the root).
+    const IAccumulator& accumulated() const { return stack_.top().accumulated; }
     bool   in_rollout() const { return in_rollout_; }
 
+    // True once the root is proven (only with a proof_table; see proof_table.hpp).
+    bool solved() const;
+
 private:
+    static constexpr bool tracks_edges = !std::same_as<IEdgeVisits, no_edge_visits>;
+    static constexpr bool has_fpu      = requires (const ISelect& g,
+                                                   const INodeHandle&             h,
+                                                   IFloat                         m)
+                                         { g.get_first_play_urgency(h, m); };
+    static constexpr bool has_argmax   = requires (ISelect& g,
+                                                   const INodeHandle&       h,
+                                                   size_t                   z,
+                                                   IFloat                   f,
+                                                   ucb_child<IFloat>        (*stats)(size_t))
+                                         { { g.select(h, z, z, f, stats) } -> std::same_as<ucb_selection>; };
+    static constexpr bool scores_children = requires { ISelect::scores_unvisited; };
+    static constexpr bool reads_squares   = []
+    {
+        if constexpr (requires { ISelect::needs_squares; })
+            return ISelect::needs_squares;
+        else
+            return false;
+    }();
+    static constexpr bool tracks_squares  = requires (IGetValue& g, ISetValue& s,
+                                                      const INodeHandle& h, IFloat f)
+                                            { g.get_value_squares(h); s.set_value_squares(h, f); };
+    static_assert(!reads_squares || tracks_squares,
+                  "ISelect needs squares: pass a value table with get/set_value_squares (value_moments_table)");
+    static constexpr bool has_proofs      = requires (IGetValue& g, ISetValue& s,
+                                                      const INodeHandle& h, IFloat f, size_t z)
+                                            { g.is_proven(h); g.get_proven_value(h);
+                                              s.set_child_count(h, z); s.prove(h, f);
+                                              s.add_proven_child(h, f); };
+    static_assert(!has_proofs || !has_argmax,
+                  "proof_table scores proven children itself: use a scoring ISelect, "
+                  "not a select() hook (ucb_argmax_table, sequential_halving)");
+    static constexpr bool adaptive_grants = requires (IComputeBatchSize& b, size_t z, IFloat f,
+                                                      ucb_child<IFloat> (*stats)(size_t))
+                                            { { b.compute_batch_size(z, z, z, z, f, stats) }
+                                                -> std::convertible_to<size_t>; };
+    static constexpr bool folds_forced = requires { IGetChoiceCount::folds_forced_moves; };
+    static constexpr bool prefetches_visits = requires (const IGetVisits& g, const INodeHandle& h)
+                                              { g.prefetch(h); };
+    static constexpr bool prefetches_values = requires (const IGetValue& g, const INodeHandle& h)
+                                              { g.prefetch(h); };
+    static constexpr bool prefetches        = prefetches_visits || prefetches_values;
+    // UCB1-family scans stop at the first unvisited child (select_child).
+    static constexpr bool stops_at_unvisited = []
+    {
+        if constexpr (has_argmax)
+            return false;
+        else if constexpr (scores_children)
+            return !ISelect::scores_unvisited;
+        else
+            return true;
+    }();
+    static_assert(!requires (ISelect& g) { g.amaf(); },
+                  "rave needs each episode's choice sequence, which lumped backprop does not keep: use sim");
+
+    dbuct(IGetVisits&              get_visits,
+          IGetValue&               get_value,
+          ISetVisits&              set_visits,
+          ISetValue&               set_value,
+          IGetDispatches&          get_dispatches,
+          ISetDispatches&          set_dispatches,
+          IComputeBatchSize&       compute_batch_size,
+          IWalker&                 walker,
+          IRolloutChoose&          rollout,
+          IGetValueDelta&          value_delta,
+          ISelect&                 select,
+          IEdgeVisits*             edge_visits,
+          INodeHandle              root,
+          int);
+
     struct frame
     {
         INodeHandle handle;
         size_t      budget;
         size_t      visit_lump;
         IFloat      value_lump;
+        IFloat      square_lump;   // squared deltas, with a value_moments_table
+        bool        proved;        // node newly proven, not yet reported to the parent
+        [[no_unique_address]] IAccumulator accumulated;
     };
 
     IGetVisits&              get_visits_;
@@ -70,25 +253,74 @@ private:
     IWalker&                 walker_;
     IRolloutChoose&          rollout_;
     IGetValueDelta&          value_delta_;
-    IGetExplorationConstant& get_exploration_constant_;
+    ISelect&                 select_;
+    IEdgeVisits*             edge_visits_;   // null without an edge table
 
-    std::stack<frame> stack_;
+    INodeHandle       root_;
+    inline_stack<frame, MaxDepth> stack_;
     bool              in_rollout_;
+    bool              rolled_out_;   // rollout moves since the last terminate()
+
+    // Past the top frame down a folded forced chain: the position's handle
+    // and accumulator (forced_moves only).
+    bool              folding_;
+    INodeHandle       position_;
+    [[no_unique_address]] IAccumulator position_accumulated_;
+
+    // Child handles of this choose(), only with prefetch.
+    std::vector<INodeHandle> children_;
+
+    // Cache hints for h's entries in the read tables (once for a table
+    // passed as both).
+    void prefetch_stats(const INodeHandle& h) const
+    {
+        if constexpr (prefetches_visits)
+            get_visits_.prefetch(h);
+        if constexpr (prefetches_values)
+            if (static_cast<const void*>(&get_value_) != static_cast<const void*>(&get_visits_))
+                get_value_.prefetch(h);
+    }
 
     void add_visits(size_t v);
-    void add_value(IFloat l);
+    void add_value(IFloat l, IFloat l2);
 };
 
 // Legend: INH=INodeHandle, IC=IChoice, IF=IFloat, IGVis=IGetVisits, IGVal=IGetValue,
 //         ISVis=ISetVisits, ISVal=ISetValue, IGD=IGetDispatches, ISD=ISetDispatches,
 //         IBS=IComputeBatchSize, IW=IWalker, IGCC=IGetChoiceCount, IGCA=IGetChoiceAt,
-//         IRC=IRolloutChoose, IGVD=IGetValueDelta, IGEC=IGetExplorationConstant
+//         IRC=IRolloutChoose, IGVD=IGetValueDelta, ISel=ISelect,
+//         IEV=IEdgeVisits, MD=MaxDepth
+
+template<typename INH, typename IC, typename IF,
+         typename IGVis, typename IGVal, typename ISVis, typename ISVal,
+         typename IGD, typename ISD, typename IBS,
+         typename IW, typename IGCC, typename IGCA, typename IRC, typename IGVD, typename ISel,
+         typename IEV, typename IAcc, size_t MD>
+dbuct<INH, IC, IF, IGVis, IGVal, ISVis, ISVal, IGD, ISD, IBS, IW, IGCC, IGCA, IRC, IGVD, ISel, IEV, IAcc, MD>::dbuct(
+        IGVis& get_visits,
+        IGVal& get_value,
+        ISVis& set_visits,
+        ISVal& set_value,
+        IGD&   get_dispatches,
+        ISD&   set_dispatches,
+        IBS&   compute_batch_size,
+        IW&    walker,
+        IRC&   rollout,
+        IGVD&  value_delta,
+        ISel&  select,
+        INH    root)
+        requires std::same_as<IEV, no_edge_visits>
+    : dbuct(get_visits, get_value, set_visits, set_value, get_dispatches, set_dispatches,
+            compute_batch_size, walker, rollout, value_delta, select,
+            nullptr, root, 0)
+{}
 
 template<typename INH, typename IC, typename IF,
          typename IGVis, typename IGVal, typename ISVis, typename ISVal,
          typename IGD, typename ISD, typename IBS,
-         typename IW, typename IGCC, typename IGCA, typename IRC, typename IGVD, typename IGEC>
-dbuct<INH, IC, IF, IGVis, IGVal, ISVis, ISVal, IGD, ISD, IBS, IW, IGCC, IGCA, IRC, IGVD, IGEC>::dbuct(
+         typename IW, typename IGCC, typename IGCA, typename IRC, typename IGVD, typename ISel,
+         typename IEV, typename IAcc, size_t MD>
+dbuct<INH, IC, IF, IGVis, IGVal, ISVis, ISVal, IGD, ISD, IBS, IW, IGCC, IGCA, IRC, IGVD, ISel, IEV, IAcc, MD>::dbuct(
         IGVis& get_visits,
         IGVal& get_value,
         ISVis& set_visits,
@@ -99,8 +331,34 @@ dbuct<INH, IC, IF, IGVis, IGVal, ISVis, ISVal, IGD, ISD, IBS, IW, IGCC, IGCA, IR
         IW&    walker,
         IRC&   rollout,
         IGVD&  value_delta,
-        IGEC&  get_exploration_constant,
+        ISel&  select,
+        IEV&   edge_visits,
         INH    root)
+    : dbuct(get_visits, get_value, set_visits, set_value, get_dispatches, set_dispatches,
+            compute_batch_size, walker, rollout, value_delta, select,
+            &edge_visits, root, 0)
+{}
+
+template<typename INH, typename IC, typename IF,
+         typename IGVis, typename IGVal, typename ISVis, typename ISVal,
+         typename IGD, typename ISD, typename IBS,
+         typename IW, typename IGCC, typename IGCA, typename IRC, typename IGVD, typename ISel,
+         typename IEV, typename IAcc, size_t MD>
+dbuct<INH, IC, IF, IGVis, IGVal, ISVis, ISVal, IGD, ISD, IBS, IW, IGCC, IGCA, IRC, IGVD, ISel, IEV, IAcc, MD>::dbuct(
+        IGVis& get_visits,
+        IGVal& get_value,
+        ISVis& set_visits,
+        ISVal& set_value,
+        IGD&   get_dispatches,
+        ISD&   set_dispatches,
+        IBS&   compute_batch_size,
+        IW&    walker,
+        IRC&   rollout,
+        IGVD&  value_delta,
+        ISel&  select,
+        IEV*   edge_visits,
+        INH    root,
+        int)
     : get_visits_(get_visits)
     , get_value_(get_value)
     , set_visits_(set_visits)
@@ -111,73 +369,166 @@ dbuct<INH, IC, IF, IGVis, IGVal, ISVis, ISVal, IGD, ISD, IBS, IW, IGCC, IGCA, IR
     , walker_(walker)
     , rollout_(rollout)
     , value_delta_(value_delta)
-    , get_exploration_constant_(get_exploration_constant)
+    , select_(select)
+    , edge_visits_(edge_visits)
+    , root_(root)
     , in_rollout_(false)
+    , rolled_out_(false)
+    , folding_(false)
+    , position_(root)
+{
+    stack_.push({root, std::numeric_limits<size_t>::max(), 0, IF{0}, IF{0}, false, IAcc{}});
+}
+
+template<typename INH, typename IC, typename IF,
+         typename IGVis, typename IGVal, typename ISVis, typename ISVal,
+         typename IGD, typename ISD, typename IBS,
+         typename IW, typename IGCC, typename IGCA, typename IRC, typename IGVD, typename ISel,
+         typename IEV, typename IAcc, size_t MD>
+void
+dbuct<INH, IC, IF, IGVis, IGVal, ISVis, ISVal, IGD, ISD, IBS, IW, IGCC, IGCA, IRC, IGVD, ISel, IEV, IAcc, MD>::reset(
+        INH root)
 {
-    stack_.push({root, std::numeric_limits<size_t>::max(), 0, IF{0}});
+    while (stack_.size() > 1)
+        backstep();
+    stack_.pop();
+
+    root_       = root;
+    in_rollout_ = false;
+    rolled_out_ = false;
+    folding_    = false;
+    stack_.push({root, std::numeric_limits<size_t>::max(), 0, IF{0}, IF{0}, false, IAcc{}});
 }
 
 template<typename INH, typename IC, typename IF,
          typename IGVis, typename IGVal, typename ISVis, typename ISVal,
          typename IGD, typename ISD, typename IBS,
-         typename IW, typename IGCC, typename IGCA, typename IRC, typename IGVD, typename IGEC>
+         typename IW, typename IGCC, typename IGCA, typename IRC, typename IGVD, typename ISel,
+         typename IEV, typename IAcc, size_t MD>
+template<typename IAccumulate>
 IC
-dbuct<INH, IC, IF, IGVis, IGVal, ISVis, ISVal, IGD, ISD, IBS, IW, IGCC, IGCA, IRC, IGVD, IGEC>::choose(
-        const IGCC& get_choice_count,
-        const IGCA& get_choice_at)
+dbuct<INH, IC, IF, IGVis, IGVal, ISVis, ISVal, IGD, ISD, IBS, IW, IGCC, IGCA, IRC, IGVD, ISel, IEV, IAcc, MD>::choose(
+        const IGCC&        get_choice_count,
+        const IGCA&        get_choice_at,
+        const IAccumulate& accumulate)
 {
     frame& current        = stack_.top();
     size_t current_visits = get_visits_.get_visits(current.handle);
     
     if (in_rollout_)
+    {
+        rolled_out_ = true;
         return rollout_.rollout_choose(get_choice_count, get_choice_at);
+    }
 
-    IF     best_score = -std::numeric_limits<IF>::infinity();
-    size_t best_i     = 0;
-    size_t n          = get_choice_count.size();
-    IF     c          = get_exploration_constant_.get_exploration_constant(current.handle);
-    IF     ln_parent  = std::log(static_cast<IF>(current_visits));
-
-    for (size_t i = 0; i < n; ++i)
-    {
-        IC        candidate = get_choice_at.at(i);
-        const INH child     = walker_.walk(current.handle, candidate);
-        size_t    child_v   = get_visits_.get_visits(child);
+    // Handle and accumulator of the position: the top frame's, or the end
+    // of the forced chain folded below it.
+    const INH&  at          = folding_ ? position_ : current.handle;
+    const IAcc& accumulated = folding_ ? position_accumulated_ : current.accumulated;
 
-        if (child_v == 0)
+    if constexpr (folds_forced)
+        if (get_choice_count.size() == 1)
         {
-            best_score = std::numeric_limits<IF>::infinity();
-            best_i     = i;
-            break;
+            IC  chosen = get_choice_at.at(0);
+            INH child  = walker_.walk(at, chosen);
+            position_accumulated_ = accumulate(accumulated, child, chosen);
+            position_             = std::move(child);
+            folding_              = true;
+            return chosen;
         }
 
-        IF exploit = get_value_.get_value(child) / static_cast<IF>(child_v);
-        IF explore = std::sqrt(ln_parent / static_cast<IF>(child_v));
-        IF score   = exploit + c * explore;
+    if constexpr (has_proofs)
+        set_value_.set_child_count(current.handle, get_choice_count.size());
+
+    size_t n = get_choice_count.size();
 
-        if (score > best_score)
+    if constexpr (requires { get_choice_count.widened_size(current_visits); })
+        n = std::min(n, get_choice_count.widened_size(current_visits));
+
+    // A fixed arity (choice_span, std::array) makes the count a constant.
+    const auto count = selection_count<IGCC>(n);
+
+    // Tables with prefetch(): hint every child's entries before scoring.
+    if constexpr (prefetches)
+    {
+        // A node visited N times has at most N visited children, so a scan
+        // that stops at the first unvisited one reads at most N + 1.
+        const size_t hinted = stops_at_unvisited ? std::min(n, current_visits + 1) : n;
+        children_.clear();
+        for (size_t i = 0; i < hinted; ++i)
         {
-            best_score = score;
-            best_i     = i;
+            children_.push_back(walker_.walk(at, get_choice_at.at(i)));
+            prefetch_stats(children_.back());
         }
     }
 
-    IC  chosen       = get_choice_at.at(best_i);
-    INH child_handle = walker_.walk(current.handle, chosen);
+    IF unvisited = std::numeric_limits<IF>::infinity();
+    if constexpr (has_fpu)
+        unvisited = select_.get_first_play_urgency(
+            current.handle,
+            current_visits == 0 ? IF{0}
+                                : get_value_.get_value(current.handle) / static_cast<IF>(current_visits));
+
+    auto stats = [&](size_t i)
+    {
+        const INH     child_handle = [&]
+        {
+            if constexpr (prefetches)
+                if (i < children_.size())
+                    return children_[i];
+            return walker_.walk(at, get_choice_at.at(i));
+        }();
+        ucb_child<IF> child{IF{0}, 0, get_visits_.get_visits(child_handle), IF{0}, false, IF{0}, 0};
+
+        child.n = child.v;
+        if constexpr (tracks_edges)
+            child.n = edge_visits_->get_edge_visits(current.handle, child_handle);
+
+        if (child.v != 0)
+        {
+            child.exploit = get_value_.get_value(child_handle) / static_cast<IF>(child.v);
+            if constexpr (reads_squares)
+                child.squares = get_value_.get_value_squares(child_handle);
+        }
+        if constexpr (has_proofs)
+            if (get_value_.is_proven(child_handle))
+            {
+                child.exploit = get_value_.get_proven_value(child_handle);
+                child.proven  = true;
+            }
+        return child;
+    };
+
+    ucb_selection selection;
+    if constexpr (has_argmax)
+        selection = select_.select(current.handle, n, current_visits, unvisited, stats);
+    else if constexpr (scores_children)
+        selection = select_child(select_, current.handle, current_visits, count, unvisited, stats);
+    else
+        selection = select_child(ucb1<IF, ISel>(select_),
+                                 current.handle, current_visits, count, unvisited, stats);
+
+    IC  chosen       = get_choice_at.at(selection.index);
+    INH child_handle = walker_.walk(at, chosen);
 
     size_t current_dispatches = get_dispatches_.get_dispatches(current.handle);
     size_t remaining_budget   = current.budget - current.visit_lump;
-    size_t grant_k = std::min(
-        compute_batch_size_.compute_batch_size(current_dispatches),
-        remaining_budget);
+    size_t batch_size;
+    if constexpr (adaptive_grants)
+        batch_size = compute_batch_size_.compute_batch_size(
+            current_dispatches, current_visits, n, selection.index,
+            select_.get_exploration_constant(current.handle), stats);
+    else
+        batch_size = compute_batch_size_.compute_batch_size(current_dispatches);
+    size_t grant_k = std::min(batch_size, remaining_budget);
     set_dispatches_.set_dispatches(current.handle, current_dispatches + 1);
 
-    stack_.push({child_handle, grant_k, 0, IF{0}});
+    IAcc child_accumulated = accumulate(accumulated, child_handle, chosen);
+    folding_ = false;
+    stack_.push({child_handle, grant_k, 0, IF{0}, IF{0}, false, std::move(child_accumulated)});
 
-    size_t child_visits = get_visits_.get_visits(child_handle);
-    
     // expansion+rollout phase (frame already pushed so expansion done)
-    if (child_visits == 0)
+    if (selection.expand)
         in_rollout_ = true;
 
     return chosen;
@@ -186,12 +537,22 @@ dbuct<INH, IC, IF, IGVis, IGVal, ISVis, ISVal, IGD, ISD, IBS, IW, IGCC, IGCA, IR
 template<typename INH, typename IC, typename IF,
          typename IGVis, typename IGVal, typename ISVis, typename ISVal,
          typename IGD, typename ISD, typename IBS,
-         typename IW, typename IGCC, typename IGCA, typename IRC, typename IGVD, typename IGEC>
+         typename IW, typename IGCC, typename IGCA, typename IRC, typename IGVD, typename ISel,
+         typename IEV, typename IAcc, size_t MD>
 void
-dbuct<INH, IC, IF, IGVis, IGVal, ISVis, ISVal, IGD, ISD, IBS, IW, IGCC, IGCA, IRC, IGVD, IGEC>::terminate()
+dbuct<INH, IC, IF, IGVis, IGVal, ISVis, ISVal, IGD, ISD, IBS, IW, IGCC, IGCA, IRC, IGVD, ISel, IEV, IAcc, MD>::terminate()
 {
     add_visits(1);
-    add_value(value_delta_.get_value_delta(stack_.top().handle));
+    const IF delta = value_delta_.get_value_delta(stack_.top().handle);
+    add_value(delta, delta * delta);
+
+    // An episode that ends in the tree ends at a terminal.  The proof reaches
+    // the parents as the frames are popped.
+    if constexpr (has_proofs)
+        if (!rolled_out_ && set_value_.prove(stack_.top().handle, delta))
+            stack_.top().proved = true;
+    rolled_out_ = false;
+    folding_    = false;
 
     while (stack_.top().visit_lump >= stack_.top().budget)
         backstep();
@@ -202,9 +563,10 @@ dbuct<INH, IC, IF, IGVis, IGVal, ISVis, ISVal, IGD, ISD, IBS, IW, IGCC, IGCA, IR
 template<typename INH, typename IC, typename IF,
          typename IGVis, typename IGVal, typename ISVis, typename ISVal,
          typename IGD, typename ISD, typename IBS,
-         typename IW, typename IGCC, typename IGCA, typename IRC, typename IGVD, typename IGEC>
+         typename IW, typename IGCC, typename IGCA, typename IRC, typename IGVD, typename ISel,
+         typename IEV, typename IAcc, size_t MD>
 void
-dbuct<INH, IC, IF, IGVis, IGVal, ISVis, ISVal, IGD, ISD, IBS, IW, IGCC, IGCA, IRC, IGVD, IGEC>::add_visits(
+dbuct<INH, IC, IF, IGVis, IGVal, ISVis, ISVal, IGD, ISD, IBS, IW, IGCC, IGCA, IRC, IGVD, ISel, IEV, IAcc, MD>::add_visits(
         size_t v)
 {
     frame& f = stack_.top();
@@ -215,29 +577,69 @@ dbuct<INH, IC, IF, IGVis, IGVal, ISVis, ISVal, IGD, ISD, IBS, IW, IGCC, IGCA, IR
 template<typename INH, typename IC, typename IF,
          typename IGVis, typename IGVal, typename ISVis, typename ISVal,
          typename IGD, typename ISD, typename IBS,
-         typename IW, typename IGCC, typename IGCA, typename IRC, typename IGVD, typename IGEC>
+         typename IW, typename IGCC, typename IGCA, typename IRC, typename IGVD, typename ISel,
+         typename IEV, typename IAcc, size_t MD>
 void
-dbuct<INH, IC, IF, IGVis, IGVal, ISVis, ISVal, IGD, ISD, IBS, IW, IGCC, IGCA, IRC, IGVD, IGEC>::add_value(
-        IF l)
+dbuct<INH, IC, IF, IGVis, IGVal, ISVis, ISVal, IGD, ISD, IBS, IW, IGCC, IGCA, IRC, IGVD, ISel, IEV, IAcc, MD>::add_value(
+        IF l, IF l2)
 {
     frame& f = stack_.top();
     set_value_.set_value(f.handle, get_value_.get_value(f.handle) + l);
     f.value_lump += l;
+
+    if constexpr (tracks_squares)
+    {
+        set_value_.set_value_squares(f.handle, get_value_.get_value_squares(f.handle) + l2);
+        f.square_lump += l2;
+    }
 }
 
 template<typename INH, typename IC, typename IF,
          typename IGVis, typename IGVal, typename ISVis, typename ISVal,
          typename IGD, typename ISD, typename IBS,
-         typename IW, typename IGCC, typename IGCA, typename IRC, typename IGVD, typename IGEC>
+         typename IW, typename IGCC, typename IGCA, typename IRC, typename IGVD, typename ISel,
+         typename IEV, typename IAcc, size_t MD>
 void
-dbuct<INH, IC, IF, IGVis, IGVal, ISVis, ISVal, IGD, ISD, IBS, IW, IGCC, IGCA, IRC, IGVD, IGEC>::backstep()
+dbuct<INH, IC, IF, IGVis, IGVal, ISVis, ISVal, IGD, ISD, IBS, IW, IGCC, IGCA, IRC, IGVD, ISel, IEV, IAcc, MD>::backstep()
 {
     const frame& current = stack_.top();
-    size_t v = current.visit_lump;
-    IF     l = current.value_lump;
-    stack_.pop();
+    size_t v  = current.visit_lump;
+    IF     l  = current.value_lump;
+    IF     l2 = current.square_lump;
+    bool   p  = current.proved;
+    INH    h  = current.handle;
+
+    if constexpr (tracks_edges)
+    {
+        const INH child = current.handle;
+        stack_.pop();
+        const INH& parent = stack_.top().handle;
+        edge_visits_->set_edge_visits(parent, child,
+                                      edge_visits_->get_edge_visits(parent, child) + v);
+    }
+    else
+        stack_.pop();
+
     add_visits(v);
-    add_value(l);
+    add_value(l, l2);
+
+    if constexpr (has_proofs)
+        if (p && set_value_.add_proven_child(stack_.top().handle, get_value_.get_proven_value(h)))
+            stack_.top().proved = true;
+}
+
+template<typename INH, typename IC, typename IF,
+         typename IGVis, typename IGVal, typename ISVis, typename ISVal,
+         typename IGD, typename ISD, typename IBS,
+         typename IW, typename IGCC, typename IGCA, typename IRC, typename IGVD, typename ISel,
+         typename IEV, typename IAcc, size_t MD>
+bool
+dbuct<INH, IC, IF, IGVis, IGVal, ISVis, ISVal, IGD, ISD, IBS, IW, IGCC, IGCA, IRC, IGVD, ISel, IEV, IAcc, MD>::solved() const
+{
+    if constexpr (has_proofs)
+        return get_value_.is_proven(root_);
+    else
+        return false;
 }
 
 }
@@ -2,13 +2,16 @@
 #define DISPATCHES_TABLE_HPP
 
 #include <cstddef>
+#include <concepts>
+#include <limits>
 #include <map>
 #include <unordered_map>
+#include <utility>
 
 namespace monte_carlo
 {
 
-// dispatches_table<NodeHandle, Map>
+// dispatches_table<NodeHandle, Map, Counter>
 //
 // Per-node dispatch counter, keyed by NodeHandle.
 //
@@ -21,36 +24,93 @@ namespace monte_carlo
 // Map parameter:
 //   dispatches_table<int, std::map>           — ordered, no hash required
 //   dispatches_table<int, std::unordered_map> — hash map, requires std::hash<NodeHandle>
+//   dispatches_table<int, spill_map>          — out-of-core, see spill_map.hpp
+//   dispatches_table<int, incremental_hash_map> — no rehash stalls, see incremental_hash_map.hpp
+//   dispatches_table<int, std::pmr::unordered_map>
+//                                             — allocator-aware; construct with a
+//                                               std::pmr::memory_resource*, see search_arena.hpp
+//
+// Counter parameter (default size_t): stored counter width, e.g.
+//   dispatches_table<int, std::unordered_map, uint32_t>
+// halves the per-entry payload.  Writes above the Counter range saturate at
+// its maximum instead of wrapping, and saturated() reports that it happened;
+// a saturated node keeps its largest batch size instead of dropping back to
+// the first one.
 
 template<
     typename NodeHandle,
-    template<typename...> typename Map
+    template<typename...> typename Map,
+    typename Counter = size_t
 >
 struct dispatches_table
 {
+    dispatches_table() = default;
+
+    // Forwards to the Map constructor, e.g. a spill_config for spill_map.
+    template<typename... MapArgs>
+        requires std::constructible_from<Map<NodeHandle, Counter>, MapArgs...>
+    explicit dispatches_table(MapArgs&&... args);
+
     size_t get_dispatches(const NodeHandle& h) const;
     void   set_dispatches(const NodeHandle& h, size_t v);
 
+    // Pre-sizes the Map for n entries when it has reserve(); no-op otherwise.
+    void reserve(size_t n);
+
+    // Calls f(handle, size_t) for every entry written so far (Map iteration order).
+    template<typename F>
+    void for_each(F&& f) const;
+
+    bool saturated() const { return saturated_; }
+
 private:
-    Map<NodeHandle, size_t> counts_;
+    Map<NodeHandle, Counter> counts_;
+    bool                     saturated_ = false;
 };
 
 // ---------------------------------------------------------------------------
 // member function definitions
 // ---------------------------------------------------------------------------
 
-template<typename NodeHandle, template<typename...> typename Map>
-size_t dispatches_table<NodeHandle, Map>::get_dispatches(const NodeHandle& h) const
+template<typename NodeHandle, template<typename...> typename Map, typename Counter>
+template<typename... MapArgs>
+    requires std::constructible_from<Map<NodeHandle, Counter>, MapArgs...>
+dispatches_table<NodeHandle, Map, Counter>::dispatches_table(MapArgs&&... args)
+    : counts_(std::forward<MapArgs>(args)...)
+{}
+
+template<typename NodeHandle, template<typename...> typename Map, typename Counter>
+size_t dispatches_table<NodeHandle, Map, Counter>::get_dispatches(const NodeHandle& h) const
 {
     auto it = counts_.find(h);
     if (it == counts_.end()) return 0;
     return it->second;
 }
 
-template<typename NodeHandle, template<typename...> typename Map>
-void dispatches_table<NodeHandle, Map>::set_dispatches(const NodeHandle& h, size_t v)
+template<typename NodeHandle, template<typename...> typename Map, typename Counter>
+void dispatches_table<NodeHandle, Map, Counter>::set_dispatches(const NodeHandle& h, size_t v)
+{
+    if (v > std::numeric_limits<Counter>::max())
+    {
+        v          = std::numeric_limits<Counter>::max();
+        saturated_ = true;
+    }
+    counts_[h] = static_cast<Counter>(v);
+}
+
+template<typename NodeHandle, template<typename...> typename Map, typename Counter>
+void dispatches_table<NodeHandle, Map, Counter>::reserve(size_t n)
+{
+    if constexpr (requires { counts_.reserve(n); })
+        counts_.reserve(n);
+}
+
+template<typename NodeHandle, template<typename...> typename Map, typename Counter>
+template<typename F>
+void dispatches_table<NodeHandle, Map, Counter>::for_each(F&& f) const
 {
-    counts_[h] = v;
+    for (const auto& [h, v] : counts_)
+        f(h, v);
 }
 
 } // namespace monte_carlo
@@ -0,0 +1,193 @@
+#ifndef EARLY_STOP_HPP
+#define EARLY_STOP_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+namespace monte_carlo
+{
+
+// early_stop<INodeHandle, IFloat, IGetVisits, IGetValue, IWalker>
+//
+// Anytime stopping rule for a search loop with a fixed simulation budget.
+// Call should_stop() after every simulation; it reads the root's children
+// only every check_every simulations and otherwise returns false:
+//
+//   monte_carlo::early_stop<int, double, visits_t, value_t, walker_t>
+//       stop(visits, value, walker, monte_carlo::stop_rule::visit_gap, 100);
+//
+//   for (size_t i = 1; i <= budget; ++i)
+//   {
+//       simulate_once(...);
+//       if (stop.should_stop(root, choices, choices, i, budget))
+//           break;
+//   }
+//
+// Rules:
+//   stop_rule::visit_gap   -- for a most-visited root decision.  Stops once
+//                             the leader's visits exceed the runner-up's by
+//                             more than the simulations left, so no use of
+//                             the remaining budget could change the decision.
+//                             Exact, and never stops early on a close call.
+//   stop_rule::confidence  -- for a highest-mean root decision.  Stops once
+//                             the leader's mean, less its Hoeffding radius
+//                                 range * sqrt( ln(2k / delta) / (2n) )
+//                             (k children, n visits), is above every other
+//                             child's mean plus its radius.  range is the
+//                             reward span and delta the failure probability;
+//                             selection does not sample children i.i.d., so
+//                             the bound is a heuristic separation test.  Any
+//                             unvisited child blocks the stop.
+//
+// Children are read with node visits and values, as the tree is built; with
+// transpositions a root child's node counts include arrivals from other
+// parents, which inflates both rules' confidence.
+
+enum class stop_rule
+{
+    visit_gap,
+    confidence
+};
+
+template<
+    typename INodeHandle,
+    typename IFloat,
+    typename IGetVisits,
+    typename IGetValue,
+    typename IWalker
+>
+struct early_stop
+{
+    early_stop(IGetVisits& get_visits,
+               IGetValue&  get_value,
+               IWalker&    walker,
+               stop_rule   rule,
+               size_t      check_every,
+               IFloat      range = IFloat{1},
+               IFloat      delta = IFloat{0.05});
+
+    // done: simulations run so far (>= 1); budget: the total allowed.
+    template<typename IGetChoiceCount, typename IGetChoiceAt>
+    bool should_stop(const INodeHandle&     root,
+                     const IGetChoiceCount& get_choice_count,
+                     const IGetChoiceAt&    get_choice_at,
+                     size_t                 done,
+                     size_t                 budget);
+
+    // Times the root's children were actually read.
+    size_t checks() const { return checks_; }
+
+private:
+    IGetVisits& get_visits_;
+    IGetValue&  get_value_;
+    IWalker&    walker_;
+    stop_rule   rule_;
+    size_t      check_every_;
+    IFloat      range_;
+    IFloat      delta_;
+    size_t      checks_;
+};
+
+// ---------------------------------------------------------------------------
+// member function definitions
+// ---------------------------------------------------------------------------
+
+template<typename INodeHandle, typename IFloat, typename IGetVisits, typename IGetValue, typename IWalker>
+early_stop<INodeHandle, IFloat, IGetVisits, IGetValue, IWalker>::early_stop(
+        IGetVisits& get_visits,
+        IGetValue&  get_value,
+        IWalker&    walker,
+        stop_rule   rule,
+        size_t      check_every,
+        IFloat      range,
+        IFloat      delta)
+    : get_visits_(get_visits)
+    , get_value_(get_value)
+    , walker_(walker)
+    , rule_(rule)
+    , check_every_(check_every == 0 ? 1 : check_every)
+    , range_(range)
+    , delta_(delta)
+    , checks_(0)
+{}
+
+template<typename INodeHandle, typename IFloat, typename IGetVisits, typename IGetValue, typename IWalker>
+template<typename IGetChoiceCount, typename IGetChoiceAt>
+bool early_stop<INodeHandle, IFloat, IGetVisits, IGetValue, IWalker>::should_stop(
+        const INodeHandle&     root,
+        const IGetChoiceCount& get_choice_count,
+        const IGetChoiceAt&    get_choice_at,
+        size_t                 done,
+        size_t                 budget)
+{
+    if (done % check_every_ != 0 || done >= budget)
+        return false;
+    ++checks_;
+
+    const size_t k = get_choice_count.size();
+    if (k < 2)
+        return true;
+
+    if (rule_ == stop_rule::visit_gap)
+    {
+        size_t first  = 0;
+        size_t second = 0;
+        for (size_t i = 0; i < k; ++i)
+        {
+            const size_t v = get_visits_.get_visits(walker_.walk(root, get_choice_at.at(i)));
+            if (v > first)
+            {
+                second = first;
+                first  = v;
+            }
+            else if (v > second)
+                second = v;
+        }
+        return first - second > budget - done;
+    }
+
+    // Leader by mean; the others' best upper bound is the highest upper bound
+    // not belonging to the leader, so keep the top two.
+    constexpr IFloat inf      = std::numeric_limits<IFloat>::infinity();
+    const IFloat     log_term = std::log(2 * static_cast<IFloat>(k) / delta_);
+
+    IFloat leader_mean  = -inf;
+    IFloat leader_lower = -inf;
+    size_t leader       = 0;
+    IFloat upper_1      = -inf;
+    IFloat upper_2      = -inf;
+    size_t upper_1_i    = 0;
+
+    for (size_t i = 0; i < k; ++i)
+    {
+        const INodeHandle child = walker_.walk(root, get_choice_at.at(i));
+        const size_t      n     = get_visits_.get_visits(child);
+        if (n == 0)
+            return false;
+
+        const IFloat mean   = get_value_.get_value(child) / static_cast<IFloat>(n);
+        const IFloat radius = range_ * std::sqrt(log_term / (2 * static_cast<IFloat>(n)));
+
+        if (mean > leader_mean)
+        {
+            leader_mean  = mean;
+            leader_lower = mean - radius;
+            leader       = i;
+        }
+        if (mean + radius > upper_1)
+        {
+            upper_2   = upper_1;
+            upper_1   = mean + radius;
+            upper_1_i = i;
+        }
+        else if (mean + radius > upper_2)
+            upper_2 = mean + radius;
+    }
+
+    return leader_lower > (upper_1_i == leader ? upper_2 : upper_1);
+}
+
+} // namespace monte_carlo
+
+#endif // EARLY_STOP_HPP
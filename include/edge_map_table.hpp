@@ -54,12 +54,16 @@ void edge_map_table<NodeHandle, Map>::set_edge_visits(
 // ---------------------------------------------------------------------------
 // Fast variant for integer NodeHandles.
 // Packs (parent, child) into a single uint64 key, allowing std::unordered_map
-// without any custom hash specialisation.
+// without any custom hash specialisation.  Handles must fit in 32 bits;
+// use wide_edge_table (wide_edge_table.hpp) for 64-bit or hashed handles.
 // ---------------------------------------------------------------------------
 
 template<typename IntNodeHandle = int>
 struct int_edge_unordered_table
 {
+    static_assert(sizeof(IntNodeHandle) <= sizeof(uint32_t),
+                  "int_edge_unordered_table packs handles into 32 bits; use wide_edge_table");
+
     size_t get_edge_visits(const IntNodeHandle& parent, const IntNodeHandle& child) const;
     void   set_edge_visits(const IntNodeHandle& parent, const IntNodeHandle& child, size_t v);
 
@@ -0,0 +1,69 @@
+#ifndef FIRST_PLAY_URGENCY_HPP
+#define FIRST_PLAY_URGENCY_HPP
+
+namespace monte_carlo
+{
+
+// first_play_urgency<IFloat, IGetExplorationConstant>
+//
+// IGetExplorationConstant policy that also gives unvisited children a finite
+// score (first-play urgency, FPU) instead of +infinity.  Pass it where sim /
+// dbuct take their exploration-constant policy:
+//
+//   monte_carlo::uniform_exploration_constant<double> ec(1.4);
+//   monte_carlo::first_play_urgency<double, decltype(ec)> fpu(ec, fpu_mode::parent_mean, 0.2);
+//
+// Both engines look for get_first_play_urgency() on that policy.  Without it
+// an unvisited child scores +infinity and selection stops at the first one,
+// so every child of a reached node is tried before any is revisited.  With
+// it, an unvisited child scores
+//   fpu_mode::constant:     value
+//   fpu_mode::parent_mean:  mean(parent) - value    (0 - value if unvisited)
+// and competes with the UCB scores of its visited siblings.  Selection
+// expands children in choice order, so the visited ones form a prefix and
+// the scan stops at the first unvisited child: the rest would score the same
+// and ties keep the earlier choice.  (A child beyond it that was visited
+// through a transposition is not scored until the prefix reaches it.)
+//
+// A high FPU (above any reachable UCB score) behaves like the default; a low
+// one lets a good visited child be revisited before its siblings are tried.
+// Without a prior ordering the choices, a pessimistic FPU can starve the
+// unexplored tail for good: parent_mean with value 0 or more never tries a
+// new child while the best visited one stays at or above the parent mean.
+
+enum class fpu_mode
+{
+    constant,
+    parent_mean
+};
+
+template<typename IFloat, typename IGetExplorationConstant>
+struct first_play_urgency
+{
+    first_play_urgency(IGetExplorationConstant& get_exploration_constant, fpu_mode mode, IFloat value)
+        : get_exploration_constant_(get_exploration_constant)
+        , mode_(mode)
+        , value_(value)
+    {}
+
+    template<typename INodeHandle>
+    IFloat get_exploration_constant(const INodeHandle& parent) const
+    {
+        return get_exploration_constant_.get_exploration_constant(parent);
+    }
+
+    template<typename INodeHandle>
+    IFloat get_first_play_urgency(const INodeHandle&, IFloat parent_mean) const
+    {
+        return mode_ == fpu_mode::constant ? value_ : parent_mean - value_;
+    }
+
+private:
+    IGetExplorationConstant& get_exploration_constant_;
+    fpu_mode                 mode_;
+    IFloat                   value_;
+};
+
+} // namespace monte_carlo
+
+#endif // FIRST_PLAY_URGENCY_HPP
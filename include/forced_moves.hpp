@@ -0,0 +1,52 @@
+#ifndef FORCED_MOVES_HPP
+#define FORCED_MOVES_HPP
+
+#include <cstddef>
+
+namespace monte_carlo
+{
+
+// forced_moves<IChoices>
+//
+// Choice-access adapter that turns on forced-move folding.  Pass it to sim /
+// dbuct choose() as both the IGetChoiceCount and IGetChoiceAt argument:
+//
+//   monte_carlo::forced_moves<std::vector<move>> fm(moves);
+//   s.choose(fm, fm);
+//
+// Both engines look for a static folds_forced_moves on the IGetChoiceCount
+// type.  With it, an in-tree step with a single choice is not a node: the
+// engine returns the choice without scoring it and walks its handle once,
+// pushes no path entry (sim) or frame (dbuct), and terminate() keeps no
+// statistics for it.  A chain of forced moves is folded into the edge that
+// led into it, and the next real decision point is scored as a child of the
+// last node kept (its visits, value, edge and proof entries), since every
+// visit to that node runs down the same chain.  Handles are still walked
+// through the chain, so the next decision's children are keyed as before.
+//
+// An episode ending in the tree after a forced chain proves the last node
+// kept, with the terminal's value.  Rollout steps are unaffected.  With
+// RAVE (sim), folded forced steps are left out of the episode's recorded
+// choices and rollout steps are recorded, so AMAF credit goes to the
+// decisions and the rollout moves.  A choice type of your own can opt in
+// with the same static member instead of this adapter.
+//
+// The adapter holds a reference; the choices must outlive it.
+
+template<typename IChoices>
+struct forced_moves
+{
+    static constexpr bool folds_forced_moves = true;
+
+    explicit forced_moves(const IChoices& choices) : choices_(choices) {}
+
+    size_t size()       const { return choices_.size(); }
+    auto   at(size_t i) const { return choices_.at(i); }
+
+private:
+    const IChoices& choices_;
+};
+
+} // namespace monte_carlo
+
+#endif // FORCED_MOVES_HPP
@@ -0,0 +1,298 @@
+#ifndef FROZEN_STATS_TABLE_HPP
+#define FROZEN_STATS_TABLE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "hash_mix.hpp"
+#include "prefetch.hpp"
+
+namespace monte_carlo
+{
+
+// frozen_stats_table<NodeHandle, IFloat, Hash, Visits, Value>
+//
+// Immutable, compact visits + value table for inference-only serving, built
+// once from trained tables by freeze():
+//
+//   auto frozen = monte_carlo::freeze<int, double>(visits, value);
+//
+// Satisfies:
+//   IGetVisits: get_visits(const NodeHandle&) -> size_t  (0 if unseen)
+//   IGetValue:  get_value(const NodeHandle&)  -> IFloat  (IFloat{} if unseen)
+//
+// Layout: a minimal perfect hash (hash-and-displace: keys are split into
+// buckets of about four, and each bucket stores the pilot that sends all of
+// its keys to distinct free slots) maps every handle to a slot in [0, n).
+// Handles, visits and values live in three parallel arrays indexed by that
+// slot; the stored handle turns a lookup of an unseen handle into a miss.
+// Handles whose Hash collides with an earlier handle cannot be separated by
+// any pilot; they go to a small overflow array that is only scanned when the
+// slot lookup misses.  Visits and values are narrowed to Visits / Value
+// (uint32_t / float by default); freeze() throws std::overflow_error if a
+// visit count does not fit.
+//
+// There is no mutation after construction, so one instance can be shared by
+// any number of threads without locks.
+
+template<
+    typename NodeHandle,
+    typename IFloat,
+    typename Hash   = std::hash<NodeHandle>,
+    typename Visits = uint32_t,
+    typename Value  = float
+>
+struct frozen_stats_table
+{
+    struct entry
+    {
+        NodeHandle handle;
+        size_t     visits;
+        IFloat     value;
+    };
+
+    frozen_stats_table() = default;
+    explicit frozen_stats_table(std::vector<entry> entries);
+
+    size_t get_visits(const NodeHandle& h) const;
+    IFloat get_value(const NodeHandle& h)  const;
+
+    // Cache hint for a lookup of h soon after: reads h's pilot (the pilot
+    // array is about a byte per entry, so it stays cached) and starts
+    // loading the slot's handle, visits and value.
+    void prefetch(const NodeHandle& h) const;
+
+    size_t size() const { return handles_.size() + overflow_.size(); }
+
+    // Bytes owned by the table's arrays (excluding sizeof(*this)).
+    size_t memory_bytes() const;
+
+private:
+    static constexpr size_t keys_per_bucket = 4;
+
+    struct overflow_entry
+    {
+        NodeHandle handle;
+        Visits     visits;
+        Value      value;
+    };
+
+    Hash                        hash_;
+    std::vector<uint32_t>       pilots_;
+    std::vector<NodeHandle>     handles_;
+    std::vector<Visits>         visits_;
+    std::vector<Value>          values_;
+    std::vector<overflow_entry> overflow_;
+
+    size_t bucket_of(uint64_t hk) const { return hk % pilots_.size(); }
+
+    size_t slot_of(uint64_t hk, uint32_t pilot) const
+    {
+        return hash_mix(hk ^ hash_mix(pilot)) % handles_.size();
+    }
+
+    size_t lookup(const NodeHandle& h) const;
+};
+
+// freeze<NodeHandle, IFloat>(visits, value)
+//
+// Snapshots every handle present in `visits` (any table exposing for_each,
+// e.g. visits_table) together with its value from `value`.
+
+template<
+    typename NodeHandle,
+    typename IFloat,
+    typename Hash   = std::hash<NodeHandle>,
+    typename Visits = uint32_t,
+    typename Value  = float,
+    typename IVisitsTable,
+    typename IValueTable
+>
+frozen_stats_table<NodeHandle, IFloat, Hash, Visits, Value>
+freeze(const IVisitsTable& visits, const IValueTable& value)
+{
+    using table_t = frozen_stats_table<NodeHandle, IFloat, Hash, Visits, Value>;
+
+    std::vector<typename table_t::entry> entries;
+    visits.for_each([&](const NodeHandle& h, size_t v)
+    {
+        entries.push_back({h, v, value.get_value(h)});
+    });
+    return table_t(std::move(entries));
+}
+
+// ---------------------------------------------------------------------------
+// member function definitions
+// ---------------------------------------------------------------------------
+
+template<typename NodeHandle, typename IFloat, typename Hash, typename Visits, typename Value>
+frozen_stats_table<NodeHandle, IFloat, Hash, Visits, Value>::frozen_stats_table(
+    std::vector<entry> entries)
+{
+    for (const entry& e : entries)
+        if (e.visits > std::numeric_limits<Visits>::max())
+            throw std::overflow_error("frozen_stats_table: visit count exceeds Visits");
+
+    // Sort by hash; every handle after the first with a given hash overflows.
+    std::vector<std::pair<uint64_t, size_t>> by_hash(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i)
+        by_hash[i] = {hash_mix(hash_(entries[i].handle)), i};
+    std::sort(by_hash.begin(), by_hash.end());
+
+    std::vector<uint64_t> hashes;
+    std::vector<size_t>   source;
+    for (size_t i = 0; i < by_hash.size(); ++i)
+    {
+        const entry& e = entries[by_hash[i].second];
+        if (i > 0 && by_hash[i].first == by_hash[i - 1].first)
+        {
+            overflow_.push_back({e.handle, static_cast<Visits>(e.visits), static_cast<Value>(e.value)});
+            continue;
+        }
+        hashes.push_back(by_hash[i].first);
+        source.push_back(by_hash[i].second);
+    }
+
+    const size_t n = hashes.size();
+    if (n == 0)
+        return;
+
+    pilots_.assign((n + keys_per_bucket - 1) / keys_per_bucket, 0);
+    handles_.resize(n);
+
+    // Group keys by bucket; place the largest buckets first while the table
+    // is still mostly empty.
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b)
+    {
+        return bucket_of(hashes[a]) < bucket_of(hashes[b]);
+    });
+
+    std::vector<std::pair<size_t, size_t>> buckets;   // [begin, end) into order
+    for (size_t i = 0; i < n;)
+    {
+        size_t j = i;
+        while (j < n && bucket_of(hashes[order[j]]) == bucket_of(hashes[order[i]]))
+            ++j;
+        buckets.push_back({i, j});
+        i = j;
+    }
+    std::stable_sort(buckets.begin(), buckets.end(), [](const auto& a, const auto& b)
+    {
+        return a.second - a.first > b.second - b.first;
+    });
+
+    std::vector<bool>   taken(n, false);
+    std::vector<size_t> slot_of_key(n);
+    std::vector<size_t> trial;
+
+    for (const auto& [first, last] : buckets)
+    {
+        for (uint32_t pilot = 0;; ++pilot)
+        {
+            trial.clear();
+            bool ok = true;
+            for (size_t k = first; k < last && ok; ++k)
+            {
+                const size_t s = slot_of(hashes[order[k]], pilot);
+                ok = !taken[s] && std::find(trial.begin(), trial.end(), s) == trial.end();
+                trial.push_back(s);
+            }
+            if (!ok)
+                continue;
+
+            pilots_[bucket_of(hashes[order[first]])] = pilot;
+            for (size_t k = first; k < last; ++k)
+            {
+                taken[trial[k - first]] = true;
+                slot_of_key[order[k]]   = trial[k - first];
+            }
+            break;
+        }
+    }
+
+    visits_.resize(n);
+    values_.resize(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        const size_t s = slot_of_key[i];
+        entry&       e = entries[source[i]];
+        handles_[s] = std::move(e.handle);
+        visits_[s]  = static_cast<Visits>(e.visits);
+        values_[s]  = static_cast<Value>(e.value);
+    }
+}
+
+template<typename NodeHandle, typename IFloat, typename Hash, typename Visits, typename Value>
+size_t frozen_stats_table<NodeHandle, IFloat, Hash, Visits, Value>::lookup(
+    const NodeHandle& h) const
+{
+    const size_t n = handles_.size();
+    if (n > 0)
+    {
+        const uint64_t hk = hash_mix(hash_(h));
+        const size_t   s  = slot_of(hk, pilots_[bucket_of(hk)]);
+        if (handles_[s] == h)
+            return s;
+    }
+
+    for (size_t i = 0; i < overflow_.size(); ++i)
+        if (overflow_[i].handle == h)
+            return n + i;
+    return SIZE_MAX;
+}
+
+template<typename NodeHandle, typename IFloat, typename Hash, typename Visits, typename Value>
+void frozen_stats_table<NodeHandle, IFloat, Hash, Visits, Value>::prefetch(const NodeHandle& h) const
+{
+    if (handles_.empty())
+        return;
+
+    const uint64_t hk = hash_mix(hash_(h));
+    const size_t   s  = slot_of(hk, pilots_[bucket_of(hk)]);
+    prefetch_address(&handles_[s]);
+    prefetch_address(&visits_[s]);
+    prefetch_address(&values_[s]);
+}
+
+template<typename NodeHandle, typename IFloat, typename Hash, typename Visits, typename Value>
+size_t frozen_stats_table<NodeHandle, IFloat, Hash, Visits, Value>::get_visits(
+    const NodeHandle& h) const
+{
+    const size_t s = lookup(h);
+    if (s == SIZE_MAX)        return 0;
+    if (s < handles_.size())  return visits_[s];
+    return overflow_[s - handles_.size()].visits;
+}
+
+template<typename NodeHandle, typename IFloat, typename Hash, typename Visits, typename Value>
+IFloat frozen_stats_table<NodeHandle, IFloat, Hash, Visits, Value>::get_value(
+    const NodeHandle& h) const
+{
+    const size_t s = lookup(h);
+    if (s == SIZE_MAX)        return IFloat{};
+    if (s < handles_.size())  return static_cast<IFloat>(values_[s]);
+    return static_cast<IFloat>(overflow_[s - handles_.size()].value);
+}
+
+template<typename NodeHandle, typename IFloat, typename Hash, typename Visits, typename Value>
+size_t frozen_stats_table<NodeHandle, IFloat, Hash, Visits, Value>::memory_bytes() const
+{
+    return pilots_.capacity()  * sizeof(uint32_t)
+         + handles_.capacity() * sizeof(NodeHandle)
+         + visits_.capacity()  * sizeof(Visits)
+         + values_.capacity()  * sizeof(Value)
+         + overflow_.capacity() * sizeof(overflow_entry);
+}
+
+} // namespace monte_carlo
+
+#endif // FROZEN_STATS_TABLE_HPP
@@ -0,0 +1,56 @@
+#ifndef GEOMETRIC_BATCH_INCREMENT_HPP
+#define GEOMETRIC_BATCH_INCREMENT_HPP
+
+#include <cstddef>
+#include <limits>
+
+namespace monte_carlo
+{
+
+// geometric_batch_increment
+//
+// Concrete IComputeBatchSize policy.  Implements the formula:
+//   compute_batch_size(D) = min( cap, 2^(D / B) )
+//
+// where D is the pre-increment dispatch count supplied by dbuct and B the
+// doubling interval: the grant doubles every B dispatches instead of growing
+// by one as with linear_batch_increment.  A node's first grants stay at 1,
+// so a young node is still sampled one simulation at a time, and a node
+// dispatched thousands of times hands its child a grant of many simulations
+// (bounded by cap) instead of camping one frame at a time.
+//
+// B = SIZE_MAX gives compute_batch_size(D) = 1 for all D, like
+// linear_batch_increment(SIZE_MAX).
+
+struct geometric_batch_increment
+{
+    explicit geometric_batch_increment(size_t B, size_t cap = std::numeric_limits<size_t>::max());
+    size_t compute_batch_size(size_t dispatch_count) const;
+
+private:
+    size_t B_;
+    size_t cap_;
+};
+
+// ---------------------------------------------------------------------------
+// member function definitions
+// ---------------------------------------------------------------------------
+
+inline geometric_batch_increment::geometric_batch_increment(size_t B, size_t cap)
+    : B_(B)
+    , cap_(cap == 0 ? 1 : cap)
+{}
+
+inline size_t geometric_batch_increment::compute_batch_size(size_t dispatch_count) const
+{
+    const size_t doublings = dispatch_count / B_;
+    if (doublings >= std::numeric_limits<size_t>::digits - 1)
+        return cap_;
+
+    const size_t grant = size_t{1} << doublings;
+    return grant < cap_ ? grant : cap_;
+}
+
+} // namespace monte_carlo
+
+#endif // GEOMETRIC_BATCH_INCREMENT_HPP
@@ -0,0 +1,25 @@
+#ifndef HASH_MIX_HPP
+#define HASH_MIX_HPP
+
+#include <cstdint>
+
+namespace monte_carlo
+{
+
+// hash_mix(x)
+//
+// splitmix64 finaliser.  std::hash<int> is the identity on common standard
+// libraries, so any table that derives a bucket, page or slot from the low
+// bits of a user hash runs it through hash_mix first.
+
+inline uint64_t hash_mix(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ull;
+    x  = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x  = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+} // namespace monte_carlo
+
+#endif // HASH_MIX_HPP
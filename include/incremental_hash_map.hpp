@@ -0,0 +1,327 @@
+#ifndef INCREMENTAL_HASH_MAP_HPP
+#define INCREMENTAL_HASH_MAP_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "hash_mix.hpp"
+#include "prefetch.hpp"
+
+namespace monte_carlo
+{
+
+// incremental_hash_map<Key, T, Hash, KeyEqual>
+//
+// Open-addressing Map backend whose growth never rehashes the whole table in
+// one call.  When the active table passes its load limit, a table of twice
+// the capacity becomes active and the previous one is drained a few slots at
+// a time by every subsequent operator[] call, so the cost of a resize is
+// spread over the inserts that caused it instead of stalling one
+// set_visits() inside choose() / terminate().  The drain always finishes
+// before the next growth is due, and a new table is neither constructed nor
+// cleared up front: slots stay raw storage until an insert constructs one,
+// and the used flags come from calloc, which for large tables maps zero pages
+// that the OS supplies as they are first touched.  reserve(n) sizes the
+// table up front (a full rehash, at a time the caller chooses).
+//
+//   visits_table<int, incremental_hash_map> visits;
+//   visits.reserve(1 << 22);
+//
+// Map interface used by the tables:
+//   find(const Key&) -> iterator   (end() if never written)
+//   end(), begin()                 (forward iteration over every entry)
+//   operator[](const Key&) -> T&   (value-initialised on first write)
+//   reserve(size_t)
+//   prefetch(const Key&)           (cache hint for a find() / operator[] soon after)
+//
+// Iterators and references are invalidated by operator[] and reserve().
+// Entries are never erased; T must be default constructible.
+//
+// Drain bookkeeping: slots of the draining table below the drain cursor have
+// already been copied into the active table.  They are left marked used so
+// that linear-probe chains through them stay intact, and lookups ignore
+// matches found there.
+
+template<
+    typename Key,
+    typename T,
+    typename Hash     = std::hash<Key>,
+    typename KeyEqual = std::equal_to<Key>
+>
+struct incremental_hash_map
+{
+    struct value_type
+    {
+        Key first;
+        T   second;
+    };
+
+    struct iterator
+    {
+        const incremental_hash_map* map;
+        int                         part;    // 0 = draining, 1 = active, 2 = end
+        size_t                      slot;
+
+        value_type& operator*()  const { return map->tables_[part].slots[slot]; }
+        value_type* operator->() const { return &**this; }
+        iterator&   operator++();
+        bool        operator==(const iterator& o) const
+        { return part == o.part && slot == o.slot; }
+
+        void settle();   // advance to the first live slot at or after this one
+    };
+
+    using key_type       = Key;
+    using mapped_type    = T;
+    using const_iterator = iterator;
+
+    incremental_hash_map() = default;
+
+    iterator find(const Key& k) const;
+    iterator begin() const;
+    iterator end()   const { return {this, 2, 0}; }
+    T&       operator[](const Key& k);
+    void     reserve(size_t n);
+
+    // Starts loading the first probe slot of k in the active table (slot
+    // and used flag).  At the 1/2 load limit most probes end in that slot.
+    void prefetch(const Key& k) const;
+
+    size_t size()     const { return size_; }
+    bool   draining() const { return tables_[0].capacity != 0; }
+
+private:
+    // Slots migrated per operator[] call while a drain is in progress.  A
+    // growth to 2C leaves C slots to drain and C/2 inserts before the next
+    // growth, so at least 2 slots per insert finish the drain in time.
+    static constexpr size_t drain_step  = 8;
+    static constexpr size_t min_buckets = 16;
+    static_assert(drain_step >= 2, "the drain must finish before the next growth");
+
+    // slots is raw storage: slot i holds a constructed entry only while
+    // used[i] is set (drained entries stay constructed, moved from).
+    struct table
+    {
+        value_type* slots    = nullptr;
+        uint8_t*    used     = nullptr;
+        size_t      capacity = 0;
+
+        table() = default;
+        explicit table(size_t c);
+        table(table&& o) noexcept { swap(o); }
+        table& operator=(table&& o) noexcept { swap(o); return *this; }
+        ~table();
+
+        void swap(table& o) noexcept
+        {
+            std::swap(slots, o.slots);
+            std::swap(used, o.used);
+            std::swap(capacity, o.capacity);
+        }
+    };
+
+    Hash     hash_;
+    KeyEqual eq_;
+    table    tables_[2];        // [0] draining, [1] active
+    size_t   drain_cursor_ = 0;
+    size_t   size_         = 0;
+
+    size_t probe_start(const Key& k, size_t capacity) const
+    { return hash_mix(hash_(k)) & (capacity - 1); }
+
+    size_t find_in(const table& t, const Key& k) const;   // SIZE_MAX if absent
+    size_t insert_new(table& t, const Key& k, T v);
+    void   drain(size_t slots);
+    void   grow_to(size_t capacity);
+};
+
+// ---------------------------------------------------------------------------
+// member function definitions
+// ---------------------------------------------------------------------------
+
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+void incremental_hash_map<Key, T, Hash, KeyEqual>::iterator::settle()
+{
+    for (; part < 2; ++part, slot = 0)
+    {
+        const auto& t = map->tables_[part];
+        if (part == 0)
+            slot = std::max(slot, map->drain_cursor_);
+        for (; slot < t.capacity; ++slot)
+            if (t.used[slot])
+                return;
+    }
+    slot = 0;
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+typename incremental_hash_map<Key, T, Hash, KeyEqual>::iterator&
+incremental_hash_map<Key, T, Hash, KeyEqual>::iterator::operator++()
+{
+    ++slot;
+    settle();
+    return *this;
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+typename incremental_hash_map<Key, T, Hash, KeyEqual>::iterator
+incremental_hash_map<Key, T, Hash, KeyEqual>::begin() const
+{
+    iterator it{this, 0, 0};
+    it.settle();
+    return it;
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+size_t incremental_hash_map<Key, T, Hash, KeyEqual>::find_in(const table& t, const Key& k) const
+{
+    const size_t capacity = t.capacity;
+    if (capacity == 0)
+        return SIZE_MAX;
+
+    for (size_t i = probe_start(k, capacity);; i = (i + 1) & (capacity - 1))
+    {
+        if (!t.used[i])
+            return SIZE_MAX;
+        if (eq_(t.slots[i].first, k))
+            return i;
+    }
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+typename incremental_hash_map<Key, T, Hash, KeyEqual>::iterator
+incremental_hash_map<Key, T, Hash, KeyEqual>::find(const Key& k) const
+{
+    size_t i = find_in(tables_[1], k);
+    if (i != SIZE_MAX)
+        return {this, 1, i};
+
+    i = find_in(tables_[0], k);
+    if (i != SIZE_MAX && i >= drain_cursor_)
+        return {this, 0, i};
+
+    return end();
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+size_t incremental_hash_map<Key, T, Hash, KeyEqual>::insert_new(table& t, const Key& k, T v)
+{
+    const size_t capacity = t.capacity;
+    size_t       i        = probe_start(k, capacity);
+    while (t.used[i])
+        i = (i + 1) & (capacity - 1);
+
+    ::new (static_cast<void*>(&t.slots[i])) value_type{k, std::move(v)};
+    t.used[i] = 1;
+    return i;
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+void incremental_hash_map<Key, T, Hash, KeyEqual>::drain(size_t slots)
+{
+    table& old = tables_[0];
+    if (old.capacity == 0)
+        return;
+
+    const size_t left = old.capacity - drain_cursor_;
+    const size_t stop = drain_cursor_ + std::min(slots, left);
+    for (; drain_cursor_ < stop; ++drain_cursor_)
+        if (old.used[drain_cursor_])
+            insert_new(tables_[1], old.slots[drain_cursor_].first,
+                       std::move(old.slots[drain_cursor_].second));
+
+    if (drain_cursor_ == old.capacity)
+    {
+        old           = table{};
+        drain_cursor_ = 0;
+    }
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+incremental_hash_map<Key, T, Hash, KeyEqual>::table::table(size_t c)
+    : slots(static_cast<value_type*>(::operator new(c * sizeof(value_type),
+                                                    std::align_val_t{alignof(value_type)})))
+    , used(static_cast<uint8_t*>(std::calloc(c, 1)))
+    , capacity(c)
+{
+    if (used == nullptr)
+    {
+        ::operator delete(slots, std::align_val_t{alignof(value_type)});
+        throw std::bad_alloc();
+    }
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+incremental_hash_map<Key, T, Hash, KeyEqual>::table::~table()
+{
+    if constexpr (!std::is_trivially_destructible_v<value_type>)
+        for (size_t i = 0; i < capacity; ++i)
+            if (used[i])
+                slots[i].~value_type();
+    std::free(used);
+    ::operator delete(slots, std::align_val_t{alignof(value_type)});
+}
+
+// Only called with no drain in flight: operator[] paces the drain to finish
+// first (drain_step), and reserve() completes it.
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+void incremental_hash_map<Key, T, Hash, KeyEqual>::grow_to(size_t capacity)
+{
+    tables_[0]    = std::move(tables_[1]);
+    tables_[1]    = table(capacity);
+    drain_cursor_ = 0;
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+T& incremental_hash_map<Key, T, Hash, KeyEqual>::operator[](const Key& k)
+{
+    drain(drain_step);
+
+    iterator it = find(k);
+    if (it != end())
+        return it->second;
+
+    if (2 * (size_ + 1) > tables_[1].capacity)
+        grow_to(std::max(min_buckets, 2 * tables_[1].capacity));
+
+    ++size_;
+    const size_t i = insert_new(tables_[1], k, T{});
+    return tables_[1].slots[i].second;
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+void incremental_hash_map<Key, T, Hash, KeyEqual>::reserve(size_t n)
+{
+    size_t capacity = min_buckets;
+    while (capacity < 2 * n)
+        capacity *= 2;
+
+    drain(SIZE_MAX);
+    if (capacity > tables_[1].capacity)
+    {
+        grow_to(capacity);
+        drain(SIZE_MAX);
+    }
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+void incremental_hash_map<Key, T, Hash, KeyEqual>::prefetch(const Key& k) const
+{
+    const table& t = tables_[1];
+    if (t.capacity == 0)
+        return;
+
+    const size_t i = probe_start(k, t.capacity);
+    prefetch_address(&t.slots[i]);
+    prefetch_address(&t.used[i]);
+}
+
+} // namespace monte_carlo
+
+#endif // INCREMENTAL_HASH_MAP_HPP
@@ -0,0 +1,126 @@
+#ifndef INLINE_STACK_HPP
+#define INLINE_STACK_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace monte_carlo
+{
+
+// inline_stack<T, N>
+//
+// Stack with room for N elements inside the object and a heap vector for
+// any beyond.  dbuct keeps its frames in one, so a search no deeper than N
+// never touches the heap for its stack, and a deeper one allocates only
+// until the spill vector has grown to its deepest point: popping keeps the
+// vector's capacity, so a long training loop settles into zero allocations
+// per simulation either way.
+//
+// Elements need not be default-constructible.  References returned by
+// top() / operator[] stay valid until the element is popped while the stack
+// is within N; past N a push may move the spilled elements.
+//
+// Provides:
+//   push(const T&), push(T&&), emplace(args...) -> T&
+//   pop(), top() -> T&, operator[](size_t) -> T&   (0 is the bottom)
+//   size(), empty(), clear()
+//   static capacity() -> N                          (the inline part)
+
+template<typename T, size_t N>
+struct inline_stack
+{
+    inline_stack() = default;
+    inline_stack(const inline_stack& other);
+    inline_stack& operator=(const inline_stack& other);
+    ~inline_stack() { clear(); }
+
+    void push(const T& v) { emplace(v); }
+    void push(T&& v)      { emplace(std::move(v)); }
+
+    template<typename... Args>
+    T& emplace(Args&&... args);
+
+    void pop();
+
+    T&       top()       { return (*this)[size_ - 1]; }
+    const T& top() const { return (*this)[size_ - 1]; }
+
+    T&       operator[](size_t i)       { return i < N ? *slot(i) : spill_[i - N]; }
+    const T& operator[](size_t i) const { return i < N ? *slot(i) : spill_[i - N]; }
+
+    size_t size() const  { return size_; }
+    bool   empty() const { return size_ == 0; }
+    void   clear();
+
+    static constexpr size_t capacity() { return N; }
+
+private:
+    T*       slot(size_t i)       { return std::launder(reinterpret_cast<T*>(storage_ + i * sizeof(T))); }
+    const T* slot(size_t i) const { return std::launder(reinterpret_cast<const T*>(storage_ + i * sizeof(T))); }
+
+    alignas(T) std::byte storage_[(N == 0 ? 1 : N) * sizeof(T)];
+    std::vector<T>       spill_;
+    size_t               size_ = 0;
+};
+
+// ---------------------------------------------------------------------------
+// member function definitions
+// ---------------------------------------------------------------------------
+
+template<typename T, size_t N>
+inline_stack<T, N>::inline_stack(const inline_stack& other)
+{
+    for (size_t i = 0; i < other.size_; ++i)
+        push(other[i]);
+}
+
+template<typename T, size_t N>
+inline_stack<T, N>& inline_stack<T, N>::operator=(const inline_stack& other)
+{
+    if (this != &other)
+    {
+        clear();
+        for (size_t i = 0; i < other.size_; ++i)
+            push(other[i]);
+    }
+    return *this;
+}
+
+template<typename T, size_t N>
+template<typename... Args>
+T& inline_stack<T, N>::emplace(Args&&... args)
+{
+    if (size_ < N)
+    {
+        T* p = ::new (static_cast<void*>(storage_ + size_ * sizeof(T))) T(std::forward<Args>(args)...);
+        ++size_;
+        return *p;
+    }
+    spill_.emplace_back(std::forward<Args>(args)...);
+    ++size_;
+    return spill_.back();
+}
+
+template<typename T, size_t N>
+void inline_stack<T, N>::pop()
+{
+    --size_;
+    if (size_ >= N)
+        spill_.pop_back();
+    else
+        std::destroy_at(slot(size_));
+}
+
+template<typename T, size_t N>
+void inline_stack<T, N>::clear()
+{
+    while (size_ > 0)
+        pop();
+}
+
+} // namespace monte_carlo
+
+#endif // INLINE_STACK_HPP
@@ -0,0 +1,128 @@
+#ifndef LOCALITY_LAYOUT_HPP
+#define LOCALITY_LAYOUT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace monte_carlo
+{
+
+// relayout_tree(visits, value, into_visits, into_value, walker, choices_of, root)
+//
+// Compaction pass for use between searches.  Copies the tree under root from
+// one pair of tables into another, inserting its nodes in locality order:
+//
+//   root, then all of root's visited children as one group, most visited
+//   first; then, for each child in that order, the same again below it.
+//
+// With node-based destination maps that allocate in insertion order -- a
+// std::pmr map over a fresh search_arena (search_arena.hpp) -- the entries
+// land in memory in that order.  Siblings scored together by one selection
+// share a few consecutive lines, and the most visited line from the root
+// (the path most selections follow) is laid out first, depth by depth.
+// After a long search the source entries are in creation order instead,
+// scattered over the whole allocation.
+//
+//   monte_carlo::search_arena fresh;
+//   auto& v2 = fresh.make<visits_t>(fresh.resource());
+//   auto& q2 = fresh.make<value_t>(fresh.resource());
+//   monte_carlo::relayout_tree(visits, value, v2, q2, walker,
+//                              [&](const handle_t& h) -> const auto& { return game.choices(h); },
+//                              root);
+//   old_arena.release();              // then search on with v2 / q2
+//
+// Only nodes reached from root through visited nodes are copied, so entries
+// left behind by earlier roots (after re-rooting) are dropped.  Visits and
+// values are copied, and value squares when both value tables have them
+// (value_moments_table); proof, edge, AMAF and dispatch tables are not.  A
+// node reached along several paths (transpositions) is placed where it is
+// first reached.  The source is only read; the destination tables should
+// start empty (reserve() them first if the Map has it).  The destination may
+// be one table serving as both (compact_stats_table).  Returns the number of
+// nodes copied.
+//
+// Policy requirements:
+//   IGetVisits, IGetValue:  as for sim (the source tables)
+//   ISetVisits, ISetValue:  as for sim, and get_visits() on the destination,
+//                           used to skip nodes already placed
+//   IWalker:                walk(const INodeHandle&, const IChoice&) -> INodeHandle
+//   IChoicesOf:             choices_of(const INodeHandle&) -> the choice set at
+//                           the node, with size() and at(size_t)
+
+template<
+    typename INodeHandle,
+    typename IGetVisits,
+    typename IGetValue,
+    typename ISetVisits,
+    typename ISetValue,
+    typename IWalker,
+    typename IChoicesOf
+>
+size_t relayout_tree(const IGetVisits& visits,
+                     const IGetValue&  value,
+                     ISetVisits&       into_visits,
+                     ISetValue&        into_value,
+                     IWalker&          walker,
+                     IChoicesOf&&      choices_of,
+                     const INodeHandle& root)
+{
+    constexpr bool has_squares =
+        requires (const IGetValue& q, ISetValue& s, const INodeHandle& h)
+        { s.set_value_squares(h, q.get_value_squares(h)); };
+
+    auto place = [&](const INodeHandle& h, size_t n)
+    {
+        into_visits.set_visits(h, n);
+        into_value.set_value(h, value.get_value(h));
+        if constexpr (has_squares)
+            into_value.set_value_squares(h, value.get_value_squares(h));
+    };
+
+    const size_t root_visits = visits.get_visits(root);
+    if (root_visits == 0)
+        return 0;
+    place(root, root_visits);
+    size_t placed = 1;
+
+    // Depth-first over nodes whose children are still to be placed; the
+    // children of the node on top are placed as one group before any of
+    // their own children.
+    std::vector<INodeHandle>                     pending{root};
+    std::vector<std::pair<size_t, INodeHandle>>  group;
+    while (!pending.empty())
+    {
+        const INodeHandle h = std::move(pending.back());
+        pending.pop_back();
+
+        const auto&  choices = choices_of(h);
+        const size_t n       = choices.size();
+        group.clear();
+        for (size_t i = 0; i < n; ++i)
+        {
+            INodeHandle  child = walker.walk(h, choices.at(i));
+            const size_t cv    = visits.get_visits(child);
+            if (cv != 0)
+                group.emplace_back(cv, std::move(child));
+        }
+        std::stable_sort(group.begin(), group.end(),
+                         [](const auto& a, const auto& b) { return a.first > b.first; });
+
+        const size_t first = pending.size();
+        for (auto& [cv, child] : group)
+            if (into_visits.get_visits(child) == 0)
+            {
+                place(child, cv);
+                ++placed;
+                pending.push_back(std::move(child));
+            }
+        // Most visited child on top, so it is expanded next.
+        std::reverse(pending.begin() + static_cast<std::ptrdiff_t>(first), pending.end());
+    }
+    return placed;
+}
+
+} // namespace monte_carlo
+
+#endif // LOCALITY_LAYOUT_HPP
@@ -3,10 +3,40 @@
 
 #include "sim.hpp"
 #include "dbuct.hpp"
+#include "search_driver.hpp"
+#include "search_pool.hpp"
 #include "visits_table.hpp"
 #include "value_table.hpp"
 #include "dispatches_table.hpp"
+#include "edge_map_table.hpp"
+#include "wide_edge_table.hpp"
+#include "spill_map.hpp"
+#include "incremental_hash_map.hpp"
+#include "frozen_stats_table.hpp"
+#include "compact_stats_table.hpp"
+#include "search_arena.hpp"
+#include "locality_layout.hpp"
+#include "inline_stack.hpp"
 #include "linear_batch_increment.hpp"
+#include "geometric_batch_increment.hpp"
+#include "adaptive_batch_size.hpp"
+#include "progressive_widening.hpp"
+#include "forced_moves.hpp"
+#include "choice_span.hpp"
+#include "first_play_urgency.hpp"
+#include "ucb_argmax_table.hpp"
+#include "select_child.hpp"
+#include "ucb1.hpp"
+#include "ucb1_tuned.hpp"
+#include "puct.hpp"
+#include "prior_table.hpp"
+#include "uniform_prior.hpp"
+#include "value_moments_table.hpp"
+#include "proof_table.hpp"
+#include "early_stop.hpp"
+#include "sequential_halving.hpp"
+#include "amaf_table.hpp"
+#include "rave.hpp"
 #include "random_rollout.hpp"
 #include "uniform_value_delta.hpp"
 #include "uniform_exploration_constant.hpp"
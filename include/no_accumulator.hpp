@@ -0,0 +1,19 @@
+#ifndef NO_ACCUMULATOR_HPP
+#define NO_ACCUMULATOR_HPP
+
+namespace monte_carlo
+{
+
+// no_accumulator
+//
+// Default IAccumulator argument for dbuct: frames carry no caller state.
+// Pass a value type instead (a cumulative reward, a running state digest)
+// to have each frame hold that value for the path from the root to it;
+// see "Accumulators" in dbuct.hpp.
+
+struct no_accumulator
+{};
+
+} // namespace monte_carlo
+
+#endif // NO_ACCUMULATOR_HPP
@@ -0,0 +1,20 @@
+#ifndef NO_EDGE_VISITS_HPP
+#define NO_EDGE_VISITS_HPP
+
+namespace monte_carlo
+{
+
+// no_edge_visits
+//
+// Default IEdgeVisits argument for sim and dbuct: no edge table.  Selection
+// then uses node visits only (plain UCB1 on the child node), which is exact
+// for trees and the original behaviour of both engines.  Pass an
+// edge_map_table or int_edge_unordered_table instead when handles are shared
+// between paths (transpositions).
+
+struct no_edge_visits
+{};
+
+} // namespace monte_carlo
+
+#endif // NO_EDGE_VISITS_HPP
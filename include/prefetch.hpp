@@ -0,0 +1,25 @@
+#ifndef PREFETCH_HPP
+#define PREFETCH_HPP
+
+namespace monte_carlo
+{
+
+// prefetch_address(p)
+//
+// Hints the CPU to start loading the cache line holding p, so a load issued
+// a little later does not stall on memory.  Tables use it to implement
+// prefetch(handle) (see incremental_hash_map.hpp); it never faults, so p
+// may point anywhere.  A no-op on compilers without __builtin_prefetch.
+
+inline void prefetch_address(const void* p)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p, 0, 3);
+#else
+    (void)p;
+#endif
+}
+
+} // namespace monte_carlo
+
+#endif // PREFETCH_HPP
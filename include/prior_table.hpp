@@ -0,0 +1,87 @@
+#ifndef PRIOR_TABLE_HPP
+#define PRIOR_TABLE_HPP
+
+#include <cstddef>
+#include <map>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace monte_carlo
+{
+
+// prior_table<NodeHandle, IFloat, Map>
+//
+// Per-parent prior rows for puct, keyed by the parent's NodeHandle.  Row i
+// is the prior of the parent's i-th choice, in the order the choices are
+// passed to choose().  Fill a row when a node is first evaluated (e.g. from
+// a policy network) and before it is selected from.
+//
+// Satisfies IGetPrior:
+//   get_prior(const NodeHandle& parent, size_t i) -> IFloat
+//     -- fallback (default 1) for an unknown parent or i past the row
+//   priors(const NodeHandle& parent) -> std::span<const IFloat>
+//     -- the row, empty if unknown; valid until the next set_priors()
+//
+// Map parameter: as for value_table, mapping NodeHandle to std::vector<IFloat>.
+
+template<
+    typename NodeHandle,
+    typename IFloat,
+    template<typename...> typename Map
+>
+struct prior_table
+{
+    prior_table() = default;
+    explicit prior_table(IFloat fallback) : fallback_(fallback) {}
+
+    IFloat                  get_prior(const NodeHandle& parent, size_t i) const;
+    std::span<const IFloat> priors(const NodeHandle& parent) const;
+    void                    set_priors(const NodeHandle& parent, std::span<const IFloat> row);
+
+    // Pre-sizes the Map for n parents when it has reserve(); no-op otherwise.
+    void reserve(size_t n);
+
+    size_t size() const { return rows_.size(); }
+
+private:
+    Map<NodeHandle, std::vector<IFloat>> rows_;
+    IFloat                               fallback_ = IFloat{1};
+};
+
+// ---------------------------------------------------------------------------
+// member function definitions
+// ---------------------------------------------------------------------------
+
+template<typename NodeHandle, typename IFloat, template<typename...> typename Map>
+IFloat prior_table<NodeHandle, IFloat, Map>::get_prior(const NodeHandle& parent, size_t i) const
+{
+    const std::span<const IFloat> row = priors(parent);
+    return i < row.size() ? row[i] : fallback_;
+}
+
+template<typename NodeHandle, typename IFloat, template<typename...> typename Map>
+std::span<const IFloat> prior_table<NodeHandle, IFloat, Map>::priors(const NodeHandle& parent) const
+{
+    auto it = rows_.find(parent);
+    if (it == rows_.end()) return {};
+    return it->second;
+}
+
+template<typename NodeHandle, typename IFloat, template<typename...> typename Map>
+void prior_table<NodeHandle, IFloat, Map>::set_priors(const NodeHandle&       parent,
+                                                      std::span<const IFloat> row)
+{
+    rows_[parent].assign(row.begin(), row.end());
+}
+
+template<typename NodeHandle, typename IFloat, template<typename...> typename Map>
+void prior_table<NodeHandle, IFloat, Map>::reserve(size_t n)
+{
+    if constexpr (requires { rows_.reserve(n); })
+        rows_.reserve(n);
+}
+
+} // namespace monte_carlo
+
+#endif // PRIOR_TABLE_HPP
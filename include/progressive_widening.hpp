@@ -0,0 +1,110 @@
+#ifndef PROGRESSIVE_WIDENING_HPP
+#define PROGRESSIVE_WIDENING_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <span>
+#include <vector>
+
+namespace monte_carlo
+{
+
+// progressive_widening<IChoices>
+//
+// Choice-access adapter that limits tree selection to the first
+//   widened_size(N) = min(size(), max(1, ceil(k * N^alpha)))
+// choices at a node with N visits.  Pass it to sim / dbuct choose() as both
+// the IGetChoiceCount and IGetChoiceAt argument:
+//
+//   monte_carlo::progressive_widening<std::vector<move>> pw(moves, 2.0, 0.5);
+//   s.choose(pw, pw);
+//
+// Both engines look for widened_size() on the IGetChoiceCount argument and,
+// when present, scan and expand only that prefix during selection, so a node
+// with thousands of choices costs O(k * N^alpha) per visit and is not forced
+// to try every child before UCB applies.  Rollout still draws from all
+// size() choices.
+//
+// Choices enter the prefix in at() order.  To widen by a prior instead, pass
+// an order (indices into choices, best first, e.g. from prior_order()); at(i)
+// then returns choices.at(order[i]).  Cache the order per node: it is only
+// read here.
+//
+// The adapter holds references; the choices and order must outlive it.
+
+template<typename IChoices>
+struct progressive_widening
+{
+    progressive_widening(const IChoices& choices, double k, double alpha);
+    progressive_widening(const IChoices& choices, double k, double alpha,
+                         std::span<const size_t> order);
+
+    size_t size()                             const { return choices_.size(); }
+    auto   at(size_t i)                       const;
+    size_t widened_size(size_t parent_visits) const;
+
+private:
+    const IChoices&         choices_;
+    double                  k_;
+    double                  alpha_;
+    std::span<const size_t> order_;
+};
+
+// prior_order(n, prior)
+//
+// Indices 0..n-1 sorted by decreasing prior(i), ties kept in index order.
+template<typename IGetPrior>
+std::vector<size_t> prior_order(size_t n, IGetPrior&& prior);
+
+// ---------------------------------------------------------------------------
+// member function definitions
+// ---------------------------------------------------------------------------
+
+template<typename IChoices>
+progressive_widening<IChoices>::progressive_widening(const IChoices& choices, double k, double alpha)
+    : choices_(choices)
+    , k_(k)
+    , alpha_(alpha)
+{}
+
+template<typename IChoices>
+progressive_widening<IChoices>::progressive_widening(const IChoices& choices, double k, double alpha,
+                                                     std::span<const size_t> order)
+    : choices_(choices)
+    , k_(k)
+    , alpha_(alpha)
+    , order_(order)
+{}
+
+template<typename IChoices>
+auto progressive_widening<IChoices>::at(size_t i) const
+{
+    return choices_.at(order_.empty() ? i : order_[i]);
+}
+
+template<typename IChoices>
+size_t progressive_widening<IChoices>::widened_size(size_t parent_visits) const
+{
+    const double w = std::ceil(k_ * std::pow(static_cast<double>(parent_visits), alpha_));
+    if (!(w < static_cast<double>(size())))
+        return size();
+    return std::max<size_t>(1, static_cast<size_t>(w));
+}
+
+template<typename IGetPrior>
+std::vector<size_t> prior_order(size_t n, IGetPrior&& prior)
+{
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+    {
+        return prior(a) > prior(b);
+    });
+    return order;
+}
+
+} // namespace monte_carlo
+
+#endif // PROGRESSIVE_WIDENING_HPP
@@ -0,0 +1,192 @@
+#ifndef PROOF_TABLE_HPP
+#define PROOF_TABLE_HPP
+
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <unordered_map>
+
+namespace monte_carlo
+{
+
+// proof_table<NodeHandle, IFloat, IValue, Map>
+//
+// MCTS-Solver support (Winands et al. 2008).  Wraps a value table and is
+// passed in its place as IGetValue / ISetValue to sim / dbuct:
+//
+//   monte_carlo::value_table<int, double, std::unordered_map> value;
+//   monte_carlo::proof_table<int, double, decltype(value), std::unordered_map> proofs(value);
+//
+// Both engines look for the proof accessors on the value table and, when
+// present:
+//   - treat an episode that ends at an in-tree node (no rollout moves after
+//     the last expansion) as ending at a terminal, and prove that node with
+//     its value delta as exact value;
+//   - record each in-tree node's full choice count, and prove a parent once
+//     all its children are proven, or once one is proven at or above bound
+//     (nothing can beat it), with value backup(best proven child);
+//   - propagate new proofs up the selection path during terminate() (sim) or
+//     as frames are popped by backstep() (dbuct);
+//   - score proven children by their exact value, with no explore term, and
+//     pass over the best of them only while an unproven sibling's score is at
+//     least as high (see select_child.hpp), so a proven best move keeps its
+//     share of visits while its siblings are still being searched;
+//   - report solved() once the root is proven, so the caller can stop.
+//
+// proof_backup::max suits single-agent games (the engines' default, where a
+// node's value is that of its best child); proof_backup::negamax suits
+// alternating zero-sum games whose IGetValueDelta flips sign every ply.
+//
+// Proofs are sound only if a node's value delta is a function of the node:
+// deterministic terminal rewards on a tree (no transpositions, since a
+// child's proof is counted only for the parent it was proven through).
+//
+// Satisfies IGetValue / ISetValue (forwarding get_value / set_value and,
+// when the wrapped table has them, the squares accessors) plus:
+//   is_proven(const NodeHandle&) -> bool
+//   get_proven_value(const NodeHandle&) -> IFloat
+//   set_child_count(const NodeHandle&, size_t)       -- kept once known
+//   prove(const NodeHandle&, IFloat) -> bool         -- true if newly proven
+//   add_proven_child(const NodeHandle& parent, IFloat) -> bool
+//                                                    -- true if parent newly proven
+//
+// Map parameter: as for value_table, mapping NodeHandle to a proof record.
+
+enum class proof_backup
+{
+    max,
+    negamax
+};
+
+template<
+    typename NodeHandle,
+    typename IFloat,
+    typename IValue,
+    template<typename...> typename Map
+>
+struct proof_table
+{
+    explicit proof_table(IValue&      value,
+                         proof_backup backup = proof_backup::max,
+                         IFloat       bound  = std::numeric_limits<IFloat>::infinity());
+
+    IFloat get_value(const NodeHandle& h) const        { return value_.get_value(h); }
+    void   set_value(const NodeHandle& h, IFloat v)    { value_.set_value(h, v); }
+
+    IFloat get_value_squares(const NodeHandle& h) const
+        requires requires (const IValue& t) { t.get_value_squares(h); }
+    {
+        return value_.get_value_squares(h);
+    }
+
+    void set_value_squares(const NodeHandle& h, IFloat v)
+        requires requires (IValue& t) { t.set_value_squares(h, v); }
+    {
+        value_.set_value_squares(h, v);
+    }
+
+    bool   is_proven(const NodeHandle& h) const;
+    IFloat get_proven_value(const NodeHandle& h) const;
+    void   set_child_count(const NodeHandle& h, size_t n);
+    bool   prove(const NodeHandle& h, IFloat v);
+    bool   add_proven_child(const NodeHandle& parent, IFloat v);
+
+    // Pre-sizes the Map for n entries when it has reserve(); no-op otherwise.
+    void reserve(size_t n);
+
+    // Nodes with a proof record (proven, or with a known choice count).
+    size_t size() const { return records_.size(); }
+
+private:
+    struct record
+    {
+        bool   proven   = false;
+        IFloat value    = IFloat{0};
+        size_t children = 0;          // full choice count, 0 until known
+        size_t solved   = 0;          // children proven so far
+        IFloat best     = -std::numeric_limits<IFloat>::infinity();
+    };
+
+    IValue&                 value_;
+    proof_backup            backup_;
+    IFloat                  bound_;
+    Map<NodeHandle, record> records_;
+};
+
+// ---------------------------------------------------------------------------
+// member function definitions
+// ---------------------------------------------------------------------------
+
+template<typename NodeHandle, typename IFloat, typename IValue, template<typename...> typename Map>
+proof_table<NodeHandle, IFloat, IValue, Map>::proof_table(IValue&      value,
+                                                          proof_backup backup,
+                                                          IFloat       bound)
+    : value_(value)
+    , backup_(backup)
+    , bound_(bound)
+{}
+
+template<typename NodeHandle, typename IFloat, typename IValue, template<typename...> typename Map>
+bool proof_table<NodeHandle, IFloat, IValue, Map>::is_proven(const NodeHandle& h) const
+{
+    auto it = records_.find(h);
+    return it != records_.end() && it->second.proven;
+}
+
+template<typename NodeHandle, typename IFloat, typename IValue, template<typename...> typename Map>
+IFloat proof_table<NodeHandle, IFloat, IValue, Map>::get_proven_value(const NodeHandle& h) const
+{
+    auto it = records_.find(h);
+    if (it == records_.end()) return IFloat{};
+    return it->second.value;
+}
+
+template<typename NodeHandle, typename IFloat, typename IValue, template<typename...> typename Map>
+void proof_table<NodeHandle, IFloat, IValue, Map>::set_child_count(const NodeHandle& h, size_t n)
+{
+    record& r = records_[h];
+    if (r.children == 0)
+        r.children = n;
+}
+
+template<typename NodeHandle, typename IFloat, typename IValue, template<typename...> typename Map>
+bool proof_table<NodeHandle, IFloat, IValue, Map>::prove(const NodeHandle& h, IFloat v)
+{
+    record& r = records_[h];
+    if (r.proven)
+        return false;
+
+    r.proven = true;
+    r.value  = v;
+    return true;
+}
+
+template<typename NodeHandle, typename IFloat, typename IValue, template<typename...> typename Map>
+bool proof_table<NodeHandle, IFloat, IValue, Map>::add_proven_child(const NodeHandle& parent, IFloat v)
+{
+    record& r = records_[parent];
+    if (r.proven)
+        return false;
+
+    ++r.solved;
+    if (v > r.best)
+        r.best = v;
+
+    if (r.best < bound_ && (r.children == 0 || r.solved < r.children))
+        return false;
+
+    r.proven = true;
+    r.value  = backup_ == proof_backup::max ? r.best : -r.best;
+    return true;
+}
+
+template<typename NodeHandle, typename IFloat, typename IValue, template<typename...> typename Map>
+void proof_table<NodeHandle, IFloat, IValue, Map>::reserve(size_t n)
+{
+    if constexpr (requires { records_.reserve(n); })
+        records_.reserve(n);
+}
+
+} // namespace monte_carlo
+
+#endif // PROOF_TABLE_HPP
@@ -0,0 +1,86 @@
+#ifndef PUCT_HPP
+#define PUCT_HPP
+
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <span>
+
+#include "ucb_child.hpp"
+
+namespace monte_carlo
+{
+
+// puct<IFloat, IGetExplorationConstant, IGetPrior>
+//
+// ISelect policy scoring children by PUCT (as in AlphaZero):
+//   Q + c * P(i) * sqrt(N) / (1 + n)
+// with Q the child's mean (the first-play value for a child never taken from
+// this parent), P(i) its prior, N the parent's visits and n the child's
+// (edge) visits.  Unvisited children are scored too, ranked by prior, so a
+// good prior lets the search go deep without trying every child first.
+//
+// Policy requirements:
+//   IGetPrior: get_prior(const INodeHandle& parent, size_t i) -> IFloat
+//                -- i indexes the choices as passed to choose()
+//              optional priors(const INodeHandle& parent) -> std::span<const IFloat>
+//                -- the parent's whole row (empty if unknown), read once per
+//                   selection instead of one get_prior() per child;
+//                   see prior_table.hpp
+//
+// The first-play value comes from the wrapped policy's
+// get_first_play_urgency() when it has one (e.g. first_play_urgency), and is
+// the parent's mean otherwise.
+
+template<typename IFloat, typename IGetExplorationConstant, typename IGetPrior>
+struct puct
+{
+    static constexpr bool scores_unvisited = true;
+
+    puct(IGetExplorationConstant& get_exploration_constant, IGetPrior& get_prior)
+        : get_exploration_constant_(get_exploration_constant)
+        , get_prior_(get_prior)
+    {}
+
+    template<typename INodeHandle>
+    IFloat get_exploration_constant(const INodeHandle& parent) const
+    {
+        return get_exploration_constant_.get_exploration_constant(parent);
+    }
+
+    template<typename INodeHandle>
+    IFloat get_first_play_urgency(const INodeHandle& parent, IFloat parent_mean) const
+    {
+        if constexpr (requires { get_exploration_constant_.get_first_play_urgency(parent, parent_mean); })
+            return get_exploration_constant_.get_first_play_urgency(parent, parent_mean);
+        else
+            return parent_mean;
+    }
+
+    template<typename INodeHandle>
+    auto scorer(const INodeHandle& parent, size_t parent_visits, IFloat unvisited) const
+    {
+        const IFloat     c      = get_exploration_constant_.get_exploration_constant(parent);
+        const IFloat     sqrt_n = std::sqrt(static_cast<IFloat>(parent_visits));
+        const IGetPrior& prior  = get_prior_;
+
+        std::span<const IFloat> row;
+        if constexpr (requires { { prior.priors(parent) } -> std::convertible_to<std::span<const IFloat>>; })
+            row = prior.priors(parent);
+
+        return [c, sqrt_n, unvisited, row, &prior, &parent](const ucb_child<IFloat>& child, size_t i)
+        {
+            const IFloat q = child.n == 0 ? unvisited : child.exploit;
+            const IFloat p = i < row.size() ? row[i] : prior.get_prior(parent, i);
+            return q + c * p * sqrt_n / static_cast<IFloat>(1 + child.n);
+        };
+    }
+
+private:
+    IGetExplorationConstant& get_exploration_constant_;
+    IGetPrior&               get_prior_;
+};
+
+} // namespace monte_carlo
+
+#endif // PUCT_HPP
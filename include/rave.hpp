@@ -0,0 +1,129 @@
+#ifndef RAVE_HPP
+#define RAVE_HPP
+
+#include <cmath>
+#include <cstddef>
+
+#include "ucb_child.hpp"
+
+namespace monte_carlo
+{
+
+// rave<IFloat, IGetExplorationConstant, IAmaf>
+//
+// ISelect policy blending each child's UCB1 mean with its all-moves-as-first
+// (AMAF) mean, RAVE as in Gelly & Silver 2007:
+//   (1 - beta) * Q + beta * Q_amaf + c * sqrt( ln N / n )
+// with Q the child's mean, Q_amaf the mean of every episode through the
+// parent that played the child's choice at any later point, N the parent's
+// visits and n the child's (edge) visits.  beta falls from 1 towards 0 as n
+// grows, so AMAF carries the early estimate and the child's own mean takes
+// over once it has enough visits:
+//
+//   monte_carlo::amaf_table<int, int, double, std::map> amaf;
+//   monte_carlo::rave<double, decltype(ec), decltype(amaf)> select(ec, amaf, 300);
+//
+// Schedules (the constant's meaning depends on the schedule):
+//   rave_schedule::hand_selected -- beta = sqrt( k / (3n + k) ); k is the
+//                                   equivalence parameter, the visit count
+//                                   at which both means weigh the same
+//   rave_schedule::minimum_mse   -- beta = m / (n + m + 4 b^2 n m), m the
+//                                   AMAF visits; b is the assumed bias of
+//                                   the AMAF mean (Silver 2009)
+//
+// An unvisited child with AMAF data is scored by its AMAF mean plus the
+// explore term of a single visit, so the first choices tried below a node
+// are the ones that did well elsewhere in the episode; one without AMAF
+// data scores unvisited (+inf, or the first-play urgency).
+//
+// sim fills ucb_child::amaf / amaf_n from amaf() and updates the table in
+// terminate() from the whole episode's choice sequence, rollout included:
+// for each node on the selection path, every choice played from there to
+// the end of the episode is credited once (its first occurrence) with the
+// value delta of the child the path took.  AMAF assumes a choice's value
+// does not depend much on when it is played; it pools the choices of both
+// sides in alternating games, so it suits single-agent games and games with
+// disjoint move sets per side.  dbuct's lumped backprop keeps no per-episode
+// choice sequence and does not accept it.
+//
+// Policy requirements:
+//   IAmaf: get_amaf(const INodeHandle& parent, const IChoice&) -> amaf_stats<IFloat>
+//          add_amaf(const INodeHandle& parent, const IChoice&, IFloat delta)
+//            -- see amaf_table.hpp
+//
+// get_first_play_urgency() is forwarded when the wrapped policy has it.
+
+enum class rave_schedule
+{
+    hand_selected,
+    minimum_mse
+};
+
+template<typename IFloat, typename IGetExplorationConstant, typename IAmaf>
+struct rave
+{
+    static constexpr bool scores_unvisited = true;
+
+    rave(IGetExplorationConstant& get_exploration_constant,
+         IAmaf&                   amaf,
+         IFloat                   k,
+         rave_schedule            schedule = rave_schedule::hand_selected)
+        : get_exploration_constant_(get_exploration_constant)
+        , amaf_(amaf)
+        , k_(k)
+        , schedule_(schedule)
+    {}
+
+    IAmaf& amaf() const { return amaf_; }
+
+    template<typename INodeHandle>
+    IFloat get_exploration_constant(const INodeHandle& parent) const
+    {
+        return get_exploration_constant_.get_exploration_constant(parent);
+    }
+
+    template<typename INodeHandle>
+    IFloat get_first_play_urgency(const INodeHandle& parent, IFloat parent_mean) const
+        requires requires (const IGetExplorationConstant& g)
+                 { g.get_first_play_urgency(parent, parent_mean); }
+    {
+        return get_exploration_constant_.get_first_play_urgency(parent, parent_mean);
+    }
+
+    template<typename INodeHandle>
+    auto scorer(const INodeHandle& parent, size_t parent_visits, IFloat unvisited) const
+    {
+        const IFloat        c         = get_exploration_constant_.get_exploration_constant(parent);
+        const IFloat        ln_parent = parent_visits == 0 ? IFloat{0}
+                                                           : std::log(static_cast<IFloat>(parent_visits));
+        const IFloat        k         = k_;
+        const rave_schedule schedule  = schedule_;
+
+        return [c, ln_parent, unvisited, k, schedule](const ucb_child<IFloat>& child, size_t)
+        {
+            if (child.n == 0)
+                return child.amaf_n == 0 ? unvisited : child.amaf + c * std::sqrt(ln_parent);
+
+            const IFloat n    = static_cast<IFloat>(child.n);
+            const IFloat m    = static_cast<IFloat>(child.amaf_n);
+            IFloat       beta = IFloat{0};
+            if (child.amaf_n != 0)
+                beta = schedule == rave_schedule::hand_selected
+                     ? std::sqrt(k / (3 * n + k))
+                     : m / (n + m + 4 * k * k * n * m);
+
+            const IFloat q = (1 - beta) * child.exploit + beta * child.amaf;
+            return q + c * std::sqrt(ln_parent / n);
+        };
+    }
+
+private:
+    IGetExplorationConstant& get_exploration_constant_;
+    IAmaf&                   amaf_;
+    IFloat                   k_;
+    rave_schedule            schedule_;
+};
+
+} // namespace monte_carlo
+
+#endif // RAVE_HPP
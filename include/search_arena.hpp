@@ -0,0 +1,75 @@
+#ifndef SEARCH_ARENA_HPP
+#define SEARCH_ARENA_HPP
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace monte_carlo
+{
+
+// search_arena
+//
+// Per-search monotonic arena for stat tables and their handles.  The tables
+// forward constructor arguments to their Map, so any std::pmr map takes the
+// arena's resource directly:
+//
+//   search_arena arena;
+//   auto& visits = arena.make<visits_table<int, std::pmr::unordered_map>>(arena.resource());
+//   auto& value  = arena.make<value_table<int, double, std::pmr::unordered_map>>(arena.resource());
+//   ... run the search ...
+//   arena.release();   // whole tree gone, no per-node free
+//
+// With a pmr map, keys are uses-allocator constructed, so path handles such as
+// std::pmr::vector<int> are copied into the arena together with their node.
+//
+// Allocation is a pointer bump inside large upstream blocks, and memory is
+// only returned by release().  Objects created with make() live in the arena
+// and their destructors are never run: use it only for types whose destructor
+// does nothing but free arena memory (the tables over a pmr Map with
+// trivially destructible or pmr-allocated keys and values qualify).  Objects
+// placed in the arena must not be used after release().
+//
+// Not thread-safe; use one arena per search.
+
+struct search_arena
+{
+    explicit search_arena(size_t                     initial_bytes = 1 << 20,
+                          std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+    search_arena(const search_arena&)            = delete;
+    search_arena& operator=(const search_arena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &arena_; }
+
+    // Constructs a T inside the arena; see the destructor caveat above.
+    template<typename T, typename... Args>
+    T& make(Args&&... args);
+
+    // Frees every allocation made since construction or the last release().
+    void release() { arena_.release(); }
+
+private:
+    std::pmr::monotonic_buffer_resource arena_;
+};
+
+// ---------------------------------------------------------------------------
+// member function definitions
+// ---------------------------------------------------------------------------
+
+inline search_arena::search_arena(size_t initial_bytes, std::pmr::memory_resource* upstream)
+    : arena_(initial_bytes, upstream)
+{}
+
+template<typename T, typename... Args>
+T& search_arena::make(Args&&... args)
+{
+    void* p = arena_.allocate(sizeof(T), alignof(T));
+    return *::new (p) T(std::forward<Args>(args)...);
+}
+
+} // namespace monte_carlo
+
+#endif // SEARCH_ARENA_HPP
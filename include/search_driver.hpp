@@ -0,0 +1,308 @@
+#ifndef SEARCH_DRIVER_HPP
+#define SEARCH_DRIVER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace monte_carlo
+{
+
+// search_driver<IEngine, IGame, ISetValueDelta>
+//
+// Owns one engine (sim or dbuct) and runs whole simulations against a game
+// model, so the caller's loop is a single call instead of one engine per
+// episode:
+//
+//   monte_carlo::search_driver<sim_t, game_t, delta_t> driver(
+//       game, delta, visits, value, visits, value, walker, rollout, delta, ec, root);
+//   driver.run(10000);
+//   driver.run_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(50));
+//
+// The arguments after game and value_delta construct the engine in place;
+// value_delta is the IGetValueDelta the engine was given, and receives the
+// game's reward before each terminate().
+//
+// Episodes: the engine chooses and the game applies until the game is
+// terminal.  A sim is reset() to game.root() after terminate(), reusing its
+// buffers.  A dbuct keeps its frames between episodes, and the next episode
+// resumes at the camped frame: the driver records the in-tree choices and
+// brings the game back to the deepest frame still on the stack.
+//
+// Make/unmake: if IGame provides undo(), the game is never restarted during
+// run().  After terminate() the driver undoes the episode's moves down to
+// the camped frame (to the root, for sim), so an episode costs its own
+// moves and their undos, with no copy of the root state and no replay of
+// the camped prefix.  Between calls to run() the game is back at its root.
+// Without undo() every episode restart()s the game and replays the camped
+// prefix.  In steady state the driver allocates nothing either way.
+//
+// reset() starts over at game.root(), for a game whose root has moved; with
+// dbuct it flushes the pending lumps first (dbuct::reset).
+//
+// Ending early: run() and run_until() return as soon as the engine reports
+// a solved root (solved(), with a proof_table), after the usual undo
+// cleanup, so a proven search stops spending simulations.  Both also take
+// an optional stop rule, asked every check_every simulations whether to
+// end the search before its budget:
+//
+//   monte_carlo::early_stop<int, double, visits_t, value_t, walker_t>
+//       stop(visits, value, walker, monte_carlo::stop_rule::visit_gap, 100);
+//   driver.run(10000, stop, 100);
+//
+// The rule is asked with the game at its root, as
+// should_stop(game.root(), game.choice_count(), game.choice_at(), done,
+// budget), done counting this call's simulations; run_until() passes
+// std::numeric_limits<size_t>::max() as the budget.  Bringing the game back
+// to its root costs a dbuct driver a replay of the camped prefix per check.
+// Without a rule the driver runs the full budget.
+//
+// Policy requirements:
+//   IGame:          root() -> INodeHandle                -- handle of the search root
+//                   terminal() -> bool
+//                   choice_count() -> const IGetChoiceCount&
+//                   choice_at() -> const IGetChoiceAt&   -- of the current position
+//                   apply(const IChoice&)
+//                   reward() -> IFloat                   -- of a terminal position
+//                   undo()                               -- reverts the last apply()
+//                   or restart()                         -- back to the root position
+//   ISetValueDelta: set_value(IFloat)                    -- e.g. uniform_value_delta
+//   IStop:          should_stop(root, count, at, done, budget) -> bool  -- e.g. early_stop
+
+template<
+    typename IEngine,
+    typename IGame,
+    typename ISetValueDelta
+>
+struct search_driver
+{
+    template<typename... EngineArgs>
+    search_driver(IGame& game, ISetValueDelta& value_delta, EngineArgs&&... engine_args);
+
+    // Runs n simulations, fewer if the root is solved; returns how many ran.
+    size_t run(size_t n);
+
+    // Runs up to n simulations, asking stop every check_every of them
+    // whether to end early; returns how many ran.
+    template<typename IStop>
+        requires (!std::is_arithmetic_v<IStop>)
+    size_t run(size_t n, IStop& stop, size_t check_every = 1);
+
+    // Runs simulations until the clock passes deadline, reading it every
+    // check_every simulations; returns how many ran.
+    template<typename Clock, typename Duration>
+    size_t run_until(const std::chrono::time_point<Clock, Duration>& deadline, size_t check_every = 1);
+
+    // As above, also asking stop at every clock reading.
+    template<typename Clock, typename Duration, typename IStop>
+        requires (!std::is_arithmetic_v<IStop>)
+    size_t run_until(const std::chrono::time_point<Clock, Duration>& deadline,
+                     IStop&                                          stop,
+                     size_t                                          check_every = 1);
+
+    // Starts over at game.root().
+    void reset();
+
+    // Simulations run so far.
+    size_t simulations() const { return simulations_; }
+
+    IEngine&       engine()       { return engine_; }
+    const IEngine& engine() const { return engine_; }
+
+private:
+    static constexpr bool camps  = requires (const IEngine& e) { e.depth(); };
+    static constexpr bool undoes = requires (IGame& g) { g.undo(); };
+    static constexpr bool solves = requires (const IEngine& e) { { e.solved() } -> std::convertible_to<bool>; };
+
+    using choice_type = std::remove_cvref_t<
+        decltype(std::declval<IEngine&>().choose(std::declval<IGame&>().choice_count(),
+                                                 std::declval<IGame&>().choice_at()))>;
+
+    void enter();
+    void simulate_once();
+    bool solved() const;
+    template<typename IStop>
+    bool stopped(IStop& stop, size_t done, size_t budget);
+
+    IGame&                   game_;
+    ISetValueDelta&          value_delta_;
+    IEngine                  engine_;
+    std::vector<choice_type> replay_;      // in-tree choices down to dbuct's top frame
+    std::vector<size_t>      frame_ends_;  // replay_ length at each frame's push
+    size_t                   applied_;  // moves the game is away from its root
+    size_t                   simulations_;
+};
+
+// ---------------------------------------------------------------------------
+// member function definitions
+// ---------------------------------------------------------------------------
+
+template<typename IEngine, typename IGame, typename ISetValueDelta>
+template<typename... EngineArgs>
+search_driver<IEngine, IGame, ISetValueDelta>::search_driver(IGame&          game,
+                                                             ISetValueDelta& value_delta,
+                                                             EngineArgs&&... engine_args)
+    : game_(game)
+    , value_delta_(value_delta)
+    , engine_(std::forward<EngineArgs>(engine_args)...)
+    , applied_(0)
+    , simulations_(0)
+{}
+
+template<typename IEngine, typename IGame, typename ISetValueDelta>
+size_t search_driver<IEngine, IGame, ISetValueDelta>::run(size_t n)
+{
+    size_t done = 0;
+    for (; done < n && !solved(); ++done)
+    {
+        if (!undoes || done == 0)
+            enter();
+        simulate_once();
+    }
+
+    if constexpr (undoes)
+        for (; applied_ > 0; --applied_)
+            game_.undo();
+    return done;
+}
+
+template<typename IEngine, typename IGame, typename ISetValueDelta>
+template<typename IStop>
+    requires (!std::is_arithmetic_v<IStop>)
+size_t search_driver<IEngine, IGame, ISetValueDelta>::run(size_t n, IStop& stop, size_t check_every)
+{
+    check_every = std::max<size_t>(check_every, 1);
+    size_t done = 0;
+    while (done < n)
+    {
+        const size_t chunk = std::min(check_every, n - done);
+        const size_t ran   = run(chunk);
+        done += ran;
+        if (ran < chunk || (done < n && stopped(stop, done, n)))
+            break;
+    }
+    return done;
+}
+
+template<typename IEngine, typename IGame, typename ISetValueDelta>
+template<typename Clock, typename Duration>
+size_t search_driver<IEngine, IGame, ISetValueDelta>::run_until(
+        const std::chrono::time_point<Clock, Duration>& deadline,
+        size_t                                          check_every)
+{
+    check_every = std::max<size_t>(check_every, 1);
+    const size_t before = simulations_;
+    while (Clock::now() < deadline)
+        if (run(check_every) < check_every)
+            break;
+    return simulations_ - before;
+}
+
+template<typename IEngine, typename IGame, typename ISetValueDelta>
+template<typename Clock, typename Duration, typename IStop>
+    requires (!std::is_arithmetic_v<IStop>)
+size_t search_driver<IEngine, IGame, ISetValueDelta>::run_until(
+        const std::chrono::time_point<Clock, Duration>& deadline,
+        IStop&                                          stop,
+        size_t                                          check_every)
+{
+    check_every = std::max<size_t>(check_every, 1);
+    const size_t before = simulations_;
+    while (Clock::now() < deadline)
+        if (run(check_every) < check_every
+            || stopped(stop, simulations_ - before, std::numeric_limits<size_t>::max()))
+            break;
+    return simulations_ - before;
+}
+
+template<typename IEngine, typename IGame, typename ISetValueDelta>
+void search_driver<IEngine, IGame, ISetValueDelta>::reset()
+{
+    engine_.reset(game_.root());
+    replay_.clear();
+    frame_ends_.clear();
+}
+
+template<typename IEngine, typename IGame, typename ISetValueDelta>
+bool search_driver<IEngine, IGame, ISetValueDelta>::solved() const
+{
+    if constexpr (solves)
+        return engine_.solved();
+    else
+        return false;
+}
+
+// Asks the stop rule with the game at its root (run() leaves a game with
+// undo() there already).
+template<typename IEngine, typename IGame, typename ISetValueDelta>
+template<typename IStop>
+bool search_driver<IEngine, IGame, ISetValueDelta>::stopped(IStop& stop, size_t done, size_t budget)
+{
+    if constexpr (!undoes)
+        game_.restart();
+    return stop.should_stop(game_.root(), game_.choice_count(), game_.choice_at(), done, budget);
+}
+
+// Brings the game from its root (or anywhere, without undo()) to the camped frame.
+template<typename IEngine, typename IGame, typename ISetValueDelta>
+void search_driver<IEngine, IGame, ISetValueDelta>::enter()
+{
+    if constexpr (!undoes)
+        game_.restart();
+    for (const choice_type& choice : replay_)
+        game_.apply(choice);
+    applied_ = replay_.size();
+}
+
+template<typename IEngine, typename IGame, typename ISetValueDelta>
+void search_driver<IEngine, IGame, ISetValueDelta>::simulate_once()
+{
+    while (!game_.terminal())
+    {
+        bool   in_tree = false;
+        size_t depth   = 0;
+        if constexpr (camps)
+        {
+            in_tree = !engine_.in_rollout();
+            depth   = engine_.depth();
+        }
+
+        const choice_type choice = engine_.choose(game_.choice_count(), game_.choice_at());
+        game_.apply(choice);
+        ++applied_;
+        if constexpr (camps)
+            if (in_tree)
+            {
+                // A folded forced move (forced_moves) is replayed but pushes no frame.
+                replay_.push_back(choice);
+                if (engine_.depth() > depth)
+                    frame_ends_.push_back(replay_.size());
+            }
+    }
+
+    value_delta_.set_value(game_.reward());
+    engine_.terminate();
+    ++simulations_;
+
+    if constexpr (camps)
+    {
+        frame_ends_.resize(engine_.depth() - 1);
+        const size_t keep = frame_ends_.empty() ? 0 : frame_ends_.back();
+        replay_.erase(replay_.begin() + static_cast<std::ptrdiff_t>(keep), replay_.end());
+    }
+    else
+        engine_.reset(game_.root());
+
+    if constexpr (undoes)
+        for (; applied_ > replay_.size(); --applied_)
+            game_.undo();
+}
+
+} // namespace monte_carlo
+
+#endif // SEARCH_DRIVER_HPP
@@ -0,0 +1,298 @@
+#ifndef SEARCH_POOL_HPP
+#define SEARCH_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace monte_carlo
+{
+
+// search_pool<IDriver>
+//
+// Runs many independent searches -- one per session, each with its own
+// root, engine and tables -- on a fixed set of worker threads, instead of
+// one thread per search:
+//
+//   monte_carlo::search_pool<driver_t> pool(std::thread::hardware_concurrency());
+//   const size_t t = pool.submit(session.driver, 5000, now + std::chrono::milliseconds(20));
+//   ...
+//   const auto result = pool.wait(t);   // result.simulations, result.latency
+//
+// A submitted search runs until it has used its simulation budget, its
+// deadline has passed, or the driver runs fewer simulations than a slice
+// asked for (search_driver does on a solved root), whichever comes first; pass
+// std::numeric_limits<size_t>::max() for a deadline-only search, and leave
+// the deadline out for a budget-only one.
+//
+// Scheduling: each worker owns a queue of searches, and new searches are
+// dealt to the queues in turn.  A worker takes the search at the front of
+// its queue, runs one slice (slice simulations, fewer if the budget has
+// less left), and puts it back at the end of the queue unless it is done,
+// so the searches in a queue share their worker round-robin.  A worker whose
+// queue is empty steals from the end of another worker's queue, and sleeps
+// only when every queue is empty.  The deadline is read before and after
+// each slice, so a search can overrun it by up to one slice.  Tickets are
+// kept for the pool's lifetime; a long-lived pool grows by one small record
+// per submission.
+//
+// A search runs on one worker at a time, but successive slices may run on
+// different workers.  The driver and everything it references (game model,
+// engine, tables, random engine) must belong to that search alone and stay
+// alive until it is done; wait() for it before reading its tables.  The
+// pool itself allocates per submitted search, not per slice.  The
+// destructor waits for every submitted search to finish.
+//
+// Policy requirements:
+//   IDriver: run(size_t n)           -- runs n simulations (search_driver)
+//            simulations() -> size_t -- simulations run so far
+
+template<typename IDriver>
+struct search_pool
+{
+    using clock_type = std::chrono::steady_clock;
+
+    struct result
+    {
+        size_t                simulations;  // run under this submission
+        clock_type::duration  latency;      // from submit() to done
+    };
+
+    explicit search_pool(size_t threads, size_t slice = 64);
+    ~search_pool();
+
+    search_pool(const search_pool&)            = delete;
+    search_pool& operator=(const search_pool&) = delete;
+
+    // Queues a search; returns its ticket.  Callable from any thread.
+    size_t submit(IDriver&                 driver,
+                  size_t                   budget,
+                  clock_type::time_point   deadline = clock_type::time_point::max());
+
+    // Blocks until the search with this ticket (from submit()) is done.
+    result wait(size_t ticket);
+
+    // Blocks until every search submitted so far is done.
+    void wait_all();
+
+    size_t threads() const { return workers_.size(); }
+
+private:
+    struct job
+    {
+        IDriver*               driver;
+        size_t                 budget;
+        clock_type::time_point deadline;
+        clock_type::time_point submitted;
+        size_t                 start;     // driver simulations() at submit()
+        bool                   done = false;
+        result                 outcome{};
+    };
+
+    struct queue
+    {
+        std::mutex       mutex;
+        std::deque<job*> jobs;
+    };
+
+    void work(size_t self);
+    void enqueue(size_t target, job* j);
+    job* take(size_t self);
+    bool run_slice(job& j);
+    void finish(job& j);
+
+    const size_t                        slice_;
+    std::vector<std::unique_ptr<queue>> queues_;
+    std::vector<std::thread>            workers_;
+
+    std::atomic<size_t>     queued_;   // jobs waiting in the queues, counted before the push
+    std::atomic<bool>       stop_;
+    std::mutex              idle_mutex_;
+    std::condition_variable idle_;
+
+    std::mutex              mutex_;     // guards jobs_, finished_, job::done / outcome
+    std::condition_variable finished_cv_;
+    std::deque<job>         jobs_;      // by ticket; a deque keeps addresses stable
+    size_t                  finished_;
+    size_t                  next_queue_;
+};
+
+// ---------------------------------------------------------------------------
+// member function definitions
+// ---------------------------------------------------------------------------
+
+template<typename IDriver>
+search_pool<IDriver>::search_pool(size_t threads, size_t slice)
+    : slice_(slice == 0 ? 1 : slice)
+    , queued_(0)
+    , stop_(false)
+    , finished_(0)
+    , next_queue_(0)
+{
+    threads = std::max<size_t>(threads, 1);
+    for (size_t i = 0; i < threads; ++i)
+        queues_.push_back(std::make_unique<queue>());
+    for (size_t i = 0; i < threads; ++i)
+        workers_.emplace_back([this, i] { work(i); });
+}
+
+template<typename IDriver>
+search_pool<IDriver>::~search_pool()
+{
+    wait_all();
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        stop_ = true;
+    }
+    idle_.notify_all();
+    for (std::thread& t : workers_)
+        t.join();
+}
+
+template<typename IDriver>
+size_t search_pool<IDriver>::submit(IDriver&               driver,
+                                    size_t                 budget,
+                                    clock_type::time_point deadline)
+{
+    job*   j;
+    size_t ticket;
+    size_t target;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ticket = jobs_.size();
+        j      = &jobs_.emplace_back(job{&driver, budget, deadline, clock_type::now(), driver.simulations()});
+        target = next_queue_;
+        next_queue_ = (next_queue_ + 1) % queues_.size();
+    }
+    enqueue(target, j);
+    return ticket;
+}
+
+template<typename IDriver>
+typename search_pool<IDriver>::result search_pool<IDriver>::wait(size_t ticket)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    finished_cv_.wait(lock, [&] { return jobs_[ticket].done; });
+    return jobs_[ticket].outcome;
+}
+
+template<typename IDriver>
+void search_pool<IDriver>::wait_all()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    finished_cv_.wait(lock, [&] { return finished_ == jobs_.size(); });
+}
+
+template<typename IDriver>
+void search_pool<IDriver>::work(size_t self)
+{
+    while (true)
+    {
+        job* j = take(self);
+        if (j == nullptr)
+        {
+            std::unique_lock<std::mutex> lock(idle_mutex_);
+            idle_.wait(lock, [&] { return queued_ > 0 || stop_; });
+            if (stop_ && queued_ == 0)
+                return;
+            continue;
+        }
+
+        if (!run_slice(*j))
+        {
+            finish(*j);
+            continue;
+        }
+
+        // Back of the own queue: the other searches here go first.  An idle
+        // worker is woken to steal it.
+        enqueue(self, j);
+    }
+}
+
+// Counts the job before it becomes visible in a queue, so a worker taking it
+// at once never drives queued_ below zero.
+template<typename IDriver>
+void search_pool<IDriver>::enqueue(size_t target, job* j)
+{
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        ++queued_;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+        queues_[target]->jobs.push_back(j);
+    }
+    idle_.notify_one();
+}
+
+// The front of the own queue, else the back of the next non-empty one.
+template<typename IDriver>
+typename search_pool<IDriver>::job* search_pool<IDriver>::take(size_t self)
+{
+    const size_t n = queues_.size();
+    for (size_t k = 0; k < n; ++k)
+    {
+        queue&                      q = *queues_[(self + k) % n];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.jobs.empty())
+            continue;
+
+        job* j;
+        if (k == 0)
+        {
+            j = q.jobs.front();
+            q.jobs.pop_front();
+        }
+        else
+        {
+            j = q.jobs.back();
+            q.jobs.pop_back();
+        }
+        std::lock_guard<std::mutex> idle(idle_mutex_);
+        --queued_;
+        return j;
+    }
+    return nullptr;
+}
+
+// Runs one slice unless the search is done; returns whether it has more to run.
+template<typename IDriver>
+bool search_pool<IDriver>::run_slice(job& j)
+{
+    size_t used = j.driver->simulations() - j.start;
+    if (used >= j.budget || clock_type::now() >= j.deadline)
+        return false;
+
+    // A driver that runs short of the slice has ended the search itself
+    // (search_driver on a solved root).
+    const size_t slice = std::min(slice_, j.budget - used);
+    j.driver->run(slice);
+    const size_t ran = j.driver->simulations() - j.start - used;
+    used += ran;
+    return ran == slice && used < j.budget && clock_type::now() < j.deadline;
+}
+
+template<typename IDriver>
+void search_pool<IDriver>::finish(job& j)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        j.done    = true;
+        j.outcome = {j.driver->simulations() - j.start, clock_type::now() - j.submitted};
+        ++finished_;
+    }
+    finished_cv_.notify_all();
+}
+
+} // namespace monte_carlo
+
+#endif // SEARCH_POOL_HPP
@@ -0,0 +1,125 @@
+#ifndef SELECT_CHILD_HPP
+#define SELECT_CHILD_HPP
+
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+#include "ucb_child.hpp"
+
+namespace monte_carlo
+{
+
+// select_child(select, parent, parent_visits, n, unvisited, stats)
+//
+// The selection loop shared by sim and dbuct.  Scores children 0..n-1 with
+// an ISelect policy and returns the highest, ties going to the lower index:
+//
+//   auto score = select.scorer(parent, parent_visits, unvisited);
+//   score(const ucb_child<IFloat>& child, size_t i) -> IFloat
+//
+// scorer() runs once per selection and folds everything that depends only
+// on the parent (c, ln N, sqrt N, the parent's prior row) into the returned
+// callable, so the per-child work is one stats(i) read and one score.
+//
+// unvisited is the score of a child with n == 0: +inf by default, or the
+// first-play urgency.  For ISelect::scores_unvisited == false (UCB1 family)
+// the scan stops at the first such child, because selection expands children
+// in choice order and the rest would tie with it.  PUCT-style policies set
+// it to true: their unvisited children differ by prior, so every child is
+// scored and the policy uses unvisited as the value estimate of a child it
+// has not tried.
+//
+// n is a size_t, or an integral_constant (see choice_span.hpp) when the
+// choice count is fixed at compile time; the scan is then fully unrolled
+// (up to 16 children), so the children's reads and scores are straight-line
+// code the CPU can overlap instead of a loop-carried branch per child.
+//
+// Proven children (MCTS-Solver, see proof_table.hpp) have nothing left to
+// explore below them, so they score their exact value with no explore term.
+// The best of them is passed over only when its value is at or below the best
+// unproven score -- the optimistic bound of a sibling that may still turn out
+// better -- so a proven best move keeps drawing visits before the parent is
+// proven, and unproven siblings are tried again as their explore terms grow.
+// With graded rewards and no proof bound, closing such a parent can take far
+// more simulations than when proven children were simply passed over.
+
+template<typename ISelect, typename INodeHandle, typename ICount, typename IFloat, typename IStats>
+ucb_selection select_child(const ISelect&     select,
+                           const INodeHandle& parent,
+                           size_t             parent_visits,
+                           ICount             n,
+                           IFloat             unvisited,
+                           IStats&&           stats)
+{
+    const auto score = select.scorer(parent, parent_visits, unvisited);
+
+    IFloat best_score = -std::numeric_limits<IFloat>::infinity();
+    size_t best_i     = 0;
+    size_t best_v     = 0;
+    bool   open       = false;   // an unproven child was seen
+
+    IFloat proven_value = -std::numeric_limits<IFloat>::infinity();
+    size_t proven_i     = 0;
+
+    // Scores child i; false stops the scan.
+    auto visit = [&](size_t i)
+    {
+        const ucb_child<IFloat> child = stats(i);
+
+        if (child.proven)
+        {
+            if (child.exploit > proven_value)
+            {
+                proven_value = child.exploit;
+                proven_i     = i;
+            }
+            return true;
+        }
+
+        if constexpr (!ISelect::scores_unvisited)
+            if (child.n == 0)
+            {
+                if (!open || unvisited > best_score)
+                {
+                    best_score = unvisited;
+                    best_i     = i;
+                    best_v     = child.v;
+                }
+                open = true;
+                return false;
+            }
+
+        const IFloat s = score(child, i);
+        if (!open || s > best_score)
+        {
+            best_score = s;
+            best_i     = i;
+            best_v     = child.v;
+        }
+        open = true;
+        return true;
+    };
+
+    if constexpr (std::is_same_v<ICount, size_t>)
+    {
+        for (size_t i = 0; i < n; ++i)
+            if (!visit(i))
+                break;
+    }
+    else
+    {
+#pragma GCC unroll 16
+        for (size_t i = 0; i < ICount::value; ++i)
+            if (!visit(i))
+                break;
+    }
+
+    if (proven_value > -std::numeric_limits<IFloat>::infinity() && (!open || proven_value > best_score))
+        return {proven_i, false};
+    return {best_i, best_v == 0};
+}
+
+} // namespace monte_carlo
+
+#endif // SELECT_CHILD_HPP
@@ -0,0 +1,227 @@
+#ifndef SEQUENTIAL_HALVING_HPP
+#define SEQUENTIAL_HALVING_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "select_child.hpp"
+#include "ucb1.hpp"
+#include "ucb_child.hpp"
+
+namespace monte_carlo
+{
+
+// sequential_halving<NodeHandle, IFloat, ISelect>
+//
+// Root selection by sequential halving (Karnin et al. 2013), for budgets of
+// a few hundred simulations where UCB1 at the root spreads its visits too
+// thinly.  Wraps the engines' ISelect policy and is passed in its place; the
+// wrapped policy still selects everywhere below the root:
+//
+//   monte_carlo::uniform_exploration_constant<double> ec(1.4);
+//   monte_carlo::sequential_halving<int, double, decltype(ec)> halving(ec, root, 400);
+//
+// The budget is split into ceil(log2 k) rounds over the root's k children
+// (the widened prefix, with progressive widening).  In each round every
+// surviving child is brought up to the same visit target, lowest visits
+// first, the target rising by budget / (survivors * rounds); then the
+// better half by mean survives.  Targets count visits, not selections, so
+// a dbuct root grant that sends a whole lump down one child is charged in
+// full.  Once one child is left every root selection goes to it.  A round
+// ends at the first root selection after its targets are met, so when the
+// budget runs out the final round's survivors (equal in visits) are still
+// listed: recommend the one with the best mean, or let one more root
+// selection settle it.
+//
+// This is plain sequential halving over all root children: the Gumbel
+// variant (Danihelka et al. 2022) samples its candidates from policy logits,
+// which this library does not have.
+//
+// Both engines find it through the select() hook (as for ucb_argmax_table);
+// get_exploration_constant(), get_first_play_urgency(), needs_squares and
+// amaf() are forwarded from the wrapped policy, so a wrapped rave still has
+// sim record and read its AMAF statistics.  Below the root it selects exactly as
+// the engines would with the wrapped policy alone.  reset() starts a new
+// search from another root.
+
+template<
+    typename NodeHandle,
+    typename IFloat,
+    typename ISelect
+>
+struct sequential_halving
+{
+    static constexpr bool needs_squares = []
+    {
+        if constexpr (requires { ISelect::needs_squares; })
+            return ISelect::needs_squares;
+        else
+            return false;
+    }();
+
+    sequential_halving(ISelect& select, const NodeHandle& root, size_t budget);
+
+    template<typename INodeHandle>
+    IFloat get_exploration_constant(const INodeHandle& parent) const
+    {
+        return select_.get_exploration_constant(parent);
+    }
+
+    template<typename INodeHandle>
+    IFloat get_first_play_urgency(const INodeHandle& parent, IFloat parent_mean) const
+        requires requires (const ISelect& s) { s.get_first_play_urgency(parent, parent_mean); }
+    {
+        return select_.get_first_play_urgency(parent, parent_mean);
+    }
+
+    decltype(auto) amaf() const
+        requires requires (ISelect& s) { s.amaf(); }
+    {
+        return select_.amaf();
+    }
+
+    template<typename IStats>
+    ucb_selection select(const NodeHandle& parent, size_t n, size_t parent_visits,
+                         IFloat unvisited_score, IStats&& stats);
+
+    // Starts over with a new root and budget.
+    void reset(const NodeHandle& root, size_t budget);
+
+    // Root child indices still in the running, best mean first after a halving.
+    std::span<const size_t> survivors() const { return survivors_; }
+
+    // Halvings done so far.
+    size_t round() const { return round_; }
+
+private:
+    template<typename IStats>
+    ucb_selection select_root(size_t n, IStats&& stats);
+
+    void start_round();
+
+    ISelect&            select_;
+    NodeHandle          root_;
+    size_t              budget_;
+    size_t              rounds_;
+    size_t              round_;
+    size_t              target_;    // visits each survivor must reach this round
+    size_t              children_;  // k, 0 until the root is first reached
+    std::vector<size_t> survivors_;
+};
+
+// ---------------------------------------------------------------------------
+// member function definitions
+// ---------------------------------------------------------------------------
+
+template<typename NodeHandle, typename IFloat, typename ISelect>
+sequential_halving<NodeHandle, IFloat, ISelect>::sequential_halving(ISelect&          select,
+                                                                   const NodeHandle& root,
+                                                                   size_t            budget)
+    : select_(select)
+    , root_(root)
+{
+    reset(root, budget);
+}
+
+template<typename NodeHandle, typename IFloat, typename ISelect>
+void sequential_halving<NodeHandle, IFloat, ISelect>::reset(const NodeHandle& root, size_t budget)
+{
+    root_     = root;
+    budget_   = budget;
+    rounds_   = 0;
+    round_    = 0;
+    target_   = 0;
+    children_ = 0;
+    survivors_.clear();
+}
+
+template<typename NodeHandle, typename IFloat, typename ISelect>
+template<typename IStats>
+ucb_selection sequential_halving<NodeHandle, IFloat, ISelect>::select(
+    const NodeHandle& parent, size_t n, size_t parent_visits,
+    IFloat unvisited_score, IStats&& stats)
+{
+    if (parent == root_)
+        return select_root(n, stats);
+
+    if constexpr (requires { select_.select(parent, n, parent_visits, unvisited_score, stats); })
+        return select_.select(parent, n, parent_visits, unvisited_score, stats);
+    else if constexpr (requires { ISelect::scores_unvisited; })
+        return select_child(select_, parent, parent_visits, n, unvisited_score, stats);
+    else
+        return select_child(ucb1<IFloat, ISelect>(select_), parent, parent_visits, n,
+                            unvisited_score, stats);
+}
+
+template<typename NodeHandle, typename IFloat, typename ISelect>
+void sequential_halving<NodeHandle, IFloat, ISelect>::start_round()
+{
+    const size_t share = budget_ / (survivors_.size() * rounds_);
+    target_ += std::max<size_t>(share, 1);
+}
+
+template<typename NodeHandle, typename IFloat, typename ISelect>
+template<typename IStats>
+ucb_selection sequential_halving<NodeHandle, IFloat, ISelect>::select_root(size_t n, IStats&& stats)
+{
+    if (children_ != n)
+    {
+        // First visit, or widening admitted more children: start over on them.
+        children_ = n;
+        rounds_   = 1;
+        while ((size_t{1} << rounds_) < n)
+            ++rounds_;
+        round_  = 0;
+        target_ = 0;
+        survivors_.resize(n);
+        for (size_t i = 0; i < n; ++i)
+            survivors_[i] = i;
+        start_round();
+    }
+
+    while (survivors_.size() > 1 && round_ < rounds_)
+    {
+        // Lowest-visit survivor still under this round's target.
+        size_t pick   = n;
+        size_t pick_n = target_;
+        size_t pick_v = 0;
+        for (size_t i : survivors_)
+        {
+            const ucb_child<IFloat> child = stats(i);
+            if (child.n < pick_n)
+            {
+                pick   = i;
+                pick_n = child.n;
+                pick_v = child.v;
+            }
+        }
+        if (pick != n)
+            return {pick, pick_v == 0};
+
+        // Round complete: keep the better half by mean; ties keep their order.
+        std::vector<IFloat> mean(n, -std::numeric_limits<IFloat>::infinity());
+        for (size_t i : survivors_)
+        {
+            const ucb_child<IFloat> child = stats(i);
+            if (child.v != 0)
+                mean[i] = child.exploit;
+        }
+        std::stable_sort(survivors_.begin(), survivors_.end(),
+                         [&](size_t a, size_t b) { return mean[a] > mean[b]; });
+        survivors_.resize((survivors_.size() + 1) / 2);
+        ++round_;
+        if (survivors_.size() > 1 && round_ < rounds_)
+            start_round();
+    }
+
+    // Budget spent or one child left: the leader takes every further visit.
+    const size_t leader = survivors_.front();
+    return {leader, stats(leader).v == 0};
+}
+
+} // namespace monte_carlo
+
+#endif // SEQUENTIAL_HALVING_HPP
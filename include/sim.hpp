@@ -1,10 +1,19 @@
 #ifndef SIM_HPP
 #define SIM_HPP
 
+#include <algorithm>
 #include <cmath>
+#include <concepts>
 #include <limits>
+#include <utility>
 #include <vector>
 
+#include "choice_span.hpp"
+#include "no_edge_visits.hpp"
+#include "select_child.hpp"
+#include "ucb1.hpp"
+#include "ucb_child.hpp"
+
 namespace monte_carlo
 {
 
@@ -16,6 +25,8 @@ namespace monte_carlo
 //   5. choice access — IGetChoiceCount, IGetChoiceAt
 //   6. rollout       — IRolloutChoose
 //   7. value delta   — IGetValueDelta
+//   8. selection     — ISelect
+//   9. edge stats    — IEdgeVisits (optional, default no_edge_visits)
 //
 // Policy requirements:
 //   IGetVisits:      get_visits(const INodeHandle&) -> size_t   -- 0 if unseen
@@ -24,22 +35,97 @@ namespace monte_carlo
 //   ISetValue:       set_value(const INodeHandle&, IFloat)  -> void
 //   IWalker:         walk(const INodeHandle&, const IChoice&) -> INodeHandle
 //   IGetChoiceCount: size() -> size_t
+//                    optional widened_size(size_t parent_visits) -> size_t
+//                      -- selection scans only that many choices; see progressive_widening.hpp
+//                    optional static arity, or std::array / choice_span<IChoice, N>
+//                      -- choice count fixed at compile time; see choice_span.hpp
 //   IGetChoiceAt:    at(size_t) -> IChoice
 //   IRolloutChoose:  rollout_choose(const IGetChoiceCount&, const IGetChoiceAt&) -> IChoice
 //   IGetValueDelta:  get_value_delta(const INodeHandle&) -> IFloat
 //                      -- called per path-node during terminate()
+//   ISelect:         get_exploration_constant(const INodeHandle& parent) -> IFloat
+//                      -- a bare exploration-constant policy selects by UCB1
+//                    or a score-based policy (ucb1, ucb1_tuned, puct); see select_child.hpp
+//   IEdgeVisits:     get_edge_visits(const INodeHandle& parent, const INodeHandle& child) -> size_t
+//                    set_edge_visits(const INodeHandle& parent, const INodeHandle& child, size_t)
+//                      -- e.g. edge_map_table, int_edge_unordered_table
 //
 // Caller contract:
 //   - Drive the game loop; call choose() for each step until the terminal state.
 //   - Call terminate() once the episode ends. It backpropagates the per-node
 //     delta (from IGetValueDelta) to every node on the selection path.
+//   - Either construct a new sim per episode, or call reset(root) after
+//     terminate() to run the next episode on the same object.
+//     search_driver does the latter for a game model; see search_driver.hpp.
 //
 // Zero-default contract: IGetVisits and IGetValue must return 0 for unseen handles.
 //
-// UCB1:
+// UCB1 (the default, or ucb1):
 //   exploit = get_value(child) / get_visits(child)
 //   explore = c * sqrt( ln(get_visits(parent)) / get_visits(child) )
 //   where c = get_exploration_constant(parent)
+//
+// Other score-based policies plug into the same loop (select_child):
+//   ucb1_tuned  -- variance-aware explore term; needs ISetValue / IGetValue
+//                  with set_value_squares / get_value_squares
+//                  (value_moments_table), which terminate() then keeps as
+//                  the sum of squared deltas per node
+//   puct        -- prior-weighted explore term, priors from an IGetPrior
+//                  (prior_table, uniform_prior); scores every child,
+//                  unvisited ones included
+//   rave        -- blends each child's mean with its AMAF mean; see "RAVE"
+//                  below
+//
+// Transpositions: when IWalker maps several paths onto one handle (a DAG),
+// a child's node visits include arrivals from other parents and can exceed
+// the parent's own visits, so the node-only explore term under-explores it.
+// With an edge table (UCT2-style selection, Childs et al. 2008):
+//   exploit = get_value(child) / get_visits(child)       -- pooled over all paths
+//   explore = c * sqrt( ln(get_visits(parent)) / get_edge_visits(parent, child) )
+// An edge never taken from this parent scores +inf even if the child node was
+// reached through another parent, and terminate() adds 1 to every edge on the
+// selection path alongside the node updates.  Expansion (entering rollout)
+// still keys on node visits, so a transposed child reuses its statistics.
+//
+// First-play urgency: if ISelect also provides
+//   get_first_play_urgency(const INodeHandle& parent, IFloat parent_mean) -> IFloat
+// (e.g. first_play_urgency), an unvisited child scores that value instead of
+// +inf and competes with its visited siblings; see first_play_urgency.hpp.
+//
+// Solver: if the value table provides proof accessors (proof_table), an
+// episode that ends in the tree proves its last node, terminate() walks new
+// proofs up the path, selection scores proven children by their exact value
+// (select_child.hpp), and solved() reports a proven root.  See
+// proof_table.hpp.
+//
+// RAVE: if ISelect provides amaf() (rave, over an amaf_table), sim records
+// every choice of the episode, rollout included, and terminate() credits
+// each choice's first occurrence from every selection-path node onwards to
+// that node's AMAF statistics; IChoice must then be equality-comparable.
+// With forced moves folded, folded forced steps are left out of the
+// recorded choices and rollout steps are recorded, so AMAF credit goes to
+// the decisions and the rollout moves, each credited from the node it was
+// scored under; the last path node's delta is read at the handle the
+// rollout actually reached.  See rave.hpp.
+//
+// Forced moves: if IGetChoiceCount has a static folds_forced_moves
+// (forced_moves), an in-tree step with a single choice is returned without
+// scoring, adds no path entry and keeps no statistics; the next decision is
+// scored as a child of the last node on the path.  See forced_moves.hpp.
+//
+// Prefetch: if the read tables provide prefetch(const INodeHandle&) (tables
+// over incremental_hash_map, frozen_stats_table), choose() walks all n
+// children and hints their entries before scoring any of them, and
+// terminate() hints the whole path before updating it.  On a tree much
+// larger than the cache the lookups then miss in parallel; UCB1-family
+// scans hint only the first parent_visits + 1 children, the most they can
+// read.  On a cache-resident table the hints are pure overhead (a few %);
+// read it through a view without prefetch() there.
+
+// Incremental selection: if ISelect also provides
+//   select(parent, n, parent_visits, unvisited_score, stats) -> ucb_selection
+// (ucb_argmax_table), choose() hands it the selection instead of scoring
+// every child; stats(i) reads child i as a ucb_child.  See ucb_argmax_table.hpp.
 
 template<
     typename INodeHandle,
@@ -54,7 +140,8 @@ template<
     typename IGetChoiceAt,
     typename IRolloutChoose,
     typename IGetValueDelta,
-    typename IGetExplorationConstant
+    typename ISelect,
+    typename IEdgeVisits = no_edge_visits
 >
 struct sim
 {
@@ -65,14 +152,99 @@ struct sim
         IWalker&                 walker,
         IRolloutChoose&          rollout,
         IGetValueDelta&          value_delta,
-        IGetExplorationConstant& get_exploration_constant,
+        ISelect&                 select,
+        INodeHandle              root)
+        requires std::same_as<IEdgeVisits, no_edge_visits>;
+
+    // Edge-aware selection and backprop; see "Transpositions" above.
+    sim(IGetVisits&              get_visits,
+        IGetValue&               get_value,
+        ISetVisits&              set_visits,
+        ISetValue&               set_value,
+        IWalker&                 walker,
+        IRolloutChoose&          rollout,
+        IGetValueDelta&          value_delta,
+        ISelect&                 select,
+        IEdgeVisits&             edge_visits,
         INodeHandle              root);
 
     IChoice choose(const IGetChoiceCount& get_choice_count, const IGetChoiceAt& get_choice_at);
     void    terminate();
     size_t  length() const;
 
+    // Starts a new episode at root, reusing the path buffers: a training
+    // loop that keeps one sim and calls reset() after each terminate() stops
+    // allocating once the buffers have grown to the longest episode.
+    void    reset(INodeHandle root);
+
+    // True once the root is proven (only with a proof_table; see proof_table.hpp).
+    bool solved() const;
+
 private:
+    static constexpr bool tracks_edges = !std::same_as<IEdgeVisits, no_edge_visits>;
+    static constexpr bool has_fpu      = requires (const ISelect& g,
+                                                   const INodeHandle&             h,
+                                                   IFloat                         m)
+                                         { g.get_first_play_urgency(h, m); };
+    static constexpr bool has_argmax   = requires (ISelect& g,
+                                                   const INodeHandle&       h,
+                                                   size_t                   z,
+                                                   IFloat                   f,
+                                                   ucb_child<IFloat>        (*stats)(size_t))
+                                         { { g.select(h, z, z, f, stats) } -> std::same_as<ucb_selection>; };
+    static constexpr bool scores_children = requires { ISelect::scores_unvisited; };
+    static constexpr bool reads_squares   = []
+    {
+        if constexpr (requires { ISelect::needs_squares; })
+            return ISelect::needs_squares;
+        else
+            return false;
+    }();
+    static constexpr bool tracks_squares  = requires (IGetValue& g, ISetValue& s,
+                                                      const INodeHandle& h, IFloat f)
+                                            { g.get_value_squares(h); s.set_value_squares(h, f); };
+    static_assert(!reads_squares || tracks_squares,
+                  "ISelect needs squares: pass a value table with get/set_value_squares (value_moments_table)");
+    static constexpr bool has_proofs      = requires (IGetValue& g, ISetValue& s,
+                                                      const INodeHandle& h, IFloat f, size_t z)
+                                            { g.is_proven(h); g.get_proven_value(h);
+                                              s.set_child_count(h, z); s.prove(h, f);
+                                              s.add_proven_child(h, f); };
+    static_assert(!has_proofs || !has_argmax,
+                  "proof_table scores proven children itself: use a scoring ISelect, "
+                  "not a select() hook (ucb_argmax_table, sequential_halving)");
+    static constexpr bool has_amaf        = requires (ISelect& g, const INodeHandle& h,
+                                                      const IChoice& c, IFloat f)
+                                            { g.amaf().get_amaf(h, c); g.amaf().add_amaf(h, c, f); };
+    static constexpr bool folds_forced    = requires { IGetChoiceCount::folds_forced_moves; };
+    static constexpr bool prefetches_visits = requires (const IGetVisits& g, const INodeHandle& h)
+                                              { g.prefetch(h); };
+    static constexpr bool prefetches_values = requires (const IGetValue& g, const INodeHandle& h)
+                                              { g.prefetch(h); };
+    static constexpr bool prefetches        = prefetches_visits || prefetches_values;
+    // UCB1-family scans stop at the first unvisited child (select_child).
+    static constexpr bool stops_at_unvisited = []
+    {
+        if constexpr (has_argmax)
+            return false;
+        else if constexpr (scores_children)
+            return !ISelect::scores_unvisited;
+        else
+            return true;
+    }();
+
+    sim(IGetVisits&              get_visits,
+        IGetValue&               get_value,
+        ISetVisits&              set_visits,
+        ISetValue&               set_value,
+        IWalker&                 walker,
+        IRolloutChoose&          rollout,
+        IGetValueDelta&          value_delta,
+        ISelect&                 select,
+        IEdgeVisits*             edge_visits,
+        INodeHandle              root,
+        int);
+
     IGetVisits&              get_visits_;
     IGetValue&               get_value_;
     ISetVisits&              set_visits_;
@@ -80,11 +252,28 @@ private:
     IWalker&                 walker_;
     IRolloutChoose&          rollout_;
     IGetValueDelta&          value_delta_;
-    IGetExplorationConstant& get_exploration_constant_;
+    ISelect&                 select_;
+    IEdgeVisits*             edge_visits_;   // null without an edge table
+
+    // Cache hints for h's entries in the read tables (once for a table
+    // passed as both).
+    void prefetch_stats(const INodeHandle& h) const
+    {
+        if constexpr (prefetches_visits)
+            get_visits_.prefetch(h);
+        if constexpr (prefetches_values)
+            if (static_cast<const void*>(&get_value_) != static_cast<const void*>(&get_visits_))
+                get_value_.prefetch(h);
+    }
 
     INodeHandle              current_node_;
     std::vector<INodeHandle> backprop_path_;
+    std::vector<INodeHandle> children_;      // child handles of this choose(), only with prefetch
+    std::vector<IChoice>     choices_;       // the episode's choices, only with RAVE
+    std::vector<IChoice>     amaf_seen_;     // distinct choices of an episode suffix, in terminate()
+    INodeHandle              amaf_leaf_child_;  // reached by the first rollout step, only with RAVE
     size_t                   sim_length_;
+    size_t                   folded_;        // forced in-tree steps this episode
     bool                     in_rollout_;
 };
 
@@ -98,13 +287,13 @@ template<typename INodeHandle, typename IChoice, typename IFloat,
          typename IWalker,
          typename IGetChoiceCount, typename IGetChoiceAt,
          typename IRolloutChoose,
-         typename IGetValueDelta, typename IGEC>
+         typename IGetValueDelta, typename ISel, typename IEdgeVisits>
 sim<INodeHandle, IChoice, IFloat,
     IGetVisits, IGetValue, ISetVisits, ISetValue,
     IWalker,
     IGetChoiceCount, IGetChoiceAt,
     IRolloutChoose,
-    IGetValueDelta, IGEC>::sim(
+    IGetValueDelta, ISel, IEdgeVisits>::sim(
         IGetVisits& get_visits,
         IGetValue&  get_value,
         ISetVisits& set_visits,
@@ -112,8 +301,64 @@ sim<INodeHandle, IChoice, IFloat,
         IWalker&    walker,
         IRolloutChoose& rollout,
         IGetValueDelta& value_delta,
-        IGEC&           get_exploration_constant,
+        ISel&           select,
         INodeHandle     root)
+        requires std::same_as<IEdgeVisits, no_edge_visits>
+    : sim(get_visits, get_value, set_visits, set_value, walker, rollout, value_delta,
+          select, nullptr, root, 0)
+{}
+
+template<typename INodeHandle, typename IChoice, typename IFloat,
+         typename IGetVisits, typename IGetValue,
+         typename ISetVisits, typename ISetValue,
+         typename IWalker,
+         typename IGetChoiceCount, typename IGetChoiceAt,
+         typename IRolloutChoose,
+         typename IGetValueDelta, typename ISel, typename IEdgeVisits>
+sim<INodeHandle, IChoice, IFloat,
+    IGetVisits, IGetValue, ISetVisits, ISetValue,
+    IWalker,
+    IGetChoiceCount, IGetChoiceAt,
+    IRolloutChoose,
+    IGetValueDelta, ISel, IEdgeVisits>::sim(
+        IGetVisits&  get_visits,
+        IGetValue&   get_value,
+        ISetVisits&  set_visits,
+        ISetValue&   set_value,
+        IWalker&     walker,
+        IRolloutChoose& rollout,
+        IGetValueDelta& value_delta,
+        ISel&           select,
+        IEdgeVisits&    edge_visits,
+        INodeHandle     root)
+    : sim(get_visits, get_value, set_visits, set_value, walker, rollout, value_delta,
+          select, &edge_visits, root, 0)
+{}
+
+template<typename INodeHandle, typename IChoice, typename IFloat,
+         typename IGetVisits, typename IGetValue,
+         typename ISetVisits, typename ISetValue,
+         typename IWalker,
+         typename IGetChoiceCount, typename IGetChoiceAt,
+         typename IRolloutChoose,
+         typename IGetValueDelta, typename ISel, typename IEdgeVisits>
+sim<INodeHandle, IChoice, IFloat,
+    IGetVisits, IGetValue, ISetVisits, ISetValue,
+    IWalker,
+    IGetChoiceCount, IGetChoiceAt,
+    IRolloutChoose,
+    IGetValueDelta, ISel, IEdgeVisits>::sim(
+        IGetVisits&  get_visits,
+        IGetValue&   get_value,
+        ISetVisits&  set_visits,
+        ISetValue&   set_value,
+        IWalker&     walker,
+        IRolloutChoose& rollout,
+        IGetValueDelta& value_delta,
+        ISel&           select,
+        IEdgeVisits*    edge_visits,
+        INodeHandle     root,
+        int)
     : get_visits_(get_visits)
     , get_value_(get_value)
     , set_visits_(set_visits)
@@ -121,10 +366,13 @@ sim<INodeHandle, IChoice, IFloat,
     , walker_(walker)
     , rollout_(rollout)
     , value_delta_(value_delta)
-    , get_exploration_constant_(get_exploration_constant)
+    , select_(select)
+    , edge_visits_(edge_visits)
     , current_node_(root)
     , backprop_path_({root})
+    , amaf_leaf_child_(root)
     , sim_length_(0)
+    , folded_(0)
     , in_rollout_(false)
 {}
 
@@ -134,14 +382,14 @@ template<typename INodeHandle, typename IChoice, typename IFloat,
          typename IWalker,
          typename IGetChoiceCount, typename IGetChoiceAt,
          typename IRolloutChoose,
-         typename IGetValueDelta, typename IGEC>
+         typename IGetValueDelta, typename ISel, typename IEdgeVisits>
 IChoice
 sim<INodeHandle, IChoice, IFloat,
     IGetVisits, IGetValue, ISetVisits, ISetValue,
     IWalker,
     IGetChoiceCount, IGetChoiceAt,
     IRolloutChoose,
-    IGetValueDelta, IGEC>::choose(
+    IGetValueDelta, ISel, IEdgeVisits>::choose(
         const IGetChoiceCount& get_choice_count,
         const IGetChoiceAt&    get_choice_at)
 {
@@ -151,48 +399,119 @@ sim<INodeHandle, IChoice, IFloat,
     {
         IChoice chosen = rollout_.rollout_choose(get_choice_count, get_choice_at);
         current_node_  = walker_.walk(current_node_, chosen);
+        if constexpr (has_amaf)
+        {
+            // The first rollout step: its handle gives the last path node's
+            // AMAF delta, taken from where the episode really went.
+            if (choices_.size() + 1 == backprop_path_.size())
+                amaf_leaf_child_ = current_node_;
+            choices_.push_back(chosen);
+        }
         return chosen;
     }
 
-    // UCB1 selection.
-    IFloat best_score = -std::numeric_limits<IFloat>::infinity();
-    size_t best_i     = 0;
-    size_t n          = get_choice_count.size();
-    IFloat c          = get_exploration_constant_.get_exploration_constant(current_node_);
-    IFloat ln_parent  = std::log(static_cast<IFloat>(get_visits_.get_visits(current_node_)));
+    if constexpr (folds_forced)
+        if (get_choice_count.size() == 1)
+        {
+            IChoice chosen = get_choice_at.at(0);
+            current_node_  = walker_.walk(current_node_, chosen);
+            ++folded_;
+            return chosen;
+        }
+
+    // The node whose statistics stand for the current position: itself, or
+    // the last node kept before a folded forced chain.
+    const INodeHandle& parent = backprop_path_.back();
 
-    for (size_t i = 0; i < n; ++i)
-    {
-        IChoice           candidate  = get_choice_at.at(i);
-        const INodeHandle child_node = walker_.walk(current_node_, candidate);
-        size_t            child_v    = get_visits_.get_visits(child_node);
+    if constexpr (has_proofs)
+        set_value_.set_child_count(parent, get_choice_count.size());
+
+    size_t parent_v = get_visits_.get_visits(parent);
+    size_t n        = get_choice_count.size();
 
-        if (child_v == 0)
+    if constexpr (requires { get_choice_count.widened_size(parent_v); })
+        n = std::min(n, get_choice_count.widened_size(parent_v));
+
+    // A fixed arity (choice_span, std::array) makes the count a constant.
+    const auto count = selection_count<IGetChoiceCount>(n);
+
+    // Tables with prefetch(): walk every child first and hint its entries,
+    // so the cache misses overlap instead of stalling one scored child at a
+    // time.
+    if constexpr (prefetches)
+    {
+        // A node visited N times has at most N visited children, so a scan
+        // that stops at the first unvisited one reads at most N + 1.
+        const size_t hinted = stops_at_unvisited ? std::min(n, parent_v + 1) : n;
+        children_.clear();
+        for (size_t i = 0; i < hinted; ++i)
         {
-            best_score = std::numeric_limits<IFloat>::infinity();
-            best_i     = i;
-            break;
+            children_.push_back(walker_.walk(current_node_, get_choice_at.at(i)));
+            prefetch_stats(children_.back());
         }
+    }
+
+    IFloat unvisited = std::numeric_limits<IFloat>::infinity();
+    if constexpr (has_fpu)
+        unvisited = select_.get_first_play_urgency(
+            parent,
+            parent_v == 0 ? IFloat{0}
+                          : get_value_.get_value(parent) / static_cast<IFloat>(parent_v));
+
+    auto stats = [&](size_t i)
+    {
+        const INodeHandle child_node = [&]
+        {
+            if constexpr (prefetches)
+                if (i < children_.size())
+                    return children_[i];
+            return walker_.walk(current_node_, get_choice_at.at(i));
+        }();
+        ucb_child<IFloat> child{IFloat{0}, 0, get_visits_.get_visits(child_node), IFloat{0}, false, IFloat{0}, 0};
 
-        IFloat exploit = get_value_.get_value(child_node) / static_cast<IFloat>(child_v);
-        IFloat explore = std::sqrt(ln_parent / static_cast<IFloat>(child_v));
-        IFloat score   = exploit + c * explore;
+        child.n = child.v;
+        if constexpr (tracks_edges)
+            child.n = edge_visits_->get_edge_visits(parent, child_node);
 
-        if (score > best_score)
+        if (child.v != 0)
         {
-            best_score = score;
-            best_i     = i;
+            child.exploit = get_value_.get_value(child_node) / static_cast<IFloat>(child.v);
+            if constexpr (reads_squares)
+                child.squares = get_value_.get_value_squares(child_node);
         }
-    }
+        if constexpr (has_proofs)
+            if (get_value_.is_proven(child_node))
+            {
+                child.exploit = get_value_.get_proven_value(child_node);
+                child.proven  = true;
+            }
+        if constexpr (has_amaf)
+        {
+            const auto a = select_.amaf().get_amaf(parent, get_choice_at.at(i));
+            child.amaf_n = a.visits;
+            if (a.visits != 0)
+                child.amaf = a.value / static_cast<IFloat>(a.visits);
+        }
+        return child;
+    };
+
+    ucb_selection selection;
+    if constexpr (has_argmax)
+        selection = select_.select(parent, n, parent_v, unvisited, stats);
+    else if constexpr (scores_children)
+        selection = select_child(select_, parent, parent_v, count, unvisited, stats);
+    else
+        selection = select_child(ucb1<IFloat, ISel>(select_),
+                                 parent, parent_v, count, unvisited, stats);
 
-    IChoice     chosen       = get_choice_at.at(best_i);
+    IChoice     chosen       = get_choice_at.at(selection.index);
     INodeHandle chosen_child = walker_.walk(current_node_, chosen);
     backprop_path_.push_back(chosen_child);
     current_node_ = chosen_child;
+    if constexpr (has_amaf)
+        choices_.push_back(chosen);
 
-    size_t child_visits = get_visits_.get_visits(chosen_child);
-    
-    if (child_visits == 0)
+    if (selection.expand)
         in_rollout_ = true;
 
     return chosen;
@@ -204,21 +523,76 @@ template<typename INodeHandle, typename IChoice, typename IFloat,
          typename IWalker,
          typename IGetChoiceCount, typename IGetChoiceAt,
          typename IRolloutChoose,
-         typename IGetValueDelta, typename IGEC>
+         typename IGetValueDelta, typename ISel, typename IEdgeVisits>
 void
 sim<INodeHandle, IChoice, IFloat,
     IGetVisits, IGetValue, ISetVisits, ISetValue,
     IWalker,
     IGetChoiceCount, IGetChoiceAt,
     IRolloutChoose,
-    IGetValueDelta, IGEC>::terminate()
+    IGetValueDelta, ISel, IEdgeVisits>::terminate()
 {
+    if constexpr (prefetches)
+        for (const INodeHandle& node : backprop_path_)
+            prefetch_stats(node);
+
     for (const INodeHandle& node : backprop_path_)
     {
+        const IFloat delta = value_delta_.get_value_delta(node);
         set_visits_.set_visits(node, get_visits_.get_visits(node) + 1);
-        set_value_.set_value(node,   get_value_.get_value(node)
-                                     + value_delta_.get_value_delta(node));
+        set_value_.set_value(node,   get_value_.get_value(node) + delta);
+        if constexpr (tracks_squares)
+            set_value_.set_value_squares(node, get_value_.get_value_squares(node) + delta * delta);
+    }
+
+    if constexpr (tracks_edges)
+        for (size_t i = 1; i < backprop_path_.size(); ++i)
+        {
+            const INodeHandle& parent = backprop_path_[i - 1];
+            const INodeHandle& child  = backprop_path_[i];
+            edge_visits_->set_edge_visits(parent, child,
+                                          edge_visits_->get_edge_visits(parent, child) + 1);
+        }
+
+    // AMAF: node j of the path is credited, with the value delta of the child
+    // it chose, once for every distinct choice from j onwards.  One pass from
+    // the end of the episode collects those choices in amaf_seen_, so each
+    // step is checked against the distinct choices only.
+    if constexpr (has_amaf)
+    {
+        auto&        amaf  = select_.amaf();
+        const size_t nodes = std::min(backprop_path_.size(), choices_.size());
+        amaf_seen_.clear();
+        for (size_t k = choices_.size(); k-- > 0;)
+        {
+            if (std::find(amaf_seen_.begin(), amaf_seen_.end(), choices_[k]) == amaf_seen_.end())
+                amaf_seen_.push_back(choices_[k]);
+            if (k >= nodes)
+                continue;
+
+            const INodeHandle& node  = backprop_path_[k];
+            const IFloat       delta = k + 1 < backprop_path_.size()
+                                     ? value_delta_.get_value_delta(backprop_path_[k + 1])
+                                     : value_delta_.get_value_delta(amaf_leaf_child_);
+            for (const IChoice& c : amaf_seen_)
+                amaf.add_amaf(node, c, delta);
+        }
     }
+
+    // An episode that ends in the tree ends at a terminal: prove it and walk
+    // the new proof up the path for as long as it completes a parent.
+    if constexpr (has_proofs)
+        if (sim_length_ + 1 == backprop_path_.size() + folded_)
+        {
+            const INodeHandle& leaf = backprop_path_.back();
+            if (!set_value_.prove(leaf, value_delta_.get_value_delta(leaf)))
+                return;
+
+            for (size_t i = backprop_path_.size() - 1; i > 0; --i)
+                if (!set_value_.add_proven_child(backprop_path_[i - 1],
+                                                 get_value_.get_proven_value(backprop_path_[i])))
+                    break;
+        }
 }
 
 template<typename INodeHandle, typename IChoice, typename IFloat,
@@ -227,18 +601,63 @@ template<typename INodeHandle, typename IChoice, typename IFloat,
          typename IWalker,
          typename IGetChoiceCount, typename IGetChoiceAt,
          typename IRolloutChoose,
-         typename IGetValueDelta, typename IGEC>
+         typename IGetValueDelta, typename ISel, typename IEdgeVisits>
+void
+sim<INodeHandle, IChoice, IFloat,
+    IGetVisits, IGetValue, ISetVisits, ISetValue,
+    IWalker,
+    IGetChoiceCount, IGetChoiceAt,
+    IRolloutChoose,
+    IGetValueDelta, ISel, IEdgeVisits>::reset(INodeHandle root)
+{
+    current_node_ = root;
+    backprop_path_.clear();
+    backprop_path_.push_back(std::move(root));
+    choices_.clear();
+    sim_length_ = 0;
+    folded_     = 0;
+    in_rollout_ = false;
+}
+
+template<typename INodeHandle, typename IChoice, typename IFloat,
+         typename IGetVisits, typename IGetValue,
+         typename ISetVisits, typename ISetValue,
+         typename IWalker,
+         typename IGetChoiceCount, typename IGetChoiceAt,
+         typename IRolloutChoose,
+         typename IGetValueDelta, typename ISel, typename IEdgeVisits>
 size_t
 sim<INodeHandle, IChoice, IFloat,
     IGetVisits, IGetValue, ISetVisits, ISetValue,
     IWalker,
     IGetChoiceCount, IGetChoiceAt,
     IRolloutChoose,
-    IGetValueDelta, IGEC>::length() const
+    IGetValueDelta, ISel, IEdgeVisits>::length() const
 {
     return sim_length_;
 }
 
+template<typename INodeHandle, typename IChoice, typename IFloat,
+         typename IGetVisits, typename IGetValue,
+         typename ISetVisits, typename ISetValue,
+         typename IWalker,
+         typename IGetChoiceCount, typename IGetChoiceAt,
+         typename IRolloutChoose,
+         typename IGetValueDelta, typename ISel, typename IEdgeVisits>
+bool
+sim<INodeHandle, IChoice, IFloat,
+    IGetVisits, IGetValue, ISetVisits, ISetValue,
+    IWalker,
+    IGetChoiceCount, IGetChoiceAt,
+    IRolloutChoose,
+    IGetValueDelta, ISel, IEdgeVisits>::solved() const
+{
+    if constexpr (has_proofs)
+        return get_value_.is_proven(backprop_path_.front());
+    else
+        return false;
+}
+
 } // namespace monte_carlo
 
 #endif // SIM_HPP
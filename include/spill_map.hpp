@@ -0,0 +1,465 @@
+#ifndef SPILL_MAP_HPP
+#define SPILL_MAP_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "hash_mix.hpp"
+
+namespace monte_carlo
+{
+
+// spill_map<Key, T, Hash, KeyEqual>
+//
+// Out-of-core Map backend for visits_table / value_table / dispatches_table.
+// Hot entries live in memory; once hot_capacity entries are resident, the
+// coldest spill_fraction of them is written to a memory-mapped file on local
+// disk.  Plugs into the existing Map slot:
+//
+//   visits_table<int, spill_map>         visits(spill_config{.hot_capacity = 1 << 20});
+//   value_table<int, double, spill_map>  value (spill_config{.hot_capacity = 1 << 20});
+//
+// Map interface used by the tables:
+//   find(const Key&) -> iterator   (end() if never written)
+//   end()
+//   begin() const                  (every entry, hot then cold; for_each,
+//                                   freeze())
+//   operator[](const Key&) -> T&   (value-initialised on first write)
+//
+// Iterators are plain value_type pointers and are invalidated by any
+// non-const call.  find() never moves an entry, so reads of cold entries are
+// served straight from the mapping; operator[] promotes a cold entry back
+// into memory.  begin() returns a scan_iterator, which walks the hot entries
+// and then the cold pages in file order and compares equal to end() once
+// past the last entry.
+//
+// Cold file layout: fixed-size pages, each a small header followed by an
+// array of records.  An in-memory index maps each hash bucket to a chain of
+// pages, so a cold lookup touches one page per chain link.  Size cold_buckets
+// so that the expected cold set fills about one page per bucket
+// (records_per_page records each).  A page emptied by promotions is unlinked
+// from its chain and reused by the next bucket that needs a page, so churn
+// between hot and cold does not grow the file past its peak cold set.
+//
+// Spill order:
+//   least_recent — evict the entries written longest ago (any T)
+//   least_value  — evict the smallest values first; meant for visit and
+//                  dispatch counters, where it keeps well-visited nodes hot
+//
+// Key and T must be trivially copyable: records are stored as raw bytes.
+
+enum class spill_order
+{
+    least_recent,
+    least_value,
+};
+
+struct spill_config
+{
+    std::string path           = {};      // "" => unlinked temporary in $TMPDIR or /tmp
+    size_t      hot_capacity   = 1 << 20; // resident entries before a spill
+    size_t      cold_buckets   = 1 << 14; // page chains in the cold index
+    double      spill_fraction = 0.25;    // share of hot entries written per spill
+    spill_order order          = spill_order::least_recent;
+};
+
+template<
+    typename Key,
+    typename T,
+    typename Hash     = std::hash<Key>,
+    typename KeyEqual = std::equal_to<Key>
+>
+struct spill_map
+{
+    struct value_type
+    {
+        Key first;
+        T   second;
+    };
+
+    using key_type       = Key;
+    using mapped_type    = T;
+    using iterator       = value_type*;
+    using const_iterator = const value_type*;
+
+    struct scan_iterator
+    {
+        const spill_map* map;
+        size_t           hot;    // index into hot_, then hot_.size()
+        uint32_t         page;   // cold page once the hot entries are done
+        size_t           slot;
+
+        const value_type& operator*()  const { return *get(); }
+        const value_type* operator->() const { return get(); }
+        scan_iterator&    operator++();
+        bool              operator==(const_iterator e) const { return get() == e; }
+
+        const value_type* get() const;
+        void              settle();   // skip to a live cold slot at or after this one
+    };
+
+    spill_map() : spill_map(spill_config{}) {}
+    explicit spill_map(const spill_config& config);
+    ~spill_map();
+
+    spill_map(const spill_map&)            = delete;
+    spill_map& operator=(const spill_map&) = delete;
+
+    iterator       find(const Key& k);
+    const_iterator find(const Key& k) const;
+    iterator       end()       { return nullptr; }
+    const_iterator end() const { return nullptr; }
+    scan_iterator  begin() const;
+    T&             operator[](const Key& k);
+
+    size_t size()      const { return hot_.size() + cold_size_; }
+    size_t hot_size()  const { return hot_.size(); }
+    size_t cold_size() const { return cold_size_; }
+
+    // Pages holding cold records, and pages in the file (those plus free ones).
+    size_t cold_pages() const { return page_count_ - free_pages_; }
+    size_t file_pages() const { return page_count_; }
+
+private:
+    struct page_header
+    {
+        uint32_t count;
+        uint32_t next;
+    };
+
+    static constexpr size_t   page_bytes = 4096;
+    static constexpr uint32_t no_page    = UINT32_MAX;
+
+public:
+    static constexpr size_t records_per_page = (page_bytes - sizeof(page_header)) / sizeof(value_type);
+
+private:
+    static_assert(std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<T>,
+                  "spill_map stores records as raw bytes");
+
+    static_assert(sizeof(page_header) % alignof(value_type) == 0,
+                  "records must stay aligned after the page header");
+    static_assert(records_per_page > 0, "record larger than a page");
+
+    spill_config config_;
+    Hash         hash_;
+    KeyEqual     eq_;
+
+    std::unordered_map<Key, size_t, Hash, KeyEqual> hot_index_;
+    std::vector<value_type>                         hot_;
+    std::vector<uint64_t>                           stamps_;
+    uint64_t                                        clock_;
+
+    std::vector<uint32_t> bucket_head_;
+    size_t                cold_size_;
+    size_t                page_count_;
+    uint32_t              free_head_;    // chain of emptied pages, linked by next
+    size_t                free_pages_;
+    size_t                mapped_pages_;
+    int                   fd_;
+    unsigned char*        base_;
+
+    page_header* page(uint32_t p) const
+    { return reinterpret_cast<page_header*>(base_ + p * page_bytes); }
+
+    value_type* records(uint32_t p) const
+    { return reinterpret_cast<value_type*>(base_ + p * page_bytes + sizeof(page_header)); }
+
+    size_t bucket_of(const Key& k) const
+    { return hash_mix(hash_(k)) % bucket_head_.size(); }
+
+    value_type* find_cold(const Key& k, uint32_t& p, size_t& slot) const;
+    void        erase_cold(const Key& k, uint32_t p, size_t slot);
+    void        insert_cold(const value_type& r);
+    uint32_t    allocate_page();
+    void        spill();
+};
+
+// ---------------------------------------------------------------------------
+// member function definitions
+// ---------------------------------------------------------------------------
+
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+spill_map<Key, T, Hash, KeyEqual>::spill_map(const spill_config& config)
+    : config_(config)
+    , clock_(0)
+    , bucket_head_(std::max<size_t>(config.cold_buckets, 1), no_page)
+    , cold_size_(0)
+    , page_count_(0)
+    , free_head_(no_page)
+    , free_pages_(0)
+    , mapped_pages_(0)
+    , fd_(-1)
+    , base_(nullptr)
+{
+    config_.hot_capacity = std::max<size_t>(config_.hot_capacity, 1);
+
+    if (config_.path.empty())
+    {
+        const char* dir  = std::getenv("TMPDIR");
+        std::string name = std::string(dir ? dir : "/tmp") + "/mcts_spill_XXXXXX";
+        fd_ = ::mkstemp(name.data());
+        if (fd_ >= 0)
+            ::unlink(name.c_str());
+    }
+    else
+        fd_ = ::open(config_.path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+
+    if (fd_ < 0)
+        throw std::system_error(errno, std::generic_category(), "spill_map: open");
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+spill_map<Key, T, Hash, KeyEqual>::~spill_map()
+{
+    if (base_)
+        ::munmap(base_, mapped_pages_ * page_bytes);
+    if (fd_ >= 0)
+        ::close(fd_);
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+const typename spill_map<Key, T, Hash, KeyEqual>::value_type*
+spill_map<Key, T, Hash, KeyEqual>::scan_iterator::get() const
+{
+    if (hot < map->hot_.size())
+        return &map->hot_[hot];
+    if (page < map->page_count_)
+        return &map->records(page)[slot];
+    return nullptr;
+}
+
+// Emptied pages on the free list have count 0 and are passed over.
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+void spill_map<Key, T, Hash, KeyEqual>::scan_iterator::settle()
+{
+    if (hot < map->hot_.size())
+        return;
+    for (; page < map->page_count_; ++page, slot = 0)
+        if (slot < map->page(page)->count)
+            return;
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+typename spill_map<Key, T, Hash, KeyEqual>::scan_iterator&
+spill_map<Key, T, Hash, KeyEqual>::scan_iterator::operator++()
+{
+    if (hot < map->hot_.size())
+        ++hot;
+    else
+        ++slot;
+    settle();
+    return *this;
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+typename spill_map<Key, T, Hash, KeyEqual>::scan_iterator
+spill_map<Key, T, Hash, KeyEqual>::begin() const
+{
+    scan_iterator it{this, 0, 0, 0};
+    it.settle();
+    return it;
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+typename spill_map<Key, T, Hash, KeyEqual>::iterator
+spill_map<Key, T, Hash, KeyEqual>::find(const Key& k)
+{
+    return const_cast<iterator>(std::as_const(*this).find(k));
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+typename spill_map<Key, T, Hash, KeyEqual>::const_iterator
+spill_map<Key, T, Hash, KeyEqual>::find(const Key& k) const
+{
+    auto it = hot_index_.find(k);
+    if (it != hot_index_.end())
+        return &hot_[it->second];
+
+    uint32_t p;
+    size_t   slot;
+    return find_cold(k, p, slot);
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+T& spill_map<Key, T, Hash, KeyEqual>::operator[](const Key& k)
+{
+    auto it = hot_index_.find(k);
+    if (it != hot_index_.end())
+    {
+        stamps_[it->second] = ++clock_;
+        return hot_[it->second].second;
+    }
+
+    value_type r{k, T{}};
+    uint32_t   p;
+    size_t     slot;
+    if (value_type* cold = find_cold(k, p, slot))
+    {
+        r.second = cold->second;
+        erase_cold(k, p, slot);
+    }
+
+    // Spill before inserting so the returned reference stays valid.
+    if (hot_.size() >= config_.hot_capacity)
+        spill();
+
+    hot_index_.emplace(k, hot_.size());
+    hot_.push_back(r);
+    stamps_.push_back(++clock_);
+    return hot_.back().second;
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+typename spill_map<Key, T, Hash, KeyEqual>::value_type*
+spill_map<Key, T, Hash, KeyEqual>::find_cold(const Key& k, uint32_t& p, size_t& slot) const
+{
+    if (cold_size_ == 0)
+        return nullptr;
+
+    for (p = bucket_head_[bucket_of(k)]; p != no_page; p = page(p)->next)
+    {
+        value_type*  recs  = records(p);
+        const size_t count = page(p)->count;
+        for (slot = 0; slot < count; ++slot)
+            if (eq_(recs[slot].first, k))
+                return &recs[slot];
+    }
+    return nullptr;
+}
+
+// Removes record slot of page p in k's chain; an emptied page moves to the
+// free list.
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+void spill_map<Key, T, Hash, KeyEqual>::erase_cold(const Key& k, uint32_t p, size_t slot)
+{
+    page_header* h = page(p);
+    records(p)[slot] = records(p)[h->count - 1];
+    --h->count;
+    --cold_size_;
+    if (h->count != 0)
+        return;
+
+    uint32_t* link = &bucket_head_[bucket_of(k)];
+    while (*link != p)
+        link = &page(*link)->next;
+    *link      = h->next;
+    h->next    = free_head_;
+    free_head_ = p;
+    ++free_pages_;
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+void spill_map<Key, T, Hash, KeyEqual>::insert_cold(const value_type& r)
+{
+    uint32_t& head = bucket_head_[bucket_of(r.first)];
+
+    uint32_t p = head;
+    while (p != no_page && page(p)->count == records_per_page)
+        p = page(p)->next;
+
+    if (p == no_page)
+    {
+        p             = allocate_page();
+        page(p)->next = head;
+        head          = p;
+    }
+
+    records(p)[page(p)->count++] = r;
+    ++cold_size_;
+}
+
+// A free page if there is one, else a new page at the end of the file.
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+uint32_t spill_map<Key, T, Hash, KeyEqual>::allocate_page()
+{
+    if (free_head_ != no_page)
+    {
+        const uint32_t p = free_head_;
+        free_head_ = page(p)->next;
+        --free_pages_;
+        *page(p) = {0, no_page};
+        return p;
+    }
+
+    if (page_count_ == mapped_pages_)
+    {
+        const size_t grown = std::max<size_t>(16, 2 * mapped_pages_);
+
+        // Map the grown file before dropping the old mapping, so a failure
+        // leaves the map as it was.
+        if (::ftruncate(fd_, static_cast<off_t>(grown * page_bytes)) != 0)
+            throw std::system_error(errno, std::generic_category(), "spill_map: ftruncate");
+        void* m = ::mmap(nullptr, grown * page_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (m == MAP_FAILED)
+            throw std::system_error(errno, std::generic_category(), "spill_map: mmap");
+
+        if (base_)
+            ::munmap(base_, mapped_pages_ * page_bytes);
+        base_         = static_cast<unsigned char*>(m);
+        mapped_pages_ = grown;
+    }
+
+    const uint32_t p = static_cast<uint32_t>(page_count_++);
+    *page(p) = {0, no_page};
+    return p;
+}
+
+template<typename Key, typename T, typename Hash, typename KeyEqual>
+void spill_map<Key, T, Hash, KeyEqual>::spill()
+{
+    const size_t n       = hot_.size();
+    const size_t victims = std::clamp<size_t>(
+        static_cast<size_t>(static_cast<double>(n) * config_.spill_fraction), 1, n);
+
+    std::vector<size_t> order(n);
+    for (size_t i = 0; i < n; ++i)
+        order[i] = i;
+
+    auto colder = [&](size_t a, size_t b)
+    {
+        if constexpr (std::is_arithmetic_v<T>)
+            if (config_.order == spill_order::least_value && hot_[a].second != hot_[b].second)
+                return hot_[a].second < hot_[b].second;
+        return stamps_[a] < stamps_[b];
+    };
+    std::nth_element(order.begin(), order.begin() + (victims - 1), order.end(), colder);
+    order.resize(victims);
+
+    // Swap-remove from the highest slot down: the element moved into a freed
+    // slot is never itself a pending victim.
+    std::sort(order.begin(), order.end(), std::greater<size_t>());
+    for (size_t slot : order)
+    {
+        insert_cold(hot_[slot]);
+        hot_index_.erase(hot_[slot].first);
+
+        const size_t last = hot_.size() - 1;
+        if (slot != last)
+        {
+            hot_[slot]    = hot_[last];
+            stamps_[slot] = stamps_[last];
+            hot_index_[hot_[slot].first] = slot;
+        }
+        hot_.pop_back();
+        stamps_.pop_back();
+    }
+}
+
+} // namespace monte_carlo
+
+#endif // SPILL_MAP_HPP
@@ -0,0 +1,69 @@
+#ifndef UCB1_HPP
+#define UCB1_HPP
+
+#include <cmath>
+#include <cstddef>
+
+#include "ucb_child.hpp"
+
+namespace monte_carlo
+{
+
+// ucb1<IFloat, IGetExplorationConstant>
+//
+// ISelect policy for sim / dbuct scoring children by UCB1 (Auer et al. 2002):
+//   exploit + c * sqrt( ln N / n )
+// with c = get_exploration_constant(parent), N the parent's visits and n the
+// child's (edge) visits.  This is what the engines do when they are given a
+// bare IGetExplorationConstant; wrap it explicitly to combine it with other
+// ISelect adapters.  get_first_play_urgency() is forwarded when the wrapped
+// policy has it (e.g. first_play_urgency).
+//
+// Score-based ISelect contract (see select_child.hpp):
+//   static constexpr bool scores_unvisited
+//   scorer(const INodeHandle& parent, size_t parent_visits, IFloat unvisited)
+//     -> callable (const ucb_child<IFloat>&, size_t i) -> IFloat
+
+template<typename IFloat, typename IGetExplorationConstant>
+struct ucb1
+{
+    static constexpr bool scores_unvisited = false;
+
+    explicit ucb1(IGetExplorationConstant& get_exploration_constant)
+        : get_exploration_constant_(get_exploration_constant)
+    {}
+
+    template<typename INodeHandle>
+    IFloat get_exploration_constant(const INodeHandle& parent) const
+    {
+        return get_exploration_constant_.get_exploration_constant(parent);
+    }
+
+    template<typename INodeHandle>
+    IFloat get_first_play_urgency(const INodeHandle& parent, IFloat parent_mean) const
+        requires requires (const IGetExplorationConstant& g)
+                 { g.get_first_play_urgency(parent, parent_mean); }
+    {
+        return get_exploration_constant_.get_first_play_urgency(parent, parent_mean);
+    }
+
+    template<typename INodeHandle>
+    auto scorer(const INodeHandle& parent, size_t parent_visits, IFloat) const
+    {
+        const IFloat c         = get_exploration_constant_.get_exploration_constant(parent);
+        const IFloat ln_parent = std::log(static_cast<IFloat>(parent_visits));
+
+        return [c, ln_parent](const ucb_child<IFloat>& child, size_t)
+        {
+            IFloat explore = std::sqrt(ln_parent / static_cast<IFloat>(child.n));
+            return child.exploit + c * explore;
+        };
+    }
+
+private:
+    IGetExplorationConstant& get_exploration_constant_;
+};
+
+} // namespace monte_carlo
+
+#endif // UCB1_HPP
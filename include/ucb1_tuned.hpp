@@ -0,0 +1,77 @@
+#ifndef UCB1_TUNED_HPP
+#define UCB1_TUNED_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "ucb_child.hpp"
+
+namespace monte_carlo
+{
+
+// ucb1_tuned<IFloat, IGetExplorationConstant>
+//
+// ISelect policy scoring children by UCB1-Tuned (Auer et al. 2002), which
+// scales the explore term by an upper bound on the child's reward variance:
+//   V     = squares / v - mean^2 + sqrt( 2 ln N / n )
+//   score = mean + c * sqrt( ln N / n * min(variance_bound, V) )
+// c = 1 and variance_bound = 1/4 is the published form for rewards in
+// [0, 1]; for rewards spanning a range R use variance_bound = R^2 / 4.
+//
+// Needs the per-node sum of squared value deltas: pass a value table that
+// provides get_value_squares / set_value_squares (value_moments_table) as
+// IGetValue and ISetValue.  The engines maintain it during backprop and
+// refuse to compile ucb1_tuned without it.
+
+template<typename IFloat, typename IGetExplorationConstant>
+struct ucb1_tuned
+{
+    static constexpr bool scores_unvisited = false;
+    static constexpr bool needs_squares    = true;
+
+    explicit ucb1_tuned(IGetExplorationConstant& get_exploration_constant,
+                        IFloat                   variance_bound = IFloat{0.25})
+        : get_exploration_constant_(get_exploration_constant)
+        , variance_bound_(variance_bound)
+    {}
+
+    template<typename INodeHandle>
+    IFloat get_exploration_constant(const INodeHandle& parent) const
+    {
+        return get_exploration_constant_.get_exploration_constant(parent);
+    }
+
+    template<typename INodeHandle>
+    IFloat get_first_play_urgency(const INodeHandle& parent, IFloat parent_mean) const
+        requires requires (const IGetExplorationConstant& g)
+                 { g.get_first_play_urgency(parent, parent_mean); }
+    {
+        return get_exploration_constant_.get_first_play_urgency(parent, parent_mean);
+    }
+
+    template<typename INodeHandle>
+    auto scorer(const INodeHandle& parent, size_t parent_visits, IFloat) const
+    {
+        const IFloat c         = get_exploration_constant_.get_exploration_constant(parent);
+        const IFloat ln_parent = std::log(static_cast<IFloat>(parent_visits));
+        const IFloat bound     = variance_bound_;
+
+        return [c, ln_parent, bound](const ucb_child<IFloat>& child, size_t)
+        {
+            const IFloat mean     = child.exploit;
+            const IFloat ratio    = ln_parent / static_cast<IFloat>(child.n);
+            const IFloat variance = child.squares / static_cast<IFloat>(child.v) - mean * mean;
+            const IFloat v_bound  = variance + std::sqrt(2 * ratio);
+            return mean + c * std::sqrt(ratio * std::min(bound, v_bound));
+        };
+    }
+
+private:
+    IGetExplorationConstant& get_exploration_constant_;
+    IFloat                   variance_bound_;
+};
+
+} // namespace monte_carlo
+
+#endif // UCB1_TUNED_HPP
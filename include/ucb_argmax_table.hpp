@@ -0,0 +1,298 @@
+#ifndef UCB_ARGMAX_TABLE_HPP
+#define UCB_ARGMAX_TABLE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "ucb_child.hpp"
+
+namespace monte_carlo
+{
+
+// ucb_argmax_table<NodeHandle, IFloat, IGetExplorationConstant, Map>
+//
+// Incremental UCB1 selection.  Wraps an IGetExplorationConstant policy and is
+// passed in its place to sim / dbuct:
+//
+//   monte_carlo::uniform_exploration_constant<double> ec(1.4);
+//   monte_carlo::ucb_argmax_table<int, double, decltype(ec), std::unordered_map> argmax(ec);
+//
+// Both engines look for select() on that policy and, when present, hand it
+// the selection at every tree node instead of scoring all children.  The
+// table keeps one tournament tree per parent over the UCB1 scores of its
+// visited children, so a selection costs O(log n) score evaluations instead
+// of n, plus the statistics lookups of two children:
+//   - the child chosen at this parent last time, the only one whose stats
+//     have changed since (refreshed before the query), and
+//   - the first unvisited child, the candidate for expansion.
+//
+// Parent visits N raise every child's explore term c * sqrt(ln N / n), most
+// for the least visited, so a cached winner can fall behind its sibling as N
+// grows.  Each internal tree node therefore stores the N (as sqrt(ln N)) up
+// to which its winner is certain to stay ahead, with a margin for rounding,
+// and is recomputed only once the parent has passed it.  Winners are always
+// decided with the engines' own score expression, ties going to the lower
+// index, so the choices are exactly those of the scanning loop.
+//
+// Exactness assumes a child's statistics only change through selections at
+// this parent, which holds for trees.  With transpositions a child updated
+// through another parent keeps its old score here until it is selected from
+// this parent again; the search stays valid but may differ from the scan.
+// widened_size() and get_first_play_urgency() are honoured as in the scan;
+// the latter is forwarded from the wrapped policy when it has one.
+//
+// Map parameter: as for visits_table (std::unordered_map, std::map,
+// incremental_hash_map, ...), mapping NodeHandle to the per-parent tree.
+
+template<
+    typename NodeHandle,
+    typename IFloat,
+    typename IGetExplorationConstant,
+    template<typename...> typename Map
+>
+struct ucb_argmax_table
+{
+    explicit ucb_argmax_table(IGetExplorationConstant& get_exploration_constant);
+
+    template<typename INodeHandle>
+    IFloat get_exploration_constant(const INodeHandle& parent) const
+    {
+        return get_exploration_constant_.get_exploration_constant(parent);
+    }
+
+    template<typename INodeHandle>
+    IFloat get_first_play_urgency(const INodeHandle& parent, IFloat parent_mean) const
+        requires requires (const IGetExplorationConstant& g)
+                 { g.get_first_play_urgency(parent, parent_mean); }
+    {
+        return get_exploration_constant_.get_first_play_urgency(parent, parent_mean);
+    }
+
+    // Chooses among the first n children of parent.  stats(i) -> ucb_child<IFloat>
+    // reads child i; unvisited_score is what the first unvisited child scores
+    // (+inf, or the first-play urgency).  The exploration constant is read
+    // from the wrapped policy at parent.
+    template<typename IStats>
+    ucb_selection select(const NodeHandle& parent, size_t n, size_t parent_visits,
+                         IFloat unvisited_score, IStats&& stats);
+
+    // Parents with a tournament tree.
+    size_t size() const { return tournaments_.size(); }
+
+private:
+    static constexpr size_t none       = std::numeric_limits<size_t>::max();
+    static constexpr size_t min_leaves = 4;
+
+    struct leaf
+    {
+        IFloat exploit;
+        IFloat slope;    // 1 / sqrt(n)
+        size_t n;
+    };
+
+    struct node
+    {
+        size_t winner;   // leaf index, or none
+        IFloat expiry;   // valid while sqrt(ln N) < expiry
+    };
+
+    struct tournament
+    {
+        std::vector<leaf> leaves;
+        std::vector<node> nodes;          // root at 1, leaf i at leaves.size() + i
+        size_t            prefix = 0;     // children [0, prefix) are visited
+        size_t            last   = none;  // child chosen by the previous select()
+        IFloat            c      = IFloat{0};
+    };
+
+    static IFloat score(const leaf& l, IFloat c, IFloat ln_parent);
+    static IFloat expiry(const leaf& w, const leaf& l, IFloat c, IFloat root_ln);
+
+    static void set_leaf(tournament& t, size_t i, const ucb_child<IFloat>& child);
+    static void grow(tournament& t);
+    static void expire_all(tournament& t);
+    static void fix(tournament& t, size_t j, IFloat root_ln, IFloat ln_parent);
+
+    IGetExplorationConstant&   get_exploration_constant_;
+    Map<NodeHandle, tournament> tournaments_;
+};
+
+// ---------------------------------------------------------------------------
+// member function definitions
+// ---------------------------------------------------------------------------
+
+template<typename NodeHandle, typename IFloat, typename IGEC, template<typename...> typename Map>
+ucb_argmax_table<NodeHandle, IFloat, IGEC, Map>::ucb_argmax_table(IGEC& get_exploration_constant)
+    : get_exploration_constant_(get_exploration_constant)
+{}
+
+template<typename NodeHandle, typename IFloat, typename IGEC, template<typename...> typename Map>
+template<typename IStats>
+ucb_selection ucb_argmax_table<NodeHandle, IFloat, IGEC, Map>::select(
+    const NodeHandle& parent, size_t n, size_t parent_visits,
+    IFloat unvisited_score, IStats&& stats)
+{
+    tournament&  t         = tournaments_[parent];
+    const IFloat c         = get_exploration_constant_.get_exploration_constant(parent);
+    const IFloat ln_parent = std::log(static_cast<IFloat>(parent_visits));
+    const IFloat root_ln   = ln_parent > 0 ? std::sqrt(ln_parent) : IFloat{0};
+
+    if (t.c != c)
+    {
+        t.c = c;
+        expire_all(t);
+    }
+
+    if (t.last < t.prefix)
+        set_leaf(t, t.last, stats(t.last));
+    t.last = none;
+
+    // Extend the visited prefix up to the first unvisited child.
+    ucb_child<IFloat> next{IFloat{0}, 0, 0, IFloat{0}, false, IFloat{0}, 0};
+    bool              has_next = false;
+    while (t.prefix < n)
+    {
+        next = stats(t.prefix);
+        if (next.n == 0)
+        {
+            has_next = true;
+            break;
+        }
+        if (t.prefix == t.leaves.size())
+            grow(t);
+        set_leaf(t, t.prefix, next);
+        ++t.prefix;
+    }
+
+    size_t best       = none;
+    IFloat best_score = -std::numeric_limits<IFloat>::infinity();
+    if (n >= t.prefix)
+    {
+        if (t.prefix > 0)
+        {
+            fix(t, 1, root_ln, ln_parent);
+            best       = t.nodes[1].winner;
+            best_score = score(t.leaves[best], c, ln_parent);
+        }
+    }
+    else
+    {
+        // The choice count shrank below the prefix: scan what is left.
+        for (size_t i = 0; i < n; ++i)
+        {
+            const IFloat s = score(t.leaves[i], c, ln_parent);
+            if (s > best_score)
+            {
+                best_score = s;
+                best       = i;
+            }
+        }
+    }
+
+    ucb_selection chosen;
+    if (has_next && (best == none || unvisited_score > best_score))
+        chosen = {t.prefix, next.v == 0};
+    else
+        chosen = {best, false};
+
+    t.last = chosen.index;
+    return chosen;
+}
+
+template<typename NodeHandle, typename IFloat, typename IGEC, template<typename...> typename Map>
+IFloat ucb_argmax_table<NodeHandle, IFloat, IGEC, Map>::score(
+    const leaf& l, IFloat c, IFloat ln_parent)
+{
+    // Same expression as the engines' scan, so both round alike.
+    return l.exploit + c * std::sqrt(ln_parent / static_cast<IFloat>(l.n));
+}
+
+template<typename NodeHandle, typename IFloat, typename IGEC, template<typename...> typename Map>
+IFloat ucb_argmax_table<NodeHandle, IFloat, IGEC, Map>::expiry(
+    const leaf& w, const leaf& l, IFloat c, IFloat root_ln)
+{
+    // score(w) - score(l) = a - b * sqrt(ln N).  The computed scores compare
+    // like the exact ones while that gap exceeds their rounding, d0 + d1 * sqrt(ln N).
+    const IFloat eps = 16 * std::numeric_limits<IFloat>::epsilon();
+    const IFloat a   = w.exploit - l.exploit;
+    const IFloat b   = c * (l.slope - w.slope);
+    const IFloat d0  = eps * (std::abs(w.exploit) + std::abs(l.exploit));
+    const IFloat d1  = eps * c * (w.slope + l.slope);
+
+    if (a == 0 && b == 0)
+        return std::numeric_limits<IFloat>::infinity();
+    if (a - d0 <= (b + d1) * root_ln)
+        return root_ln;
+    if (b + d1 <= 0)
+        return std::numeric_limits<IFloat>::infinity();
+    return (a - d0) / (b + d1);
+}
+
+template<typename NodeHandle, typename IFloat, typename IGEC, template<typename...> typename Map>
+void ucb_argmax_table<NodeHandle, IFloat, IGEC, Map>::set_leaf(
+    tournament& t, size_t i, const ucb_child<IFloat>& child)
+{
+    const size_t capacity = t.leaves.size();
+    t.leaves[i] = {child.exploit, 1 / std::sqrt(static_cast<IFloat>(child.n)), child.n};
+    t.nodes[capacity + i].winner = i;
+
+    for (size_t j = (capacity + i) / 2; j >= 1; j /= 2)
+        t.nodes[j].expiry = -std::numeric_limits<IFloat>::infinity();
+}
+
+template<typename NodeHandle, typename IFloat, typename IGEC, template<typename...> typename Map>
+void ucb_argmax_table<NodeHandle, IFloat, IGEC, Map>::grow(tournament& t)
+{
+    const size_t capacity = std::max(min_leaves, 2 * t.leaves.size());
+
+    t.leaves.resize(capacity);
+    t.nodes.assign(2 * capacity, {none, std::numeric_limits<IFloat>::infinity()});
+    for (size_t i = 0; i < t.prefix; ++i)
+        t.nodes[capacity + i].winner = i;
+    expire_all(t);
+}
+
+template<typename NodeHandle, typename IFloat, typename IGEC, template<typename...> typename Map>
+void ucb_argmax_table<NodeHandle, IFloat, IGEC, Map>::expire_all(tournament& t)
+{
+    for (size_t j = 1; j < t.leaves.size(); ++j)
+        t.nodes[j].expiry = -std::numeric_limits<IFloat>::infinity();
+}
+
+template<typename NodeHandle, typename IFloat, typename IGEC, template<typename...> typename Map>
+void ucb_argmax_table<NodeHandle, IFloat, IGEC, Map>::fix(
+    tournament& t, size_t j, IFloat root_ln, IFloat ln_parent)
+{
+    // Leaves never expire, so the recursion stops above them.
+    if (t.nodes[j].expiry > root_ln)
+        return;
+
+    fix(t, 2 * j, root_ln, ln_parent);
+    fix(t, 2 * j + 1, root_ln, ln_parent);
+
+    const node&  left      = t.nodes[2 * j];
+    const node&  right     = t.nodes[2 * j + 1];
+    const IFloat inherited = std::min(left.expiry, right.expiry);
+
+    if (right.winner == none || left.winner == none)
+    {
+        t.nodes[j] = {right.winner == none ? left.winner : right.winner, inherited};
+        return;
+    }
+
+    const leaf& l = t.leaves[left.winner];
+    const leaf& r = t.leaves[right.winner];
+    if (score(r, t.c, ln_parent) > score(l, t.c, ln_parent))
+        t.nodes[j] = {right.winner, std::min(inherited, expiry(r, l, t.c, root_ln))};
+    else
+        t.nodes[j] = {left.winner, std::min(inherited, expiry(l, r, t.c, root_ln))};
+}
+
+} // namespace monte_carlo
+
+#endif // UCB_ARGMAX_TABLE_HPP
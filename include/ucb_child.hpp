@@ -0,0 +1,46 @@
+#ifndef UCB_CHILD_HPP
+#define UCB_CHILD_HPP
+
+#include <cstddef>
+
+namespace monte_carlo
+{
+
+// ucb_child<IFloat>, ucb_selection
+//
+// Records exchanged between sim / dbuct and the selection code (select_child()
+// and policies that keep their own per-node state, like ucb_argmax_table).
+// The engine reads one child's statistics as a ucb_child:
+//   exploit: value / visits of the child node (0 when unvisited)
+//   n:       visits in the explore term (edge visits with an edge table)
+//   v:       node visits of the child (0 means selecting it expands it)
+//   squares: sum of squared value deltas of the child node; filled only for
+//            an ISelect that declares needs_squares (ucb1_tuned)
+//   proven:  the child is solved (proof_table) and exploit is its exact value
+//   amaf:    all-moves-as-first mean of the child's choice at the parent and
+//   amaf_n:  its AMAF visits; both filled only for an ISelect with an amaf()
+//            table (rave), 0 otherwise
+// and the selection answers with the chosen child index and whether that
+// child is expanded by this selection (its v was 0).
+
+template<typename IFloat>
+struct ucb_child
+{
+    IFloat exploit;
+    size_t n;
+    size_t v;
+    IFloat squares;
+    bool   proven;
+    IFloat amaf;
+    size_t amaf_n;
+};
+
+struct ucb_selection
+{
+    size_t index;
+    bool   expand;
+};
+
+} // namespace monte_carlo
+
+#endif // UCB_CHILD_HPP
@@ -0,0 +1,28 @@
+#ifndef UNIFORM_PRIOR_HPP
+#define UNIFORM_PRIOR_HPP
+
+#include <cstddef>
+
+namespace monte_carlo
+{
+
+// uniform_prior<IFloat>
+//
+// Concrete IGetPrior implementation: the same prior for every choice of
+// every parent.  With puct this leaves only the visit-count term,
+// c * p * sqrt(N) / (1 + n), to spread the search.
+
+template<typename IFloat>
+struct uniform_prior
+{
+    explicit uniform_prior(IFloat p) : p_(p) {}
+
+    IFloat get_prior(const auto&, size_t) const { return p_; }
+
+private:
+    IFloat p_;
+};
+
+} // namespace monte_carlo
+
+#endif // UNIFORM_PRIOR_HPP
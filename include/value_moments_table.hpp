@@ -0,0 +1,87 @@
+#ifndef VALUE_MOMENTS_TABLE_HPP
+#define VALUE_MOMENTS_TABLE_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+namespace monte_carlo
+{
+
+// value_moments_table<NodeHandle, IFloat, Map>
+//
+// Per-node accumulated reward and accumulated squared reward, keyed by
+// NodeHandle and stored in one record.  Use it in place of value_table when
+// selection needs the reward variance (ucb1_tuned); sim and dbuct add the
+// square of each value delta alongside the delta itself whenever the value
+// table provides the squares accessors.
+//
+// Satisfies:
+//   IGetValue: get_value(const NodeHandle&) -> IFloat          (IFloat{} if unseen)
+//              get_value_squares(const NodeHandle&) -> IFloat  (IFloat{} if unseen)
+//   ISetValue: set_value(const NodeHandle&, IFloat) -> void
+//              set_value_squares(const NodeHandle&, IFloat) -> void
+//
+// Map parameter: as for value_table.
+
+template<
+    typename NodeHandle,
+    typename IFloat,
+    template<typename...> typename Map
+>
+struct value_moments_table
+{
+    struct record
+    {
+        IFloat value;
+        IFloat squares;
+    };
+
+    value_moments_table() = default;
+
+    // Forwards to the Map constructor, e.g. a spill_config for spill_map.
+    template<typename... MapArgs>
+        requires std::constructible_from<Map<NodeHandle, record>, MapArgs...>
+    explicit value_moments_table(MapArgs&&... args)
+        : records_(std::forward<MapArgs>(args)...)
+    {}
+
+    IFloat get_value(const NodeHandle& h) const         { return get(h).value; }
+    IFloat get_value_squares(const NodeHandle& h) const { return get(h).squares; }
+    void   set_value(const NodeHandle& h, IFloat v)         { records_[h].value = v; }
+    void   set_value_squares(const NodeHandle& h, IFloat v) { records_[h].squares = v; }
+
+    // Pre-sizes the Map for n entries when it has reserve(); no-op otherwise.
+    void reserve(size_t n);
+
+private:
+    record get(const NodeHandle& h) const;
+
+    Map<NodeHandle, record> records_;
+};
+
+// ---------------------------------------------------------------------------
+// member function definitions
+// ---------------------------------------------------------------------------
+
+template<typename NodeHandle, typename IFloat, template<typename...> typename Map>
+typename value_moments_table<NodeHandle, IFloat, Map>::record
+value_moments_table<NodeHandle, IFloat, Map>::get(const NodeHandle& h) const
+{
+    auto it = records_.find(h);
+    if (it == records_.end()) return {};
+    return it->second;
+}
+
+template<typename NodeHandle, typename IFloat, template<typename...> typename Map>
+void value_moments_table<NodeHandle, IFloat, Map>::reserve(size_t n)
+{
+    if constexpr (requires { records_.reserve(n); })
+        records_.reserve(n);
+}
+
+} // namespace monte_carlo
+
+#endif // VALUE_MOMENTS_TABLE_HPP
@@ -1,8 +1,10 @@
 #ifndef VALUE_TABLE_HPP
 #define VALUE_TABLE_HPP
 
+#include <concepts>
 #include <map>
 #include <unordered_map>
+#include <utility>
 
 namespace monte_carlo
 {
@@ -18,6 +20,11 @@ namespace monte_carlo
 // Map parameter:
 //   value_table<int, double, std::map>           — ordered
 //   value_table<int, double, std::unordered_map> — hash map
+//   value_table<int, double, spill_map>          — out-of-core, see spill_map.hpp
+//   value_table<int, double, incremental_hash_map> — no rehash stalls, see incremental_hash_map.hpp
+//   value_table<int, double, std::pmr::unordered_map>
+//                                                — allocator-aware; construct with a
+//                                                  std::pmr::memory_resource*, see search_arena.hpp
 
 template<
     typename NodeHandle,
@@ -26,9 +33,32 @@ template<
 >
 struct value_table
 {
+    value_table() = default;
+
+    // Forwards to the Map constructor, e.g. a spill_config for spill_map.
+    template<typename... MapArgs>
+        requires std::constructible_from<Map<NodeHandle, IFloat>, MapArgs...>
+    explicit value_table(MapArgs&&... args);
+
     IFloat get_value(const NodeHandle& h) const;
     void   set_value(const NodeHandle& h, IFloat v);
 
+    // Pre-sizes the Map for n entries when it has reserve(); no-op otherwise.
+    void reserve(size_t n);
+
+    // Cache hint for a lookup of h soon after; only when the Map has
+    // prefetch() (incremental_hash_map).  sim / dbuct issue it for every
+    // child before scoring.
+    void prefetch(const NodeHandle& h) const
+        requires requires (const Map<NodeHandle, IFloat>& m) { m.prefetch(h); }
+    {
+        values_.prefetch(h);
+    }
+
+    // Calls f(handle, IFloat) for every entry written so far (Map iteration order).
+    template<typename F>
+    void for_each(F&& f) const;
+
 private:
     Map<NodeHandle, IFloat> values_;
 };
@@ -37,6 +67,13 @@ private:
 // member function definitions
 // ---------------------------------------------------------------------------
 
+template<typename NodeHandle, typename IFloat, template<typename...> typename Map>
+template<typename... MapArgs>
+    requires std::constructible_from<Map<NodeHandle, IFloat>, MapArgs...>
+value_table<NodeHandle, IFloat, Map>::value_table(MapArgs&&... args)
+    : values_(std::forward<MapArgs>(args)...)
+{}
+
 template<typename NodeHandle, typename IFloat, template<typename...> typename Map>
 IFloat value_table<NodeHandle, IFloat, Map>::get_value(const NodeHandle& h) const
 {
@@ -51,6 +88,21 @@ void value_table<NodeHandle, IFloat, Map>::set_value(const NodeHandle& h, IFloat
     values_[h] = v;
 }
 
+template<typename NodeHandle, typename IFloat, template<typename...> typename Map>
+void value_table<NodeHandle, IFloat, Map>::reserve(size_t n)
+{
+    if constexpr (requires { values_.reserve(n); })
+        values_.reserve(n);
+}
+
+template<typename NodeHandle, typename IFloat, template<typename...> typename Map>
+template<typename F>
+void value_table<NodeHandle, IFloat, Map>::for_each(F&& f) const
+{
+    for (const auto& [h, v] : values_)
+        f(h, v);
+}
+
 } // namespace monte_carlo
 
 #endif // VALUE_TABLE_HPP
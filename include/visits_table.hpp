@@ -2,13 +2,16 @@
 #define VISITS_TABLE_HPP
 
 #include <cstddef>
+#include <concepts>
+#include <limits>
 #include <map>
 #include <unordered_map>
+#include <utility>
 
 namespace monte_carlo
 {
 
-// visits_table<NodeHandle, Map>
+// visits_table<NodeHandle, Map, Counter>
 //
 // Per-node visit counter, keyed by NodeHandle.
 //
@@ -19,36 +22,102 @@ namespace monte_carlo
 // Map parameter:
 //   visits_table<int, std::map>           — ordered
 //   visits_table<int, std::unordered_map> — hash map, requires std::hash<NodeHandle>
+//   visits_table<int, spill_map>          — out-of-core, see spill_map.hpp
+//   visits_table<int, incremental_hash_map> — no rehash stalls, see incremental_hash_map.hpp
+//   visits_table<int, std::pmr::unordered_map>
+//                                         — allocator-aware; construct with a
+//                                           std::pmr::memory_resource*, see search_arena.hpp
+//
+// Counter parameter (default size_t): stored counter width, e.g.
+//   visits_table<int, std::unordered_map, uint32_t>
+// halves the per-entry payload.  Writes above the Counter range saturate at
+// its maximum instead of wrapping, and saturated() reports that it happened;
+// a saturated count never reads back as 0, so an engine never mistakes a
+// heavily visited node for an unexpanded one.
 
 template<
     typename NodeHandle,
-    template<typename...> typename Map
+    template<typename...> typename Map,
+    typename Counter = size_t
 >
 struct visits_table
 {
+    visits_table() = default;
+
+    // Forwards to the Map constructor, e.g. a spill_config for spill_map.
+    template<typename... MapArgs>
+        requires std::constructible_from<Map<NodeHandle, Counter>, MapArgs...>
+    explicit visits_table(MapArgs&&... args);
+
     size_t get_visits(const NodeHandle& h) const;
     void   set_visits(const NodeHandle& h, size_t v);
 
+    // Pre-sizes the Map for n entries when it has reserve(); no-op otherwise.
+    void reserve(size_t n);
+
+    // Cache hint for a lookup of h soon after; only when the Map has
+    // prefetch() (incremental_hash_map).  sim / dbuct issue it for every
+    // child before scoring.
+    void prefetch(const NodeHandle& h) const
+        requires requires (const Map<NodeHandle, Counter>& m) { m.prefetch(h); }
+    {
+        visits_.prefetch(h);
+    }
+
+    // Calls f(handle, size_t) for every entry written so far (Map iteration order).
+    template<typename F>
+    void for_each(F&& f) const;
+
+    bool saturated() const { return saturated_; }
+
 private:
-    Map<NodeHandle, size_t> visits_;
+    Map<NodeHandle, Counter> visits_;
+    bool                     saturated_ = false;
 };
 
 // ---------------------------------------------------------------------------
 // member function definitions
 // ---------------------------------------------------------------------------
 
-template<typename NodeHandle, template<typename...> typename Map>
-size_t visits_table<NodeHandle, Map>::get_visits(const NodeHandle& h) const
+template<typename NodeHandle, template<typename...> typename Map, typename Counter>
+template<typename... MapArgs>
+    requires std::constructible_from<Map<NodeHandle, Counter>, MapArgs...>
+visits_table<NodeHandle, Map, Counter>::visits_table(MapArgs&&... args)
+    : visits_(std::forward<MapArgs>(args)...)
+{}
+
+template<typename NodeHandle, template<typename...> typename Map, typename Counter>
+size_t visits_table<NodeHandle, Map, Counter>::get_visits(const NodeHandle& h) const
 {
     auto it = visits_.find(h);
     if (it == visits_.end()) return 0;
     return it->second;
 }
 
-template<typename NodeHandle, template<typename...> typename Map>
-void visits_table<NodeHandle, Map>::set_visits(const NodeHandle& h, size_t v)
+template<typename NodeHandle, template<typename...> typename Map, typename Counter>
+void visits_table<NodeHandle, Map, Counter>::set_visits(const NodeHandle& h, size_t v)
+{
+    if (v > std::numeric_limits<Counter>::max())
+    {
+        v          = std::numeric_limits<Counter>::max();
+        saturated_ = true;
+    }
+    visits_[h] = static_cast<Counter>(v);
+}
+
+template<typename NodeHandle, template<typename...> typename Map, typename Counter>
+void visits_table<NodeHandle, Map, Counter>::reserve(size_t n)
+{
+    if constexpr (requires { visits_.reserve(n); })
+        visits_.reserve(n);
+}
+
+template<typename NodeHandle, template<typename...> typename Map, typename Counter>
+template<typename F>
+void visits_table<NodeHandle, Map, Counter>::for_each(F&& f) const
 {
-    visits_[h] = v;
+    for (const auto& [h, v] : visits_)
+        f(h, v);
 }
 
 } // namespace monte_carlo
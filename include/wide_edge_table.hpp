@@ -0,0 +1,190 @@
+#ifndef WIDE_EDGE_TABLE_HPP
+#define WIDE_EDGE_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "hash_mix.hpp"
+#include "incremental_hash_map.hpp"
+
+namespace monte_carlo
+{
+
+// wide_edge_table<NodeHandle, Hash>
+//
+// Edge-visit counter keyed on the full (parent, child) pair.  Unlike
+// int_edge_unordered_table, which packs two 32-bit handles into one uint64,
+// both handles are stored whole (128 bits for uint64_t handles, the handle
+// objects themselves for any other type), so distinct edges never alias.
+// Storage is an incremental_hash_map: open addressing, no per-edge node
+// allocation, and no rehash stall when it grows.
+//
+// Fulfils IEdgeVisits for sim / dbuct:
+//   get_edge_visits(const NodeHandle& parent, const NodeHandle& child) -> size_t
+//   set_edge_visits(const NodeHandle& parent, const NodeHandle& child, size_t) -> void
+//
+// Zero-default contract: returns 0 for any edge never written.
+
+template<
+    typename NodeHandle,
+    typename Hash = std::hash<NodeHandle>
+>
+struct wide_edge_table
+{
+    size_t get_edge_visits(const NodeHandle& parent, const NodeHandle& child) const;
+    void   set_edge_visits(const NodeHandle& parent, const NodeHandle& child, size_t v);
+
+    void   reserve(size_t n) { edges_.reserve(n); }
+    size_t size() const      { return edges_.size(); }
+
+private:
+    struct edge
+    {
+        NodeHandle parent;
+        NodeHandle child;
+
+        bool operator==(const edge&) const = default;
+    };
+
+    struct edge_hash
+    {
+        size_t operator()(const edge& e) const
+        {
+            Hash h;
+            return hash_mix(h(e.parent)) ^ h(e.child);
+        }
+    };
+
+    incremental_hash_map<edge, size_t, edge_hash> edges_;
+};
+
+// parent_edge_table<NodeHandle, Hash>
+//
+// Edge-visit counter that keeps all edges of one parent contiguous: each
+// parent owns a block of child handles and a parallel block of counts, so a
+// selection loop can fetch edges(parent) once and scan the counts as a plain
+// array instead of issuing one hash lookup per child.
+//
+//   auto e = edges.edges(parent);
+//   for (size_t i = 0; i < e.size; ++i)  ... e.children[i], e.counts[i] ...
+//
+// Fulfils IEdgeVisits like wide_edge_table.  get_edge_visits() scans the
+// parent's block linearly, which suits the tens-to-hundreds of children a
+// node typically has.  A block that fills up is moved to the end of the
+// arrays with twice the capacity; the old space is not reused, which costs at
+// most as much again as the live blocks.  Pointers from edges() are
+// invalidated by the next set_edge_visits().
+
+template<
+    typename NodeHandle,
+    typename Hash = std::hash<NodeHandle>
+>
+struct parent_edge_table
+{
+    struct edge_span
+    {
+        const NodeHandle* children;
+        const size_t*     counts;
+        size_t            size;
+    };
+
+    size_t    get_edge_visits(const NodeHandle& parent, const NodeHandle& child) const;
+    void      set_edge_visits(const NodeHandle& parent, const NodeHandle& child, size_t v);
+    edge_span edges(const NodeHandle& parent) const;
+
+    size_t parents() const { return blocks_.size(); }
+
+private:
+    static constexpr size_t initial_block = 4;
+
+    struct block
+    {
+        size_t offset;
+        size_t size;
+        size_t capacity;
+    };
+
+    incremental_hash_map<NodeHandle, block, Hash> blocks_;
+    std::vector<NodeHandle>                       children_;
+    std::vector<size_t>                           counts_;
+};
+
+// ---------------------------------------------------------------------------
+// member function definitions
+// ---------------------------------------------------------------------------
+
+template<typename NodeHandle, typename Hash>
+size_t wide_edge_table<NodeHandle, Hash>::get_edge_visits(
+    const NodeHandle& parent, const NodeHandle& child) const
+{
+    auto it = edges_.find({parent, child});
+    return it == edges_.end() ? 0 : it->second;
+}
+
+template<typename NodeHandle, typename Hash>
+void wide_edge_table<NodeHandle, Hash>::set_edge_visits(
+    const NodeHandle& parent, const NodeHandle& child, size_t v)
+{
+    edges_[{parent, child}] = v;
+}
+
+template<typename NodeHandle, typename Hash>
+size_t parent_edge_table<NodeHandle, Hash>::get_edge_visits(
+    const NodeHandle& parent, const NodeHandle& child) const
+{
+    const edge_span e = edges(parent);
+    for (size_t i = 0; i < e.size; ++i)
+        if (e.children[i] == child)
+            return e.counts[i];
+    return 0;
+}
+
+template<typename NodeHandle, typename Hash>
+void parent_edge_table<NodeHandle, Hash>::set_edge_visits(
+    const NodeHandle& parent, const NodeHandle& child, size_t v)
+{
+    block& b = blocks_[parent];
+    for (size_t i = b.offset; i < b.offset + b.size; ++i)
+        if (children_[i] == child)
+        {
+            counts_[i] = v;
+            return;
+        }
+
+    if (b.size == b.capacity)
+    {
+        const size_t capacity = b.capacity == 0 ? initial_block : 2 * b.capacity;
+        const size_t offset   = children_.size();
+        children_.resize(offset + capacity);
+        counts_.resize(offset + capacity);
+        for (size_t i = 0; i < b.size; ++i)
+        {
+            children_[offset + i] = children_[b.offset + i];
+            counts_[offset + i]   = counts_[b.offset + i];
+        }
+        b.offset   = offset;
+        b.capacity = capacity;
+    }
+
+    children_[b.offset + b.size] = child;
+    counts_[b.offset + b.size]   = v;
+    ++b.size;
+}
+
+template<typename NodeHandle, typename Hash>
+typename parent_edge_table<NodeHandle, Hash>::edge_span
+parent_edge_table<NodeHandle, Hash>::edges(const NodeHandle& parent) const
+{
+    auto it = blocks_.find(parent);
+    if (it == blocks_.end())
+        return {nullptr, nullptr, 0};
+
+    const block& b = it->second;
+    return {children_.data() + b.offset, counts_.data() + b.offset, b.size};
+}
+
+} // namespace monte_carlo
+
+#endif // WIDE_EDGE_TABLE_HPP
@@ -0,0 +1,3047 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <new>
+#include <numeric>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <malloc.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "hash_mix.hpp"
+#include "mcts.hpp"
+
+// Benchmarks for table backends and engine options.
+//
+//   make bench                    runs every benchmark
+//   ./build/mcts_bench spill      runs the named benchmark(s) only
+//
+// Figures are wall-clock on whatever machine runs them; compare rows within
+// one run, not across machines.
+
+// ---------------------------------------------------------------------------
+// Heap accounting: every global new/delete in this binary is counted so the
+// benchmarks can report allocation counts and live bytes.
+// ---------------------------------------------------------------------------
+
+namespace
+{
+
+std::atomic<size_t> g_alloc_count{0};
+std::atomic<size_t> g_live_bytes{0};
+
+void* counted_alloc(size_t n, size_t align = alignof(std::max_align_t))
+{
+    void* p = align <= alignof(std::max_align_t)
+            ? std::malloc(n ? n : 1)
+            : std::aligned_alloc(align, (n + align - 1) / align * align);
+    if (!p)
+        throw std::bad_alloc();
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    g_live_bytes.fetch_add(malloc_usable_size(p), std::memory_order_relaxed);
+    return p;
+}
+
+void counted_free(void* p)
+{
+    if (!p)
+        return;
+    g_live_bytes.fetch_sub(malloc_usable_size(p), std::memory_order_relaxed);
+    std::free(p);
+}
+
+} // namespace
+
+void* operator new(size_t n)                  { return counted_alloc(n); }
+void* operator new[](size_t n)                { return counted_alloc(n); }
+void  operator delete(void* p) noexcept       { counted_free(p); }
+void  operator delete[](void* p) noexcept     { counted_free(p); }
+void  operator delete(void* p, size_t) noexcept   { counted_free(p); }
+void  operator delete[](void* p, size_t) noexcept { counted_free(p); }
+
+void* operator new(size_t n, std::align_val_t a)   { return counted_alloc(n, static_cast<size_t>(a)); }
+void* operator new[](size_t n, std::align_val_t a) { return counted_alloc(n, static_cast<size_t>(a)); }
+void  operator delete(void* p, std::align_val_t) noexcept           { counted_free(p); }
+void  operator delete[](void* p, std::align_val_t) noexcept         { counted_free(p); }
+void  operator delete(void* p, size_t, std::align_val_t) noexcept   { counted_free(p); }
+void  operator delete[](void* p, size_t, std::align_val_t) noexcept { counted_free(p); }
+
+namespace
+{
+
+using clock_type = std::chrono::steady_clock;
+
+// Results of timed loops are stored here so the loops are not optimised away.
+volatile double g_sink;
+
+double seconds_since(clock_type::time_point t0)
+{
+    return std::chrono::duration<double>(clock_type::now() - t0).count();
+}
+
+// Synthetic game with 64-bit hashed node handles: every (parent, choice)
+// pair is a fresh node, so the tree grows by one node per simulation and
+// quickly outgrows any cache.  Reward is a fixed pseudo-random function of
+// the leaf reached after `depth` moves.
+struct hashed_walker
+{
+    uint64_t walk(const uint64_t& node, int choice) const
+    {
+        return monte_carlo::hash_mix(node * 31 + static_cast<uint64_t>(choice) + 1);
+    }
+};
+
+struct hashed_game
+{
+    size_t           depth;
+    std::vector<int> choices;
+
+    hashed_game(size_t depth, int branching) : depth(depth), choices(branching)
+    {
+        for (int i = 0; i < branching; ++i)
+            choices[i] = i;
+    }
+
+    static double reward(uint64_t leaf)
+    {
+        return static_cast<double>(monte_carlo::hash_mix(leaf) % 1000) / 1000.0;
+    }
+};
+
+// Runs one sim episode of hashed_game against the given tables.
+template<typename IVisits, typename IValue>
+void hashed_sim_episode(IVisits&           visits,
+                        IValue&            value,
+                        const hashed_game& game,
+                        std::mt19937&      rng,
+                        double             c)
+{
+    using rollout_t = monte_carlo::random_rollout<
+                         int, std::mt19937, std::vector<int>, std::vector<int>>;
+
+    rollout_t     rollout(rng);
+    hashed_walker walker;
+    monte_carlo::uniform_value_delta<double>          delta;
+    monte_carlo::uniform_exploration_constant<double> ec(c);
+
+    monte_carlo::sim<
+        uint64_t, int, double,
+        IVisits, IValue, IVisits, IValue,
+        hashed_walker,
+        std::vector<int>, std::vector<int>,
+        rollout_t,
+        monte_carlo::uniform_value_delta<double>,
+        monte_carlo::uniform_exploration_constant<double>
+    > s(visits, value, visits, value, walker, rollout, delta, ec, 0);
+
+    uint64_t node = 0;
+    for (size_t d = 0; d < game.depth; ++d)
+        node = walker.walk(node, s.choose(game.choices, game.choices));
+
+    delta.set_value(hashed_game::reward(node));
+    s.terminate();
+}
+
+// ---------------------------------------------------------------------------
+// spill: sim throughput as the tree grows past spill_map's in-memory limit.
+// ---------------------------------------------------------------------------
+
+template<typename IVisits, typename IValue>
+void spill_rows(const char* label, IVisits& visits, IValue& value,
+                size_t windows, size_t window_sims)
+{
+    const hashed_game game(12, 8);
+    std::mt19937      rng(1);
+
+    for (size_t w = 0; w < windows; ++w)
+    {
+        const auto t0 = clock_type::now();
+        for (size_t i = 0; i < window_sims; ++i)
+            hashed_sim_episode(visits, value, game, rng, 1.0);
+        const double dt = seconds_since(t0);
+
+        std::cout << "  " << std::left << std::setw(16) << label << std::right
+                  << "nodes~" << std::setw(9) << (w + 1) * window_sims
+                  << "  " << std::setw(10) << std::fixed << std::setprecision(0)
+                  << static_cast<double>(window_sims) / dt << " sims/s\n";
+    }
+}
+
+void bench_spill()
+{
+    constexpr size_t windows     = 8;
+    constexpr size_t window_sims = 100000;
+    constexpr size_t hot         = 200000;
+
+    std::cout << "spill: sim throughput vs tree size (hot_capacity=" << hot
+              << " per table, depth 12, branching 8)\n";
+
+    {
+        monte_carlo::visits_table<uint64_t, std::unordered_map>       visits;
+        monte_carlo::value_table<uint64_t, double, std::unordered_map> value;
+        spill_rows("unordered_map", visits, value, windows, window_sims);
+    }
+    {
+        const monte_carlo::spill_config cfg{.hot_capacity = hot, .cold_buckets = 1 << 12};
+        monte_carlo::visits_table<uint64_t, monte_carlo::spill_map>       visits(cfg);
+        monte_carlo::value_table<uint64_t, double, monte_carlo::spill_map> value(cfg);
+        spill_rows("spill_map", visits, value, windows, window_sims);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// freeze: memory and lookup cost of frozen_stats_table vs the unordered tables
+// it was built from.
+// ---------------------------------------------------------------------------
+
+void bench_freeze()
+{
+    constexpr size_t n       = 1000000;
+    constexpr size_t lookups = 10000000;
+
+    std::mt19937                          rng(2);
+    std::uniform_int_distribution<size_t> visit_dist(1, 100000);
+    std::vector<int>                      handles(n);
+    for (size_t i = 0; i < n; ++i)
+        handles[i] = static_cast<int>(monte_carlo::hash_mix(i) >> 33);
+
+    const size_t live0 = g_live_bytes.load();
+    auto* visits = new monte_carlo::visits_table<int, std::unordered_map>;
+    auto* value  = new monte_carlo::value_table<int, double, std::unordered_map>;
+    for (int h : handles)
+    {
+        const size_t v = visit_dist(rng);
+        visits->set_visits(h, v);
+        value->set_value(h, static_cast<double>(v) * 0.25);
+    }
+    const size_t unordered_bytes = g_live_bytes.load() - live0;
+
+    const auto t0     = clock_type::now();
+    const auto frozen = monte_carlo::freeze<int, double>(*visits, *value);
+    const double build = seconds_since(t0);
+
+    std::vector<int> probe(lookups);
+    for (size_t i = 0; i < lookups; ++i)
+        probe[i] = handles[monte_carlo::hash_mix(i + 7) % n];
+
+    auto time_lookups = [&](const auto& v, const auto& w)
+    {
+        double     sink = 0;
+        const auto t    = clock_type::now();
+        for (int h : probe)
+            sink += static_cast<double>(v.get_visits(h)) + w.get_value(h);
+        const double dt = seconds_since(t);
+        g_sink          = sink;
+        return dt * 1e9 / static_cast<double>(lookups);
+    };
+
+    const double unordered_ns = time_lookups(*visits, *value);
+    const double frozen_ns    = time_lookups(frozen, frozen);
+
+    std::cout << "freeze: " << n << " int handles, " << lookups
+              << " random get_visits+get_value pairs\n"
+              << std::fixed << std::setprecision(1)
+              << "  unordered tables  " << std::setw(8) << unordered_bytes / 1048576.0 << " MiB  "
+              << std::setw(6) << unordered_ns << " ns/lookup\n"
+              << "  frozen            " << std::setw(8) << frozen.memory_bytes() / 1048576.0 << " MiB  "
+              << std::setw(6) << frozen_ns << " ns/lookup  (built in "
+              << std::setprecision(2) << build << " s)\n";
+
+    delete visits;
+    delete value;
+}
+
+// ---------------------------------------------------------------------------
+// compact: bytes per node and sim throughput, visits_table + value_table vs
+// compact_stats_table (uint32_t visits, float value in one record).
+// ---------------------------------------------------------------------------
+
+template<typename IVisits, typename IValue>
+void compact_row(const char* label, IVisits& visits, IValue& value, size_t live0)
+{
+    constexpr size_t  sims = 500000;
+    const hashed_game game(12, 8);
+    std::mt19937      rng(3);
+
+    const auto t0 = clock_type::now();
+    for (size_t i = 0; i < sims; ++i)
+        hashed_sim_episode(visits, value, game, rng, 1.0);
+    const double dt = seconds_since(t0);
+
+    size_t nodes = 0;
+    visits.for_each([&](const uint64_t&, size_t) { ++nodes; });
+
+    std::cout << "  " << std::left << std::setw(22) << label << std::right
+              << std::setw(8) << nodes << " nodes  "
+              << std::fixed << std::setprecision(1) << std::setw(6)
+              << static_cast<double>(g_live_bytes.load() - live0) / static_cast<double>(nodes)
+              << " B/node  " << std::setprecision(0) << std::setw(8)
+              << static_cast<double>(sims) / dt << " sims/s\n";
+}
+
+void bench_compact()
+{
+    std::cout << "compact: 500000 sims, depth 12, branching 8\n";
+    {
+        const size_t live0 = g_live_bytes.load();
+        monte_carlo::visits_table<uint64_t, std::unordered_map>        visits;
+        monte_carlo::value_table<uint64_t, double, std::unordered_map> value;
+        compact_row("visits + value tables", visits, value, live0);
+    }
+    {
+        const size_t live0 = g_live_bytes.load();
+        monte_carlo::compact_stats_table<uint64_t, double, std::unordered_map> stats;
+        compact_row("compact_stats_table", stats, stats, live0);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// arena: heap allocations during a search and teardown time, default-heap
+// tables vs pmr tables on a search_arena released in one call.  Also run with
+// path handles (vector<int> keys), where each stored key is one more block.
+// ---------------------------------------------------------------------------
+
+template<typename Path>
+struct bench_path_hash
+{
+    size_t operator()(const Path& p) const noexcept
+    {
+        uint64_t h = p.size();
+        for (int x : p)
+            h = monte_carlo::hash_mix(h ^ static_cast<uint64_t>(x));
+        return h;
+    }
+};
+
+template<typename K, typename V>
+using std_path_map = std::unordered_map<K, V, bench_path_hash<K>>;
+
+template<typename K, typename V>
+using pmr_path_map = std::pmr::unordered_map<K, V, bench_path_hash<K>>;
+
+template<typename Path>
+struct bench_path_walker
+{
+    Path walk(const Path& p, int choice) const
+    {
+        Path child = p;
+        child.push_back(choice);
+        return child;
+    }
+};
+
+template<typename Path, typename IVisits, typename IValue>
+void path_sim_episode(IVisits& visits, IValue& value, const hashed_game& game, std::mt19937& rng)
+{
+    using rollout_t = monte_carlo::random_rollout<
+                         int, std::mt19937, std::vector<int>, std::vector<int>>;
+
+    rollout_t               rollout(rng);
+    bench_path_walker<Path> walker;
+    monte_carlo::uniform_value_delta<double>          delta;
+    monte_carlo::uniform_exploration_constant<double> ec(1.0);
+
+    monte_carlo::sim<
+        Path, int, double,
+        IVisits, IValue, IVisits, IValue,
+        bench_path_walker<Path>,
+        std::vector<int>, std::vector<int>,
+        rollout_t,
+        monte_carlo::uniform_value_delta<double>,
+        monte_carlo::uniform_exploration_constant<double>
+    > s(visits, value, visits, value, walker, rollout, delta, ec, Path{});
+
+    uint64_t leaf = 0;
+    for (size_t d = 0; d < game.depth; ++d)
+        leaf = leaf * 31 + static_cast<uint64_t>(s.choose(game.choices, game.choices));
+
+    delta.set_value(hashed_game::reward(leaf));
+    s.terminate();
+}
+
+void arena_row(const char* label, size_t sims, size_t allocs, double search_s, double teardown_s)
+{
+    std::cout << "  " << std::left << std::setw(30) << label << std::right
+              << std::fixed << std::setprecision(2) << std::setw(7)
+              << static_cast<double>(allocs) / static_cast<double>(sims) << " allocs/sim  "
+              << std::setprecision(0) << std::setw(8) << static_cast<double>(sims) / search_s
+              << " sims/s  teardown " << std::setprecision(2) << std::setw(7)
+              << teardown_s * 1e3 << " ms\n";
+}
+
+template<typename IVisits, typename IValue, typename Episode>
+void arena_heap_row(const char* label, size_t sims, Episode episode)
+{
+    std::mt19937 rng(4);
+    auto*        visits = new IVisits;
+    auto*        value  = new IValue;
+
+    const size_t a0 = g_alloc_count.load();
+    const auto   t0 = clock_type::now();
+    for (size_t i = 0; i < sims; ++i)
+        episode(*visits, *value, rng);
+    const double search = seconds_since(t0);
+    const size_t allocs = g_alloc_count.load() - a0;
+
+    const auto t1 = clock_type::now();
+    delete visits;
+    delete value;
+    arena_row(label, sims, allocs, search, seconds_since(t1));
+}
+
+template<typename IVisits, typename IValue, typename Episode>
+void arena_pmr_row(const char* label, size_t sims, Episode episode)
+{
+    std::mt19937              rng(4);
+    monte_carlo::search_arena arena;
+    auto& visits = arena.make<IVisits>(arena.resource());
+    auto& value  = arena.make<IValue>(arena.resource());
+
+    const size_t a0 = g_alloc_count.load();
+    const auto   t0 = clock_type::now();
+    for (size_t i = 0; i < sims; ++i)
+        episode(visits, value, rng);
+    const double search = seconds_since(t0);
+    const size_t allocs = g_alloc_count.load() - a0;
+
+    const auto t1 = clock_type::now();
+    arena.release();
+    arena_row(label, sims, allocs, search, seconds_since(t1));
+}
+
+void bench_arena()
+{
+    constexpr size_t  sims = 500000;
+    const hashed_game game(12, 8);
+
+    std::cout << "arena: " << sims << " sims, depth 12, branching 8\n";
+
+    auto hashed = [&](auto& visits, auto& value, std::mt19937& rng)
+    { hashed_sim_episode(visits, value, game, rng, 1.0); };
+
+    arena_heap_row<monte_carlo::visits_table<uint64_t, std::unordered_map>,
+                   monte_carlo::value_table<uint64_t, double, std::unordered_map>>(
+        "uint64 handles, default heap", sims, hashed);
+    arena_pmr_row<monte_carlo::visits_table<uint64_t, std::pmr::unordered_map>,
+                  monte_carlo::value_table<uint64_t, double, std::pmr::unordered_map>>(
+        "uint64 handles, search_arena", sims, hashed);
+
+    using std_path = std::vector<int>;
+    using pmr_path = std::pmr::vector<int>;
+
+    arena_heap_row<monte_carlo::visits_table<std_path, std_path_map>,
+                   monte_carlo::value_table<std_path, double, std_path_map>>(
+        "path handles, default heap", sims,
+        [&](auto& visits, auto& value, std::mt19937& rng)
+        { path_sim_episode<std_path>(visits, value, game, rng); });
+
+    // Handles created by the walker and copied into sim's path are
+    // short-lived: route them to a recycling pool via the default resource,
+    // while the handles stored in the tables go to the arena.
+    std::pmr::unsynchronized_pool_resource pool;
+    std::pmr::memory_resource*             previous = std::pmr::set_default_resource(&pool);
+    arena_pmr_row<monte_carlo::visits_table<pmr_path, pmr_path_map>,
+                  monte_carlo::value_table<pmr_path, double, pmr_path_map>>(
+        "path handles, arena + pool", sims,
+        [&](auto& visits, auto& value, std::mt19937& rng)
+        { path_sim_episode<pmr_path>(visits, value, game, rng); });
+    std::pmr::set_default_resource(previous);
+}
+
+// ---------------------------------------------------------------------------
+// latency: per-simulation time percentiles while the tree grows, showing the
+// rehash stalls of std::unordered_map against incremental_hash_map, each with
+// and without reserve() up front.
+// ---------------------------------------------------------------------------
+
+template<typename IVisits, typename IValue>
+void latency_row(const char* label, size_t sims, size_t reserve)
+{
+    IVisits visits;
+    IValue  value;
+    if (reserve > 0)
+    {
+        visits.reserve(reserve);
+        value.reserve(reserve);
+    }
+
+    const hashed_game   game(12, 8);
+    std::mt19937        rng(1);
+    std::vector<double> micros(sims);
+
+    for (size_t i = 0; i < sims; ++i)
+    {
+        const auto t0 = clock_type::now();
+        hashed_sim_episode(visits, value, game, rng, 1.0);
+        micros[i] = seconds_since(t0) * 1e6;
+    }
+    std::sort(micros.begin(), micros.end());
+
+    auto pct = [&](double p) { return micros[static_cast<size_t>(p * (sims - 1))]; };
+
+    std::cout << "  " << std::left << std::setw(30) << label << std::right
+              << std::fixed << std::setprecision(1)
+              << "p50 " << std::setw(6) << pct(0.50)
+              << "  p99 " << std::setw(6) << pct(0.99)
+              << "  p999 " << std::setw(7) << pct(0.999)
+              << "  max " << std::setw(9) << micros.back() << " us\n";
+}
+
+void bench_latency()
+{
+    constexpr size_t sims = 1000000;
+
+    std::cout << "latency: per-sim time over " << sims
+              << " sims, depth 12, branching 8 (one new node per sim)\n";
+
+    using std_visits = monte_carlo::visits_table<uint64_t, std::unordered_map>;
+    using std_value  = monte_carlo::value_table<uint64_t, double, std::unordered_map>;
+    using inc_visits = monte_carlo::visits_table<uint64_t, monte_carlo::incremental_hash_map>;
+    using inc_value  = monte_carlo::value_table<uint64_t, double, monte_carlo::incremental_hash_map>;
+
+    latency_row<std_visits, std_value>("unordered_map", sims, 0);
+    latency_row<std_visits, std_value>("unordered_map, reserve", sims, 2 * sims);
+    latency_row<inc_visits, inc_value>("incremental_hash_map", sims, 0);
+    latency_row<inc_visits, inc_value>("incremental_hash_map, reserve", sims, 2 * sims);
+}
+
+// ---------------------------------------------------------------------------
+// edges: convergence per simulation on the int-handle track game, whose
+// position handles form a DAG (many jump sequences reach one position).
+// Node-only UCB1 vs edge-visit-aware selection, for sim and dbuct.  A run
+// counts as solved at a checkpoint when the greedy walk over node means
+// scores the optimal last-position reward.
+// ---------------------------------------------------------------------------
+
+struct track_game
+{
+    std::vector<double> track;
+    std::vector<int>    jumps;
+
+    track_game(unsigned seed, size_t length, std::vector<int> jumps)
+        : track(length), jumps(std::move(jumps))
+    {
+        std::mt19937                           rng(seed);
+        std::uniform_real_distribution<double> urd(-10, 10);
+        std::generate(track.begin(), track.end(), [&] { return urd(rng); });
+    }
+
+    int size() const { return static_cast<int>(track.size()); }
+
+    // Best reward over all jump sequences from position -1.
+    double optimal() const
+    {
+        std::vector<double> dp(track.size(), -std::numeric_limits<double>::infinity());
+        for (int pos = size() - 1; pos >= 0; --pos)
+            for (int j : jumps)
+                dp[pos] = std::max(dp[pos], pos + j >= size() ? track[pos] : dp[pos + j]);
+
+        double best = -std::numeric_limits<double>::infinity();
+        for (int j : jumps)
+            if (j - 1 < size())
+                best = std::max(best, dp[j - 1]);
+        return best;
+    }
+};
+
+// Leaving the track from position p ends at terminal handle size + 1 + p, so
+// each terminal keeps the reward of the position it was reached from.
+struct track_walker
+{
+    int size;
+
+    int walk(const int& node, int j) const { return node + j < size ? node + j : size + 1 + node; }
+};
+
+bool   track_terminal(const track_game& game, int h) { return h >= game.size(); }
+double track_reward(const track_game& game, int h)
+{
+    return h > game.size() ? game.track[h - game.size() - 1] : 0.0;
+}
+
+// Greedy walk over node means from the root; returns its reward.
+template<typename IVisits, typename IValue>
+double track_greedy(const track_game& game, const IVisits& visits, const IValue& value)
+{
+    const track_walker walker{game.size()};
+
+    int h = -1;
+    while (!track_terminal(game, h))
+    {
+        double best_mean = -std::numeric_limits<double>::infinity();
+        int    best      = walker.walk(h, game.jumps.front());
+        for (int j : game.jumps)
+        {
+            const int    child = walker.walk(h, j);
+            const size_t v     = visits.get_visits(child);
+            if (v > 0 && value.get_value(child) / static_cast<double>(v) > best_mean)
+            {
+                best_mean = value.get_value(child) / static_cast<double>(v);
+                best      = child;
+            }
+        }
+        h = best;
+    }
+    return track_reward(game, h);
+}
+
+// Plays one episode from handle h until a terminal handle, calling
+// on_tree(h) for every handle dbuct selected in the tree.
+template<typename Engine, typename OnTree>
+void track_episode(Engine& engine, monte_carlo::uniform_value_delta<double>& delta,
+                   const track_game& game, const track_walker& walker, int h, OnTree on_tree)
+{
+    while (!track_terminal(game, h))
+    {
+        bool in_tree = false;
+        if constexpr (requires { engine.in_rollout(); })
+            in_tree = !engine.in_rollout();
+        h = walker.walk(h, engine.choose(game.jumps, game.jumps));
+        if (in_tree)
+            on_tree(h);
+    }
+    delta.set_value(track_reward(game, h));
+    engine.terminate();
+}
+
+using edge_visits_t  = monte_carlo::visits_table<int, std::unordered_map>;
+using edge_value_t   = monte_carlo::value_table<int, double, std::unordered_map>;
+using edge_table_t   = monte_carlo::int_edge_unordered_table<int>;
+using edge_rollout_t = monte_carlo::random_rollout<int, std::mt19937, std::vector<int>, std::vector<int>>;
+
+// Runs `sims` sim episodes and calls checkpoint(i) after each one.
+template<typename IEdges, typename IGetExplorationConstant, typename Checkpoint>
+void edges_sim_run(edge_visits_t& visits, edge_value_t& value, IEdges& edges,
+                   const track_game& game, std::mt19937& rng, IGetExplorationConstant& ec,
+                   size_t sims, Checkpoint checkpoint)
+{
+    using sim_t = monte_carlo::sim<
+        int, int, double,
+        edge_visits_t, edge_value_t, edge_visits_t, edge_value_t,
+        track_walker,
+        std::vector<int>, std::vector<int>,
+        edge_rollout_t,
+        monte_carlo::uniform_value_delta<double>,
+        IGetExplorationConstant,
+        IEdges>;
+
+    track_walker                             walker{game.size()};
+    edge_rollout_t                           rollout(rng);
+    monte_carlo::uniform_value_delta<double> delta;
+
+    for (size_t i = 1; i <= sims; ++i)
+    {
+        if constexpr (std::same_as<IEdges, monte_carlo::no_edge_visits>)
+        {
+            sim_t s(visits, value, visits, value, walker, rollout, delta, ec, -1);
+            track_episode(s, delta, game, walker, -1, [](int) {});
+        }
+        else
+        {
+            sim_t s(visits, value, visits, value, walker, rollout, delta, ec, edges, -1);
+            track_episode(s, delta, game, walker, -1, [](int) {});
+        }
+        checkpoint(i);
+    }
+}
+
+// Runs `sims` dbuct episodes with the given IComputeBatchSize likewise;
+// frames counts the frames pushed (in-tree choices).
+template<typename IEdges, typename IGetExplorationConstant, typename IBatch, typename Checkpoint>
+void batch_dbuct_run(edge_visits_t& visits, edge_value_t& value, IEdges& edges,
+                     const track_game& game, std::mt19937& rng, IGetExplorationConstant& ec,
+                     IBatch& batch, size_t& frames, size_t sims, Checkpoint checkpoint)
+{
+    using dispatches_t = monte_carlo::dispatches_table<int, std::unordered_map>;
+    using dbuct_t      = monte_carlo::dbuct<
+        int, int, double,
+        edge_visits_t, edge_value_t, edge_visits_t, edge_value_t,
+        dispatches_t, dispatches_t,
+        IBatch,
+        track_walker,
+        std::vector<int>, std::vector<int>,
+        edge_rollout_t,
+        monte_carlo::uniform_value_delta<double>,
+        IGetExplorationConstant,
+        IEdges>;
+
+    track_walker                             walker{game.size()};
+    edge_rollout_t                           rollout(rng);
+    dispatches_t                             dispatches;
+    monte_carlo::uniform_value_delta<double> delta;
+
+    auto run = [&](dbuct_t& d)
+    {
+        // Handles of the frames dbuct keeps between episodes; it may camp on
+        // a terminal, in which case the next episode ends at once.
+        std::vector<int> path = {-1};
+        for (size_t i = 1; i <= sims; ++i)
+        {
+            track_episode(d, delta, game, walker, path.back(), [&](int h)
+            {
+                path.push_back(h);
+                ++frames;
+            });
+            path.resize(d.depth());
+            checkpoint(i);
+        }
+    };
+
+    if constexpr (std::same_as<IEdges, monte_carlo::no_edge_visits>)
+    {
+        dbuct_t d(visits, value, visits, value, dispatches, dispatches, batch,
+                  walker, rollout, delta, ec, -1);
+        run(d);
+    }
+    else
+    {
+        dbuct_t d(visits, value, visits, value, dispatches, dispatches, batch,
+                  walker, rollout, delta, ec, edges, -1);
+        run(d);
+    }
+}
+
+// Runs `sims` dbuct episodes (grant increment interval 200) likewise.
+template<typename IEdges, typename IGetExplorationConstant, typename Checkpoint>
+void edges_dbuct_run(edge_visits_t& visits, edge_value_t& value, IEdges& edges,
+                     const track_game& game, std::mt19937& rng, IGetExplorationConstant& ec,
+                     size_t sims, Checkpoint checkpoint)
+{
+    monte_carlo::linear_batch_increment batch(200);
+    size_t                              frames = 0;
+    batch_dbuct_run(visits, value, edges, game, rng, ec, batch, frames, sims, checkpoint);
+}
+
+template<typename IEdges, typename IGetExplorationConstant, typename Run>
+void edges_row(const char* label, IGetExplorationConstant& ec,
+               const std::vector<size_t>& checkpoints, size_t seeds, Run run)
+{
+    std::vector<size_t> solved(checkpoints.size(), 0);
+
+    for (size_t seed = 0; seed < seeds; ++seed)
+    {
+        const track_game game(static_cast<unsigned>(1000 + seed), 150, {1, 2, 3, 4, 5, 6});
+        const double     optimal = game.optimal();
+        std::mt19937     rng(static_cast<unsigned>(seed));
+        edge_visits_t    visits;
+        edge_value_t     value;
+        IEdges           edges;
+        size_t           next = 0;
+
+        run(visits, value, edges, game, rng, ec, checkpoints.back(), [&](size_t i)
+        {
+            if (next < checkpoints.size() && i == checkpoints[next])
+            {
+                solved[next] += std::abs(track_greedy(game, visits, value) - optimal) < 1e-9;
+                ++next;
+            }
+        });
+    }
+
+    std::cout << "  " << std::left << std::setw(20) << label << std::right;
+    for (size_t k = 0; k < checkpoints.size(); ++k)
+        std::cout << std::setw(7) << std::fixed << std::setprecision(0)
+                  << 100.0 * static_cast<double>(solved[k]) / static_cast<double>(seeds) << "%";
+    std::cout << "\n";
+}
+
+void bench_edges()
+{
+    const std::vector<size_t> checkpoints = {500, 1000, 2000, 4000, 8000, 16000};
+    constexpr size_t          seeds       = 50;
+
+    std::cout << "edges: % of " << seeds
+              << " track games (length 150, jumps 1-6) solved after N sims\n";
+
+    using none = monte_carlo::no_edge_visits;
+
+    auto sim_run   = [](auto&&... args) { edges_sim_run(args...); };
+    auto dbuct_run = [](auto&&... args) { edges_dbuct_run(args...); };
+
+    for (double c : {5.0, 20.0})
+    {
+        monte_carlo::uniform_exploration_constant<double> ec(c);
+
+        std::cout << "  c=" << std::left << std::setw(4) << c << std::right << std::setw(14) << "";
+        for (size_t n : checkpoints)
+            std::cout << std::setw(8) << n;
+        std::cout << "\n";
+
+        edges_row<none>        ("sim, node visits",   ec, checkpoints, seeds, sim_run);
+        edges_row<edge_table_t>("sim, edge visits",   ec, checkpoints, seeds, sim_run);
+        edges_row<none>        ("dbuct, node visits", ec, checkpoints, seeds, dbuct_run);
+        edges_row<edge_table_t>("dbuct, edge visits", ec, checkpoints, seeds, dbuct_run);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// edgetable: sim throughput and memory with 64-bit hashed handles for each
+// edge table that can hold them, and the cost of reading all edge counts of
+// a parent (the selection scan): one lookup per child vs one contiguous block.
+// ---------------------------------------------------------------------------
+
+template<typename IVisits, typename IValue, typename IEdges>
+void hashed_edge_sim_episode(IVisits&           visits,
+                             IValue&            value,
+                             IEdges&            edges,
+                             const hashed_game& game,
+                             std::mt19937&      rng)
+{
+    using rollout_t = monte_carlo::random_rollout<
+                         int, std::mt19937, std::vector<int>, std::vector<int>>;
+
+    rollout_t     rollout(rng);
+    hashed_walker walker;
+    monte_carlo::uniform_value_delta<double>          delta;
+    monte_carlo::uniform_exploration_constant<double> ec(1.0);
+
+    monte_carlo::sim<
+        uint64_t, int, double,
+        IVisits, IValue, IVisits, IValue,
+        hashed_walker,
+        std::vector<int>, std::vector<int>,
+        rollout_t,
+        monte_carlo::uniform_value_delta<double>,
+        monte_carlo::uniform_exploration_constant<double>,
+        IEdges
+    > s(visits, value, visits, value, walker, rollout, delta, ec, edges, 0);
+
+    uint64_t node = 0;
+    for (size_t d = 0; d < game.depth; ++d)
+        node = walker.walk(node, s.choose(game.choices, game.choices));
+
+    delta.set_value(hashed_game::reward(node));
+    s.terminate();
+}
+
+template<typename IEdges, typename Scan>
+void edgetable_row(const char* label, Scan scan)
+{
+    constexpr size_t  sims = 300000;
+    const hashed_game game(12, 8);
+    std::mt19937      rng(4);
+
+    monte_carlo::visits_table<uint64_t, std::unordered_map>        visits;
+    monte_carlo::value_table<uint64_t, double, std::unordered_map> value;
+
+    // Grow the node tables first so the byte count below is the edge table's.
+    for (size_t i = 0; i < sims; ++i)
+        hashed_sim_episode(visits, value, game, rng, 1.0);
+
+    const size_t live0 = g_live_bytes.load();
+    IEdges       edges;
+    rng.seed(4);
+    const auto t0 = clock_type::now();
+    for (size_t i = 0; i < sims; ++i)
+        hashed_edge_sim_episode(visits, value, edges, game, rng);
+    const double dt         = seconds_since(t0);
+    const size_t edge_bytes = g_live_bytes.load() - live0;
+
+    std::vector<uint64_t> parents;
+    visits.for_each([&](const uint64_t& h, size_t) { parents.push_back(h); });
+
+    size_t     edge_count = 0;
+    const auto t1         = clock_type::now();
+    for (const uint64_t& p : parents)
+        edge_count += scan(edges, p, game);
+    const double scan_dt = seconds_since(t1);
+    g_sink = static_cast<double>(edge_count);
+
+    std::cout << "  " << std::left << std::setw(28) << label << std::right
+              << std::fixed << std::setprecision(0) << std::setw(8)
+              << static_cast<double>(sims) / dt << " sims/s  "
+              << std::setprecision(1) << std::setw(6)
+              << static_cast<double>(edge_bytes) / static_cast<double>(parents.size()) << " B/edge  "
+              << std::setw(6) << scan_dt * 1e9 / static_cast<double>(parents.size()) << " ns/scan\n";
+}
+
+void bench_edgetable()
+{
+    std::cout << "edgetable: 300000 sims, depth 12, branching 8, uint64_t handles\n";
+
+    // Sum of a parent's edge counts, one get_edge_visits() per child.
+    auto per_child = [](const auto& edges, uint64_t p, const hashed_game& game)
+    {
+        hashed_walker walker;
+        size_t        n = 0;
+        for (int choice : game.choices)
+            n += edges.get_edge_visits(p, walker.walk(p, choice));
+        return n;
+    };
+
+    edgetable_row<monte_carlo::edge_map_table<uint64_t, std::map>>("edge_map_table, std::map", per_child);
+    edgetable_row<monte_carlo::wide_edge_table<uint64_t>>("wide_edge_table", per_child);
+    edgetable_row<monte_carlo::parent_edge_table<uint64_t>>("parent_edge_table", per_child);
+    edgetable_row<monte_carlo::parent_edge_table<uint64_t>>("parent_edge_table, edges()",
+        [](const auto& edges, uint64_t p, const hashed_game&)
+        {
+            const auto e = edges.edges(p);
+            size_t     n = 0;
+            for (size_t i = 0; i < e.size; ++i)
+                n += e.counts[i];
+            return n;
+        });
+}
+
+// ---------------------------------------------------------------------------
+// widening: a wide, shallow game (1000 choices per node, depth 3).  Without
+// widening every node scans all 1000 choices per visit and must expand each
+// once before UCB applies; with progressive_widening only ceil(k * N^alpha).
+// Reports throughput and the reward of the greedy path after the search.
+// ---------------------------------------------------------------------------
+
+struct wide_game
+{
+    static constexpr size_t depth     = 3;
+    static constexpr int    branching = 1000;
+
+    // Per-move rewards shrink with depth, so the first move matters most.
+    static double step_reward(uint64_t node, size_t d)
+    {
+        static constexpr double weight[depth] = {0.6, 0.3, 0.1};
+        return weight[d] * static_cast<double>(monte_carlo::hash_mix(node) % 1000) / 1000.0;
+    }
+};
+
+template<typename IValue, typename IChoices, typename IGetExplorationConstant>
+double wide_sim_episode(monte_carlo::visits_table<uint64_t, std::unordered_map>& visits,
+                        IValue& value,
+                        const IChoices& choices, IGetExplorationConstant& ec, std::mt19937& rng)
+{
+    using visits_t  = monte_carlo::visits_table<uint64_t, std::unordered_map>;
+    using value_t   = IValue;
+    using rollout_t = monte_carlo::random_rollout<int, std::mt19937, IChoices, IChoices>;
+
+    rollout_t     rollout(rng);
+    hashed_walker walker;
+    monte_carlo::uniform_value_delta<double> delta;
+
+    monte_carlo::sim<
+        uint64_t, int, double,
+        visits_t, value_t, visits_t, value_t,
+        hashed_walker,
+        IChoices, IChoices,
+        rollout_t,
+        monte_carlo::uniform_value_delta<double>,
+        IGetExplorationConstant
+    > s(visits, value, visits, value, walker, rollout, delta, ec, 0);
+
+    uint64_t node   = 0;
+    double   reward = 0.0;
+    for (size_t d = 0; d < wide_game::depth; ++d)
+    {
+        node    = walker.walk(node, s.choose(choices, choices));
+        reward += wide_game::step_reward(node, d);
+    }
+    delta.set_value(reward);
+    s.terminate();
+    return reward;
+}
+
+// True reward of the path that follows the highest visit count at each node.
+double wide_greedy(const monte_carlo::visits_table<uint64_t, std::unordered_map>& visits)
+{
+    hashed_walker walker;
+    uint64_t      node   = 0;
+    double        reward = 0.0;
+    for (size_t d = 0; d < wide_game::depth; ++d)
+    {
+        uint64_t best   = walker.walk(node, 0);
+        size_t   best_v = 0;
+        for (int c = 0; c < wide_game::branching; ++c)
+        {
+            const uint64_t child = walker.walk(node, c);
+            if (visits.get_visits(child) > best_v)
+            {
+                best_v = visits.get_visits(child);
+                best   = child;
+            }
+        }
+        node    = best;
+        reward += wide_game::step_reward(node, d);
+    }
+    return reward;
+}
+
+template<typename IValue = monte_carlo::value_table<uint64_t, double, std::unordered_map>,
+         typename IChoices, typename IGetExplorationConstant>
+void widening_row(const char* label, const IChoices& choices, IGetExplorationConstant& ec,
+                  size_t sims)
+{
+    constexpr size_t seeds = 5;
+    double greedy  = 0.0;
+    double elapsed = 0.0;
+
+    for (size_t seed = 0; seed < seeds; ++seed)
+    {
+        monte_carlo::visits_table<uint64_t, std::unordered_map> visits;
+        IValue       value;
+        std::mt19937 rng(static_cast<unsigned>(seed));
+
+        const auto t0 = clock_type::now();
+        for (size_t i = 0; i < sims; ++i)
+            wide_sim_episode(visits, value, choices, ec, rng);
+        elapsed += seconds_since(t0);
+        greedy  += wide_greedy(visits);
+    }
+
+    std::cout << "  " << std::left << std::setw(26) << label << std::right
+              << std::setw(7) << sims << " sims  "
+              << std::fixed << std::setprecision(0) << std::setw(8)
+              << static_cast<double>(sims * seeds) / elapsed << " sims/s  greedy reward "
+              << std::setprecision(3) << greedy / seeds << "\n";
+}
+
+void bench_widening()
+{
+    std::vector<int> choices(wide_game::branching);
+    std::iota(choices.begin(), choices.end(), 0);
+
+    using widen_t = monte_carlo::progressive_widening<std::vector<int>>;
+    const widen_t full(choices, 1e18, 0.0);
+    const widen_t sqrt_n(choices, 1.0, 0.5);
+    const widen_t pow_04(choices, 2.0, 0.4);
+
+    monte_carlo::uniform_exploration_constant<double> ec(0.3);
+
+    std::cout << "widening: branching " << wide_game::branching << ", depth " << wide_game::depth
+              << ", mean of 5 seeds (max reward 1.0)\n";
+    for (size_t sims : {5000, 50000})
+    {
+        widening_row("no widening",    full,   ec, sims);
+        widening_row("k=1, alpha=0.5", sqrt_n, ec, sims);
+        widening_row("k=2, alpha=0.4", pow_04, ec, sims);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// fpu: first-play urgency against the default +inf score for unvisited
+// children.  Simulations to optimal on the edges track games (six jumps per
+// node, rewards uniform in [-10, 10]), then the widening game (1000 choices
+// per node, rewards in [0, 1]) without widening.
+// ---------------------------------------------------------------------------
+
+void bench_fpu()
+{
+    const std::vector<size_t> checkpoints = {500, 1000, 2000, 4000, 8000, 16000};
+    constexpr size_t          seeds       = 50;
+    constexpr double          c           = 5.0;
+
+    using none  = monte_carlo::no_edge_visits;
+    using ec_t  = monte_carlo::uniform_exploration_constant<double>;
+    using fpu_t = monte_carlo::first_play_urgency<double, ec_t>;
+
+    auto sim_run   = [](auto&&... args) { edges_sim_run(args...); };
+    auto dbuct_run = [](auto&&... args) { edges_dbuct_run(args...); };
+
+    ec_t  ec(c);
+    fpu_t constant_0(ec, monte_carlo::fpu_mode::constant, 0.0);
+    fpu_t constant_9(ec, monte_carlo::fpu_mode::constant, 9.0);
+    fpu_t mean(ec, monte_carlo::fpu_mode::parent_mean, 0.0);
+    fpu_t mean_plus_3(ec, monte_carlo::fpu_mode::parent_mean, -3.0);
+
+    std::cout << "fpu: % of " << seeds
+              << " track games (length 150, jumps 1-6) solved after N sims, c=" << c << "\n";
+    std::cout << "  " << std::setw(20) << "";
+    for (size_t n : checkpoints)
+        std::cout << std::setw(8) << n;
+    std::cout << "\n";
+
+    edges_row<none>("sim, +inf",         ec,          checkpoints, seeds, sim_run);
+    edges_row<none>("sim, constant 0",   constant_0,  checkpoints, seeds, sim_run);
+    edges_row<none>("sim, constant 9",   constant_9,  checkpoints, seeds, sim_run);
+    edges_row<none>("sim, mean",         mean,        checkpoints, seeds, sim_run);
+    edges_row<none>("sim, mean + 3",     mean_plus_3, checkpoints, seeds, sim_run);
+    edges_row<none>("dbuct, +inf",       ec,          checkpoints, seeds, dbuct_run);
+    edges_row<none>("dbuct, constant 0", constant_0,  checkpoints, seeds, dbuct_run);
+    edges_row<none>("dbuct, constant 9", constant_9,  checkpoints, seeds, dbuct_run);
+    edges_row<none>("dbuct, mean",       mean,        checkpoints, seeds, dbuct_run);
+    edges_row<none>("dbuct, mean + 3",   mean_plus_3, checkpoints, seeds, dbuct_run);
+
+    std::vector<int> choices(wide_game::branching);
+    std::iota(choices.begin(), choices.end(), 0);
+
+    ec_t  wide_ec(0.3);
+    fpu_t wide_constant_5(wide_ec, monte_carlo::fpu_mode::constant, 0.5);
+    fpu_t wide_constant_8(wide_ec, monte_carlo::fpu_mode::constant, 0.8);
+    fpu_t wide_mean(wide_ec, monte_carlo::fpu_mode::parent_mean, 0.0);
+    fpu_t wide_mean_plus(wide_ec, monte_carlo::fpu_mode::parent_mean, -0.2);
+
+    std::cout << "  widening game, branching " << wide_game::branching << ", depth "
+              << wide_game::depth << ", c=0.3, mean of 5 seeds (max reward 1.0)\n";
+    for (size_t sims : {5000, 50000})
+    {
+        widening_row("+inf",         choices, wide_ec,         sims);
+        widening_row("constant 0.5", choices, wide_constant_5, sims);
+        widening_row("constant 0.8", choices, wide_constant_8, sims);
+        widening_row("mean",         choices, wide_mean,       sims);
+        widening_row("mean + 0.2",   choices, wide_mean_plus,  sims);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// argmax: sim throughput on the widening game with the scanning selection
+// loop vs ucb_argmax_table, for several branching factors (the first b of
+// the 1000 choices).  Both make the same choices on this tree, so the greedy
+// rewards must agree.
+// ---------------------------------------------------------------------------
+
+template<bool Incremental>
+void argmax_row(const std::vector<int>& choices, size_t sims)
+{
+    using ec_t     = monte_carlo::uniform_exploration_constant<double>;
+    using argmax_t = monte_carlo::ucb_argmax_table<uint64_t, double, ec_t, std::unordered_map>;
+
+    constexpr size_t seeds   = 3;
+    double           greedy  = 0.0;
+    double           elapsed = 0.0;
+
+    for (size_t seed = 0; seed < seeds; ++seed)
+    {
+        monte_carlo::visits_table<uint64_t, std::unordered_map>        visits;
+        monte_carlo::value_table<uint64_t, double, std::unordered_map> value;
+        std::mt19937 rng(static_cast<unsigned>(seed));
+        ec_t         ec(0.3);
+        argmax_t     argmax(ec);
+
+        const auto t0 = clock_type::now();
+        for (size_t i = 0; i < sims; ++i)
+        {
+            if constexpr (Incremental)
+                wide_sim_episode(visits, value, choices, argmax, rng);
+            else
+                wide_sim_episode(visits, value, choices, ec, rng);
+        }
+        elapsed += seconds_since(t0);
+        greedy  += wide_greedy(visits);
+    }
+
+    std::cout << "  " << std::left << std::setw(14) << (Incremental ? "incremental" : "scan")
+              << std::right << std::setw(6) << choices.size() << " choices  "
+              << std::fixed << std::setprecision(0) << std::setw(8)
+              << static_cast<double>(sims * seeds) / elapsed << " sims/s  greedy reward "
+              << std::setprecision(3) << greedy / seeds << "\n";
+}
+
+void bench_argmax()
+{
+    constexpr size_t sims = 100000;
+
+    std::cout << "argmax: " << sims << " sims, depth " << wide_game::depth
+              << ", c=0.3, mean of 3 seeds\n";
+    for (int branching : {10, 100, 1000})
+    {
+        std::vector<int> choices(static_cast<size_t>(branching));
+        std::iota(choices.begin(), choices.end(), 0);
+        argmax_row<false>(choices, sims);
+        argmax_row<true>(choices, sims);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// select: ISelect policies on the widening game (100 choices per node), all
+// through the shared select_child() loop.  UCB1 and UCB1-Tuned try every
+// child of a node before revisiting one; PUCT ranks unvisited children by
+// prior, first with a uniform prior and then with one that is half the true
+// step reward of the child and half noise, standing in for a trained policy.
+// ---------------------------------------------------------------------------
+
+// IGetPrior computing a noisy estimate of the child's step reward on demand.
+struct noisy_wide_prior
+{
+    double get_prior(const uint64_t& parent, size_t i) const
+    {
+        const uint64_t child = hashed_walker{}.walk(parent, static_cast<int>(i));
+        const double   truth = static_cast<double>(monte_carlo::hash_mix(child) % 1000) / 1000.0;
+        const double   noise = static_cast<double>(monte_carlo::hash_mix(child ^ 0x5bd1e995u) % 1000) / 1000.0;
+        return (truth + noise) / static_cast<double>(branching);
+    }
+
+    size_t branching;
+};
+
+void bench_select()
+{
+    using ec_t      = monte_carlo::uniform_exploration_constant<double>;
+    using moments_t = monte_carlo::value_moments_table<uint64_t, double, std::unordered_map>;
+
+    std::vector<int> choices(100);
+    std::iota(choices.begin(), choices.end(), 0);
+
+    ec_t ucb_ec(0.3);
+    ec_t tuned_ec(1.0);
+    ec_t puct_ec(1.0);
+
+    monte_carlo::ucb1<double, ec_t>       ucb(ucb_ec);
+    monte_carlo::ucb1_tuned<double, ec_t> tuned(tuned_ec);
+    monte_carlo::uniform_prior<double>    uniform(1.0 / static_cast<double>(choices.size()));
+    noisy_wide_prior                      noisy{choices.size()};
+    monte_carlo::puct<double, ec_t, decltype(uniform)> puct_uniform(puct_ec, uniform);
+    monte_carlo::puct<double, ec_t, noisy_wide_prior>  puct_noisy(puct_ec, noisy);
+
+    std::cout << "select: branching " << choices.size() << ", depth " << wide_game::depth
+              << ", mean of 5 seeds (max reward 1.0)\n";
+    for (size_t sims : {1000, 10000, 100000})
+    {
+        widening_row("ucb1, c=0.3",             choices, ucb,          sims);
+        widening_row<moments_t>("ucb1-tuned, c=1", choices, tuned,     sims);
+        widening_row("puct, uniform prior",     choices, puct_uniform, sims);
+        widening_row("puct, noisy prior",       choices, puct_noisy,   sims);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// earlystop: fraction of a fixed budget early_stop saves on the edges track
+// games (sim, node-only UCB1), checked every 250 simulations.  Each game runs
+// once to the full budget; every rule watches the same run and records where
+// it would have stopped.  Accuracy is the % of games whose greedy walk over
+// node means is optimal, and the % whose most-visited first move matches the
+// full budget's.
+// ---------------------------------------------------------------------------
+
+struct earlystop_rule
+{
+    const char*            label;
+    monte_carlo::stop_rule rule;
+    double                 delta;
+};
+
+void bench_earlystop()
+{
+    using stop_t = monte_carlo::early_stop<int, double, edge_visits_t, edge_value_t, track_walker>;
+    using none   = monte_carlo::no_edge_visits;
+
+    constexpr size_t budget = 16000;
+    constexpr size_t check  = 250;
+    constexpr size_t seeds  = 50;
+
+    const std::vector<earlystop_rule> rules = {
+        {"visit gap",              monte_carlo::stop_rule::visit_gap,  0.0},
+        {"confidence, delta 0.05", monte_carlo::stop_rule::confidence, 0.05},
+        {"confidence, delta 0.5",  monte_carlo::stop_rule::confidence, 0.5},
+    };
+
+    std::vector<double> saved(rules.size(), 0.0);
+    std::vector<size_t> solved(rules.size(), 0);
+    std::vector<size_t> same_move(rules.size(), 0);
+    size_t              full_solved = 0;
+
+    monte_carlo::uniform_exploration_constant<double> ec(5.0);
+
+    for (size_t seed = 0; seed < seeds; ++seed)
+    {
+        const track_game game(static_cast<unsigned>(1000 + seed), 150, {1, 2, 3, 4, 5, 6});
+        const double     optimal = game.optimal();
+        std::mt19937     rng(static_cast<unsigned>(seed));
+        edge_visits_t    visits;
+        edge_value_t     value;
+        none             edges;
+        track_walker     walker{game.size()};
+
+        auto first_move = [&]
+        {
+            int best = walker.walk(-1, game.jumps.front());
+            for (int j : game.jumps)
+                if (visits.get_visits(walker.walk(-1, j)) > visits.get_visits(best))
+                    best = walker.walk(-1, j);
+            return best;
+        };
+
+        std::vector<stop_t> stops;
+        for (const earlystop_rule& r : rules)
+            stops.emplace_back(visits, value, walker, r.rule, check, 20.0, r.delta);
+        std::vector<size_t> stopped_at(rules.size(), budget);
+        std::vector<int>    move_at(rules.size(), 0);
+        std::vector<bool>   solved_at(rules.size(), false);
+
+        edges_sim_run(visits, value, edges, game, rng, ec, budget, [&](size_t i)
+        {
+            for (size_t k = 0; k < rules.size(); ++k)
+                if (stopped_at[k] == budget && stops[k].should_stop(-1, game.jumps, game.jumps, i, budget))
+                {
+                    stopped_at[k] = i;
+                    move_at[k]    = first_move();
+                    solved_at[k]  = std::abs(track_greedy(game, visits, value) - optimal) < 1e-9;
+                }
+        });
+
+        const bool full = std::abs(track_greedy(game, visits, value) - optimal) < 1e-9;
+        full_solved += full;
+        for (size_t k = 0; k < rules.size(); ++k)
+        {
+            const bool stopped = stopped_at[k] < budget;
+            saved[k]     += 1.0 - static_cast<double>(stopped_at[k]) / static_cast<double>(budget);
+            solved[k]    += stopped ? solved_at[k] : full;
+            same_move[k] += !stopped || move_at[k] == first_move();
+        }
+    }
+
+    std::cout << "earlystop: " << seeds << " track games (length 150, jumps 1-6), budget "
+              << budget << ", check every " << check << ", c=5\n";
+    std::cout << "  " << std::left << std::setw(24) << "full budget" << std::right
+              << "  saved   0.0%  solved " << std::setw(3) << 100 * full_solved / seeds << "%\n";
+    for (size_t k = 0; k < rules.size(); ++k)
+        std::cout << "  " << std::left << std::setw(24) << rules[k].label << std::right
+                  << "  saved " << std::fixed << std::setprecision(1) << std::setw(5)
+                  << 100.0 * saved[k] / seeds << "%  solved " << std::setw(3)
+                  << 100 * solved[k] / seeds << "%  same first move "
+                  << 100 * same_move[k] / seeds << "%\n";
+}
+
+// ---------------------------------------------------------------------------
+// halving: root decision quality against budget, UCB1 at the root vs
+// sequential_halving over UCB1.  Each of 1000 games has 16 root moves, each
+// followed by 8 replies paying a Bernoulli reward with a hashed mean; a root
+// move is worth its best reply.  UCB1 recommends its most visited root move,
+// halving the best-mean survivor.  Reports the % of games where the
+// recommendation is optimal and the mean simple regret.
+// ---------------------------------------------------------------------------
+
+struct halving_game
+{
+    static constexpr int root_moves = 16;
+    static constexpr int replies    = 8;
+
+    static double mean(uint64_t leaf) { return static_cast<double>(monte_carlo::hash_mix(leaf) % 1000) / 1000.0; }
+
+    static double worth(uint64_t move)
+    {
+        hashed_walker walker;
+        double        best = 0.0;
+        for (int r = 0; r < replies; ++r)
+            best = std::max(best, mean(walker.walk(move, r)));
+        return best;
+    }
+};
+
+template<bool Halving>
+void halving_row(const std::vector<size_t>& budgets, size_t seeds)
+{
+    using visits_t  = monte_carlo::visits_table<uint64_t, std::unordered_map>;
+    using value_t   = monte_carlo::value_table<uint64_t, double, std::unordered_map>;
+    using choices_t = std::vector<int>;
+    using rollout_t = monte_carlo::random_rollout<int, std::mt19937, choices_t, choices_t>;
+    using ec_t      = monte_carlo::uniform_exploration_constant<double>;
+    using halving_t = monte_carlo::sequential_halving<uint64_t, double, ec_t>;
+    using select_t  = std::conditional_t<Halving, halving_t, ec_t>;
+
+    choices_t root_moves(halving_game::root_moves);
+    choices_t replies(halving_game::replies);
+    std::iota(root_moves.begin(), root_moves.end(), 0);
+    std::iota(replies.begin(), replies.end(), 0);
+
+    std::cout << "  " << std::left << std::setw(10) << (Halving ? "halving" : "ucb1") << std::right;
+    for (size_t budget : budgets)
+    {
+        size_t optimal = 0;
+        double regret  = 0.0;
+
+        for (size_t seed = 0; seed < seeds; ++seed)
+        {
+            const uint64_t root = monte_carlo::hash_mix(seed + 7);
+            hashed_walker  walker;
+            visits_t       visits;
+            value_t        value;
+            std::mt19937   rng(static_cast<unsigned>(seed));
+            ec_t           ec(0.5);
+            halving_t      halving(ec, root, budget);
+            select_t&      select = [&]() -> select_t& { if constexpr (Halving) return halving; else return ec; }();
+
+            for (size_t i = 0; i < budget; ++i)
+            {
+                rollout_t rollout(rng);
+                monte_carlo::uniform_value_delta<double> delta;
+
+                monte_carlo::sim<
+                    uint64_t, int, double,
+                    visits_t, value_t, visits_t, value_t,
+                    hashed_walker,
+                    choices_t, choices_t,
+                    rollout_t,
+                    monte_carlo::uniform_value_delta<double>,
+                    select_t
+                > s(visits, value, visits, value, walker, rollout, delta, select, root);
+
+                const uint64_t move  = walker.walk(root, s.choose(root_moves, root_moves));
+                const uint64_t reply = walker.walk(move, s.choose(replies, replies));
+                delta.set_value(std::bernoulli_distribution(halving_game::mean(reply))(rng) ? 1.0 : 0.0);
+                s.terminate();
+            }
+
+            auto mean = [&](uint64_t h)
+            {
+                const size_t v = visits.get_visits(h);
+                return v == 0 ? -1.0 : value.get_value(h) / static_cast<double>(v);
+            };
+
+            uint64_t pick = walker.walk(root, 0);
+            if constexpr (Halving)
+            {
+                double best = -2.0;
+                for (size_t i : halving.survivors())
+                    if (mean(walker.walk(root, static_cast<int>(i))) > best)
+                    {
+                        best = mean(walker.walk(root, static_cast<int>(i)));
+                        pick = walker.walk(root, static_cast<int>(i));
+                    }
+            }
+            else
+                for (int m : root_moves)
+                    if (visits.get_visits(walker.walk(root, m)) > visits.get_visits(pick))
+                        pick = walker.walk(root, m);
+
+            double best_worth = 0.0;
+            for (int m : root_moves)
+                best_worth = std::max(best_worth, halving_game::worth(walker.walk(root, m)));
+
+            const double worth = halving_game::worth(pick);
+            optimal += worth == best_worth;
+            regret  += best_worth - worth;
+        }
+
+        std::cout << std::setw(7) << 100 * optimal / seeds << "% " << std::fixed
+                  << std::setprecision(3) << std::setw(6) << regret / static_cast<double>(seeds);
+    }
+    std::cout << "\n";
+}
+
+void bench_halving()
+{
+    const std::vector<size_t> budgets = {64, 128, 256, 512, 1024};
+    constexpr size_t          seeds   = 1000;
+
+    std::cout << "halving: % optimal root move and mean simple regret over " << seeds
+              << " games (" << halving_game::root_moves << " moves x " << halving_game::replies
+              << " Bernoulli replies), c=0.5\n";
+    std::cout << "  " << std::setw(10) << "";
+    for (size_t b : budgets)
+        std::cout << std::setw(15) << b;
+    std::cout << "\n";
+
+    halving_row<false>(budgets, seeds);
+    halving_row<true>(budgets, seeds);
+}
+
+// ---------------------------------------------------------------------------
+// rave: % of games solved after N sims, UCB1 vs rave over an amaf_table
+// (hand-selected schedule, k=100), each at its own exploration constant.
+// The picking game has 4 steps of 16 items and pays the mean item value in
+// any order: the last item is worth 1, the rest at most 0.8, and a game is
+// solved when the most-visited path picks it at every step.  The track
+// games are the edges benchmark's, on position handles: AMAF for (position,
+// jump) pools every episode through the position that made the jump at any
+// later step, which still separates good jumps from bad ones early.
+// ---------------------------------------------------------------------------
+
+struct pick_game
+{
+    static constexpr int items = 16;
+    static constexpr int depth = 4;
+
+    static double value(int a) { return a == items - 1 ? 1.0 : 0.8 * (a * 5 % items) / (items - 1.0); }
+
+    template<typename IVisits>
+    static bool solved(const IVisits& visits, uint64_t root)
+    {
+        hashed_walker walker;
+        uint64_t      h = root;
+        for (int d = 0; d < depth; ++d)
+        {
+            int pick = 0;
+            for (int a = 1; a < items; ++a)
+                if (visits.get_visits(walker.walk(h, a)) > visits.get_visits(walker.walk(h, pick)))
+                    pick = a;
+            h = walker.walk(h, pick);
+            if (pick != items - 1 || visits.get_visits(h) < 2)
+                return false;
+        }
+        return true;
+    }
+};
+
+template<bool Rave>
+void rave_pick_row(const char* label, double c, const std::vector<size_t>& checkpoints, size_t seeds)
+{
+    using visits_t  = monte_carlo::visits_table<uint64_t, std::unordered_map>;
+    using value_t   = monte_carlo::value_table<uint64_t, double, std::unordered_map>;
+    using choices_t = std::vector<int>;
+    using rollout_t = monte_carlo::random_rollout<int, std::mt19937, choices_t, choices_t>;
+    using ec_t      = monte_carlo::uniform_exploration_constant<double>;
+    using amaf_t    = monte_carlo::amaf_table<uint64_t, int, double, std::map>;
+    using rave_t    = monte_carlo::rave<double, ec_t, amaf_t>;
+    using select_t  = std::conditional_t<Rave, rave_t, ec_t>;
+
+    choices_t items(pick_game::items);
+    std::iota(items.begin(), items.end(), 0);
+
+    std::vector<size_t> solved(checkpoints.size(), 0);
+    for (size_t seed = 0; seed < seeds; ++seed)
+    {
+        const uint64_t root = monte_carlo::hash_mix(seed + 7);
+        hashed_walker  walker;
+        visits_t       visits;
+        value_t        value;
+        std::mt19937   rng(static_cast<unsigned>(seed));
+        ec_t           ec(c);
+        amaf_t         amaf;
+        rave_t         rave(ec, amaf, 100.0);
+        select_t&      select = [&]() -> select_t& { if constexpr (Rave) return rave; else return ec; }();
+        size_t         next   = 0;
+
+        for (size_t i = 1; i <= checkpoints.back(); ++i)
+        {
+            rollout_t rollout(rng);
+            monte_carlo::uniform_value_delta<double> delta;
+
+            monte_carlo::sim<
+                uint64_t, int, double,
+                visits_t, value_t, visits_t, value_t,
+                hashed_walker,
+                choices_t, choices_t,
+                rollout_t,
+                monte_carlo::uniform_value_delta<double>,
+                select_t
+            > s(visits, value, visits, value, walker, rollout, delta, select, root);
+
+            double total = 0.0;
+            for (int d = 0; d < pick_game::depth; ++d)
+                total += pick_game::value(s.choose(items, items));
+            delta.set_value(total / pick_game::depth);
+            s.terminate();
+
+            if (next < checkpoints.size() && i == checkpoints[next])
+            {
+                solved[next] += pick_game::solved(visits, root);
+                ++next;
+            }
+        }
+    }
+
+    std::cout << "  " << std::left << std::setw(20) << label << std::right;
+    for (size_t k = 0; k < checkpoints.size(); ++k)
+        std::cout << std::setw(7) << std::fixed << std::setprecision(0)
+                  << 100.0 * static_cast<double>(solved[k]) / static_cast<double>(seeds) << "%";
+    std::cout << "\n";
+}
+
+template<bool Rave>
+void rave_track_row(const char* label, double c, const std::vector<size_t>& checkpoints, size_t seeds)
+{
+    using ec_t     = monte_carlo::uniform_exploration_constant<double>;
+    using amaf_t   = monte_carlo::amaf_table<int, int, double, std::map>;
+    using rave_t   = monte_carlo::rave<double, ec_t, amaf_t>;
+    using select_t = std::conditional_t<Rave, rave_t, ec_t>;
+
+    std::vector<size_t> solved(checkpoints.size(), 0);
+    for (size_t seed = 0; seed < seeds; ++seed)
+    {
+        const track_game game(static_cast<unsigned>(1000 + seed), 150, {1, 2, 3, 4, 5, 6});
+        const double     optimal = game.optimal();
+        std::mt19937     rng(static_cast<unsigned>(seed));
+        edge_visits_t    visits;
+        edge_value_t     value;
+        ec_t             ec(c);
+        amaf_t           amaf;
+        rave_t           rave(ec, amaf, 100.0);
+        select_t&        select = [&]() -> select_t& { if constexpr (Rave) return rave; else return ec; }();
+        size_t           next   = 0;
+        monte_carlo::no_edge_visits edges;
+
+        edges_sim_run(visits, value, edges, game, rng, select, checkpoints.back(), [&](size_t i)
+        {
+            if (next < checkpoints.size() && i == checkpoints[next])
+            {
+                solved[next] += std::abs(track_greedy(game, visits, value) - optimal) < 1e-9;
+                ++next;
+            }
+        });
+    }
+
+    std::cout << "  " << std::left << std::setw(20) << label << std::right;
+    for (size_t k = 0; k < checkpoints.size(); ++k)
+        std::cout << std::setw(7) << std::fixed << std::setprecision(0)
+                  << 100.0 * static_cast<double>(solved[k]) / static_cast<double>(seeds) << "%";
+    std::cout << "\n";
+}
+
+void bench_rave()
+{
+    constexpr size_t seeds = 50;
+
+    const std::vector<size_t> pick_checkpoints = {50, 100, 200, 400, 800, 1600};
+    std::cout << "rave: % of " << seeds << " picking games (" << pick_game::items << " items, depth "
+              << pick_game::depth << ") solved after N sims\n";
+    std::cout << "  " << std::setw(20) << "";
+    for (size_t n : pick_checkpoints)
+        std::cout << std::setw(8) << n;
+    std::cout << "\n";
+    rave_pick_row<false>("ucb1, c=0.3",  0.3,  pick_checkpoints, seeds);
+    rave_pick_row<false>("ucb1, c=0.5",  0.5,  pick_checkpoints, seeds);
+    rave_pick_row<true>("rave, c=0.05",  0.05, pick_checkpoints, seeds);
+    rave_pick_row<true>("rave, c=0.1",   0.1,  pick_checkpoints, seeds);
+
+    const std::vector<size_t> track_checkpoints = {500, 1000, 2000, 4000, 8000, 16000};
+    std::cout << "  track games (length 150, jumps 1-6)\n";
+    rave_track_row<false>("ucb1, c=5",   5.0,  track_checkpoints, seeds);
+    rave_track_row<true>("rave, c=5",    5.0,  track_checkpoints, seeds);
+    rave_track_row<true>("rave, c=2",    2.0,  track_checkpoints, seeds);
+}
+
+// ---------------------------------------------------------------------------
+// batch: dbuct grant policies on the two dbuct test games.  The track games
+// are the edges benchmark's (position handles, last-position reward, c=5);
+// the coin games collect every coin landed on (length 20, jumps 1-3,
+// c=100) on hashed path handles, so each route is its own node.  Reports
+// frames pushed per simulation (stack churn: one per in-tree choice) and %
+// of games whose greedy walk over means is optimal after N sims, for
+// linear_batch_increment, geometric_batch_increment and the two
+// adaptive_batch_size signals.
+// ---------------------------------------------------------------------------
+
+struct coin_game
+{
+    std::vector<double> track;
+    std::vector<int>    jumps;
+
+    coin_game(unsigned seed, size_t length, std::vector<int> jumps)
+        : track(length), jumps(std::move(jumps))
+    {
+        std::mt19937                           rng(seed);
+        std::uniform_real_distribution<double> urd(-10, 10);
+        std::generate(track.begin(), track.end(), [&] { return urd(rng); });
+    }
+
+    int size() const { return static_cast<int>(track.size()); }
+
+    // Best coin sum over all jump sequences from position -1.
+    double optimal() const
+    {
+        std::vector<double> dp(track.size() + 1, 0.0);   // dp[pos + 1]
+        for (int pos = size() - 1; pos >= -1; --pos)
+        {
+            double best = -std::numeric_limits<double>::infinity();
+            for (int j : jumps)
+                best = std::max(best, pos + j < size() ? track[pos + j] + dp[pos + j + 1] : 0.0);
+            dp[pos + 1] = best;
+        }
+        return dp[0];
+    }
+
+    // Greedy walk over node means from root; -inf if it leaves the tree.
+    template<typename IVisits, typename IValue>
+    double greedy(const IVisits& visits, const IValue& value, uint64_t root) const
+    {
+        hashed_walker walker;
+        uint64_t      h     = root;
+        int           pos   = -1;
+        double        score = 0.0;
+        while (pos < size())
+        {
+            double best_mean = -std::numeric_limits<double>::infinity();
+            int    best      = 0;
+            for (int j : jumps)
+            {
+                const size_t v = visits.get_visits(walker.walk(h, j));
+                if (v > 0 && value.get_value(walker.walk(h, j)) / static_cast<double>(v) > best_mean)
+                {
+                    best_mean = value.get_value(walker.walk(h, j)) / static_cast<double>(v);
+                    best      = j;
+                }
+            }
+            if (best == 0)
+                return -std::numeric_limits<double>::infinity();
+            h    = walker.walk(h, best);
+            pos += best;
+            if (pos < size())
+                score += track[pos];
+        }
+        return score;
+    }
+};
+
+template<typename IBatch>
+void batch_coin_run(const coin_game& game, IBatch& batch, std::mt19937& rng,
+                    const std::vector<size_t>& checkpoints, std::vector<size_t>& solved,
+                    size_t& frames)
+{
+    using visits_t     = monte_carlo::visits_table<uint64_t, std::unordered_map>;
+    using value_t      = monte_carlo::value_table<uint64_t, double, std::unordered_map>;
+    using dispatches_t = monte_carlo::dispatches_table<uint64_t, std::unordered_map>;
+    using ec_t         = monte_carlo::uniform_exploration_constant<double>;
+    using dbuct_t      = monte_carlo::dbuct<
+        uint64_t, int, double,
+        visits_t, value_t, visits_t, value_t,
+        dispatches_t, dispatches_t,
+        IBatch,
+        hashed_walker,
+        std::vector<int>, std::vector<int>,
+        edge_rollout_t,
+        monte_carlo::uniform_value_delta<double>,
+        ec_t>;
+
+    const uint64_t root    = monte_carlo::hash_mix(7);
+    const double   optimal = game.optimal();
+    visits_t       visits;
+    value_t        value;
+    dispatches_t   dispatches;
+    hashed_walker  walker;
+    edge_rollout_t rollout(rng);
+    ec_t           ec(100.0);
+    monte_carlo::uniform_value_delta<double> delta;
+
+    dbuct_t d(visits, value, visits, value, dispatches, dispatches, batch,
+              walker, rollout, delta, ec, root);
+
+    // Positions of the frames dbuct keeps between episodes, root first.
+    std::vector<int> path = {-1};
+    size_t           next = 0;
+    for (size_t i = 1; i <= checkpoints.back(); ++i)
+    {
+        double score = 0.0;
+        for (int pos : path)
+            if (pos >= 0 && pos < game.size())
+                score += game.track[pos];
+
+        int pos = path.back();
+        while (pos < game.size())
+        {
+            const bool in_tree = !d.in_rollout();
+            pos += d.choose(game.jumps, game.jumps);
+            if (in_tree)
+            {
+                path.push_back(pos);
+                ++frames;
+            }
+            if (pos < game.size())
+                score += game.track[pos];
+        }
+        delta.set_value(score);
+        d.terminate();
+        path.resize(d.depth());
+
+        if (next < checkpoints.size() && i == checkpoints[next])
+        {
+            solved[next] += std::abs(game.greedy(visits, value, root) - optimal) < 1e-9;
+            ++next;
+        }
+    }
+}
+
+template<typename IBatch>
+void batch_row(const char* label, bool coin, const IBatch& batch,
+               const std::vector<size_t>& checkpoints, size_t seeds)
+{
+    monte_carlo::uniform_exploration_constant<double> ec(5.0);
+
+    std::vector<size_t> solved(checkpoints.size(), 0);
+    size_t              frames = 0;
+
+    for (size_t seed = 0; seed < seeds; ++seed)
+    {
+        std::mt19937 rng(static_cast<unsigned>(seed));
+        IBatch       policy = batch;
+
+        if (coin)
+        {
+            batch_coin_run(coin_game(static_cast<unsigned>(2000 + seed), 12, {1, 2, 3}),
+                           policy, rng, checkpoints, solved, frames);
+            continue;
+        }
+
+        const track_game game(static_cast<unsigned>(1000 + seed), 150, {1, 2, 3, 4, 5, 6});
+        const double     optimal = game.optimal();
+        edge_visits_t    visits;
+        edge_value_t     value;
+        size_t           next = 0;
+        monte_carlo::no_edge_visits edges;
+
+        batch_dbuct_run(visits, value, edges, game, rng, ec, policy, frames, checkpoints.back(),
+                        [&](size_t i)
+        {
+            if (next < checkpoints.size() && i == checkpoints[next])
+            {
+                solved[next] += std::abs(track_greedy(game, visits, value) - optimal) < 1e-9;
+                ++next;
+            }
+        });
+    }
+
+    std::cout << "  " << std::left << std::setw(24) << label << std::right << std::fixed
+              << std::setprecision(2) << std::setw(8)
+              << static_cast<double>(frames) / static_cast<double>(seeds * checkpoints.back());
+    for (size_t k = 0; k < checkpoints.size(); ++k)
+        std::cout << std::setw(7) << std::setprecision(0)
+                  << 100.0 * static_cast<double>(solved[k]) / static_cast<double>(seeds) << "%";
+    std::cout << "\n";
+}
+
+void bench_batch()
+{
+    constexpr size_t seeds = 50;
+
+    using linear_t    = monte_carlo::linear_batch_increment;
+    using geometric_t = monte_carlo::geometric_batch_increment;
+    using adaptive_t  = monte_carlo::adaptive_batch_size<double>;
+    using monte_carlo::batch_signal;
+
+    const linear_t    vanilla(std::numeric_limits<size_t>::max());
+    const adaptive_t  gap(batch_signal::ucb_gap, 64);
+    const adaptive_t  share(batch_signal::visit_share, 64);
+
+    for (bool coin : {false, true})
+    {
+        const std::vector<size_t> checkpoints = coin
+            ? std::vector<size_t>{2000, 4000, 8000, 16000, 32000}
+            : std::vector<size_t>{1000, 2000, 4000, 8000, 16000};
+
+        std::cout << "batch: dbuct frames pushed per sim and % of " << seeds
+                  << (coin ? " coin games (length 20, jumps 1-3, c=100)"
+                           : " track games (length 150, jumps 1-6, c=5)")
+                  << " solved after N sims\n";
+        std::cout << "  " << std::setw(24) << "" << std::setw(8) << "frames";
+        for (size_t n : checkpoints)
+            std::cout << std::setw(8) << n;
+        std::cout << "\n";
+
+        batch_row("vanilla (grant 1)", coin, vanilla,             checkpoints, seeds);
+        batch_row("linear, B=200",     coin, linear_t(200),       checkpoints, seeds);
+        batch_row("linear, B=20",      coin, linear_t(20),        checkpoints, seeds);
+        batch_row("geometric, B=50",   coin, geometric_t(50, 64), checkpoints, seeds);
+        batch_row("geometric, B=20",   coin, geometric_t(20, 64), checkpoints, seeds);
+        batch_row("ucb gap",           coin, gap,                 checkpoints, seeds);
+        batch_row("visit share",       coin, share,               checkpoints, seeds);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// prefix: dbuct resuming on a long coin game (length 400, jumps 1-3, c=100,
+// hashed path handles, grant interval B=5 so frames camp deep).  The caller
+// either keeps the camped path and re-sums its coins every episode, or
+// reads the sum from the top frame's accumulator.  Reports ns/sim and the
+// mean depth an episode resumes at.
+// ---------------------------------------------------------------------------
+
+struct coin_prefix
+{
+    int    position = -1;
+    double score    = 0.0;
+};
+
+template<bool Accumulate>
+void prefix_row(const char* label, const coin_game& game, size_t sims)
+{
+    using visits_t     = monte_carlo::visits_table<uint64_t, std::unordered_map>;
+    using value_t      = monte_carlo::value_table<uint64_t, double, std::unordered_map>;
+    using dispatches_t = monte_carlo::dispatches_table<uint64_t, std::unordered_map>;
+    using ec_t         = monte_carlo::uniform_exploration_constant<double>;
+    using batch_t      = monte_carlo::linear_batch_increment;
+    using dbuct_t      = monte_carlo::dbuct<
+        uint64_t, int, double,
+        visits_t, value_t, visits_t, value_t,
+        dispatches_t, dispatches_t,
+        batch_t,
+        hashed_walker,
+        std::vector<int>, std::vector<int>,
+        edge_rollout_t,
+        monte_carlo::uniform_value_delta<double>,
+        ec_t,
+        monte_carlo::no_edge_visits,
+        std::conditional_t<Accumulate, coin_prefix, monte_carlo::no_accumulator>>;
+
+    std::mt19937   rng(6);
+    visits_t       visits;
+    value_t        value;
+    dispatches_t   dispatches;
+    batch_t        batch(5);
+    hashed_walker  walker;
+    edge_rollout_t rollout(rng);
+    ec_t           ec(100.0);
+    monte_carlo::uniform_value_delta<double> delta;
+
+    dbuct_t d(visits, value, visits, value, dispatches, dispatches, batch,
+              walker, rollout, delta, ec, monte_carlo::hash_mix(7));
+
+    auto accumulate = [&](const coin_prefix& from, const uint64_t&, int j)
+    {
+        const int to = from.position + j;
+        return coin_prefix{to, from.score + (to < game.size() ? game.track[to] : 0.0)};
+    };
+
+    std::vector<int> path = {-1};
+    size_t           depth = 0;
+    const auto       t0    = clock_type::now();
+    for (size_t i = 0; i < sims; ++i)
+    {
+        depth += d.depth() - 1;
+        if constexpr (Accumulate)
+        {
+            coin_prefix at = d.accumulated();
+            while (at.position < game.size())
+                at = accumulate(at, 0, d.choose(game.jumps, game.jumps, accumulate));
+            delta.set_value(at.score);
+        }
+        else
+        {
+            double score = 0.0;
+            for (int pos : path)
+                if (pos >= 0 && pos < game.size())
+                    score += game.track[pos];
+
+            int pos = path.back();
+            while (pos < game.size())
+            {
+                const bool in_tree = !d.in_rollout();
+                pos += d.choose(game.jumps, game.jumps);
+                if (in_tree)
+                    path.push_back(pos);
+                if (pos < game.size())
+                    score += game.track[pos];
+            }
+            delta.set_value(score);
+        }
+        d.terminate();
+        if constexpr (!Accumulate)
+            path.resize(d.depth());
+    }
+    const double seconds = seconds_since(t0);
+
+    std::cout << "  " << std::left << std::setw(24) << label << std::right << std::fixed
+              << std::setprecision(0) << std::setw(8) << seconds * 1e9 / static_cast<double>(sims)
+              << " ns/sim   resumes at depth " << std::setprecision(1)
+              << static_cast<double>(depth) / static_cast<double>(sims) << "\n";
+}
+
+void bench_prefix()
+{
+    constexpr size_t sims = 200000;
+    const coin_game  game(3000, 400, {1, 2, 3});
+
+    std::cout << "prefix: dbuct on a coin game (length 400, jumps 1-3, B=5), " << sims << " sims\n";
+    prefix_row<false>("re-sum the camped path", game, sims);
+    prefix_row<true>("frame accumulator",       game, sims);
+}
+
+// ---------------------------------------------------------------------------
+// forced: sim on a corridor coin game where only the start and every fifth
+// position (p % 5 == 4) choose a jump 1-3 and every other step is a forced
+// jump of 1 (length 60, c=100, hashed path handles).  Plain choices store a
+// node per forced step; forced_moves folds them into the edge above.
+// Reports ns/sim, table entries and % of games whose greedy walk over means
+// is optimal, over 10 seeds.
+// ---------------------------------------------------------------------------
+
+struct corridor_game
+{
+    std::vector<double> track;
+    std::vector<int>    all    = {1, 2, 3};
+    std::vector<int>    single = {1};
+
+    corridor_game(unsigned seed, size_t length) : track(length)
+    {
+        std::mt19937                           rng(seed);
+        std::uniform_real_distribution<double> urd(-10, 10);
+        std::generate(track.begin(), track.end(), [&] { return urd(rng); });
+    }
+
+    int size() const { return static_cast<int>(track.size()); }
+
+    static bool decides(int pos) { return pos == -1 || pos % 5 == 4; }
+
+    const std::vector<int>& jumps(int pos) const { return decides(pos) ? all : single; }
+
+    double optimal() const
+    {
+        std::vector<double> dp(track.size() + 1, 0.0);   // dp[pos + 1]
+        for (int pos = size() - 1; pos >= -1; --pos)
+        {
+            dp[pos + 1] = -std::numeric_limits<double>::infinity();
+            for (int j : jumps(pos))
+                dp[pos + 1] = std::max(dp[pos + 1], pos + j < size() ? track[pos + j] + dp[pos + j + 1] : 0.0);
+        }
+        return dp[0];
+    }
+
+    // Greedy walk over node means at decision points; forced steps are taken
+    // whether or not they were stored.
+    template<typename IVisits, typename IValue>
+    double greedy(const IVisits& visits, const IValue& value, uint64_t root) const
+    {
+        hashed_walker walker;
+        uint64_t      h     = root;
+        int           pos   = -1;
+        double        score = 0.0;
+        while (pos < size())
+        {
+            double best_mean = -std::numeric_limits<double>::infinity();
+            int    best      = decides(pos) ? 0 : 1;
+            if (decides(pos))
+                for (int j : all)
+                {
+                    const size_t v = visits.get_visits(walker.walk(h, j));
+                    if (v > 0 && value.get_value(walker.walk(h, j)) / static_cast<double>(v) > best_mean)
+                    {
+                        best_mean = value.get_value(walker.walk(h, j)) / static_cast<double>(v);
+                        best      = j;
+                    }
+                }
+            if (best == 0)
+                return -std::numeric_limits<double>::infinity();
+            h    = walker.walk(h, best);
+            pos += best;
+            if (pos < size())
+                score += track[pos];
+        }
+        return score;
+    }
+};
+
+template<bool Fold>
+void forced_row(const char* label, size_t sims, size_t seeds)
+{
+    using choices_t = std::conditional_t<Fold, monte_carlo::forced_moves<std::vector<int>>, std::vector<int>>;
+    using visits_t  = monte_carlo::visits_table<uint64_t, std::unordered_map>;
+    using value_t   = monte_carlo::value_table<uint64_t, double, std::unordered_map>;
+    using ec_t      = monte_carlo::uniform_exploration_constant<double>;
+    using rollout_t = monte_carlo::random_rollout<int, std::mt19937, choices_t, choices_t>;
+    using delta_t   = monte_carlo::uniform_value_delta<double>;
+    using sim_t     = monte_carlo::sim<
+        uint64_t, int, double,
+        visits_t, value_t, visits_t, value_t,
+        hashed_walker, choices_t, choices_t, rollout_t, delta_t, ec_t>;
+
+    double seconds = 0.0;
+    size_t entries = 0;
+    size_t optimal = 0;
+    for (size_t seed = 0; seed < seeds; ++seed)
+    {
+        const corridor_game game(static_cast<unsigned>(4000 + seed), 60);
+        const choices_t     all(game.all), single(game.single);
+        const uint64_t      root = monte_carlo::hash_mix(seed + 1);
+
+        std::mt19937  rng(static_cast<unsigned>(seed));
+        visits_t      visits;
+        value_t       value;
+        hashed_walker walker;
+        rollout_t     rollout(rng);
+        delta_t       delta;
+        ec_t          ec(100.0);
+
+        sim_t      s(visits, value, visits, value, walker, rollout, delta, ec, root);
+        const auto t0 = clock_type::now();
+        for (size_t i = 0; i < sims; ++i)
+        {
+            int    pos   = -1;
+            double score = 0.0;
+            while (pos < game.size())
+            {
+                const choices_t& choices = corridor_game::decides(pos) ? all : single;
+                pos += s.choose(choices, choices);
+                if (pos < game.size())
+                    score += game.track[pos];
+            }
+            delta.set_value(score);
+            s.terminate();
+            s.reset(root);
+        }
+        seconds += seconds_since(t0);
+
+        visits.for_each([&](uint64_t, size_t) { ++entries; });
+        optimal += std::abs(game.greedy(visits, value, root) - game.optimal()) < 1e-9;
+    }
+
+    std::cout << "  " << std::left << std::setw(16) << label << std::right << std::fixed
+              << std::setprecision(0) << std::setw(8)
+              << seconds * 1e9 / static_cast<double>(sims * seeds) << " ns/sim"
+              << std::setw(9) << static_cast<double>(entries) / static_cast<double>(seeds) << " entries"
+              << std::setw(6) << 100.0 * static_cast<double>(optimal) / static_cast<double>(seeds)
+              << "% optimal\n";
+}
+
+void bench_forced()
+{
+    constexpr size_t sims  = 10000;
+    constexpr size_t seeds = 10;
+
+    std::cout << "forced: sim on a corridor (length 60, decisions every 5th step), "
+              << sims << " sims x " << seeds << " seeds\n";
+    forced_row<false>("plain choices", sims, seeds);
+    forced_row<true>("forced_moves",   sims, seeds);
+}
+
+// ---------------------------------------------------------------------------
+// arity: choice counts fixed at compile time (choice_span.hpp).  First the
+// select_child() loop alone, UCB1 over N visited children read from a flat
+// array, with the count a run-time size_t or an integral_constant<N>; then
+// whole sim episodes on the hashed game (depth 6, 8 choices, c=0.5) with
+// the choices in a std::vector (run-time count, checked at()), a
+// std::array (fixed count, checked at()) and a choice_span<int, 8> (fixed
+// count, unchecked at()).
+// ---------------------------------------------------------------------------
+
+template<size_t N, bool Fixed>
+void arity_select_row(const char* label, size_t selections)
+{
+    using ec_t = monte_carlo::uniform_exploration_constant<double>;
+
+    constexpr size_t parents = 4096;
+
+    std::mt19937                           rng(11);
+    std::uniform_real_distribution<double> mean(0.0, 1.0);
+    std::uniform_int_distribution<size_t>  visits(1, 100);
+    std::vector<monte_carlo::ucb_child<double>> children(parents * N);
+    for (auto& child : children)
+    {
+        child.exploit = mean(rng);
+        child.n       = visits(rng);
+        child.v       = child.n;
+    }
+
+    ec_t                            ec(1.4);
+    monte_carlo::ucb1<double, ec_t> select(ec);
+
+    volatile size_t opaque = N;   // keeps the run-time count unknown to the compiler
+    const size_t    n      = opaque;
+    size_t          sum    = 0;
+
+    const auto t0 = clock_type::now();
+    for (size_t s = 0; s < selections; ++s)
+    {
+        const size_t p     = s % parents;
+        auto         stats = [&](size_t i) { return children[p * N + i]; };
+
+        monte_carlo::ucb_selection selection;
+        if constexpr (Fixed)
+            selection = monte_carlo::select_child(select, p, 1000, std::integral_constant<size_t, N>{},
+                                                  std::numeric_limits<double>::infinity(), stats);
+        else
+            selection = monte_carlo::select_child(select, p, 1000, n,
+                                                  std::numeric_limits<double>::infinity(), stats);
+        sum += selection.index;
+    }
+    const double seconds = seconds_since(t0);
+
+    std::cout << "  " << std::left << std::setw(28) << label << std::right << std::fixed
+              << std::setprecision(1) << std::setw(8) << seconds * 1e9 / static_cast<double>(selections)
+              << " ns/select   (checksum " << sum % 1000 << ")\n";
+}
+
+template<typename Choices>
+void arity_sim_row(const char* label, const Choices& choices, size_t sims)
+{
+    using visits_t  = monte_carlo::visits_table<uint64_t, std::unordered_map>;
+    using value_t   = monte_carlo::value_table<uint64_t, double, std::unordered_map>;
+    using ec_t      = monte_carlo::uniform_exploration_constant<double>;
+    using rollout_t = monte_carlo::random_rollout<int, std::mt19937, Choices, Choices>;
+    using sim_t     = monte_carlo::sim<
+        uint64_t, int, double,
+        visits_t, value_t, visits_t, value_t,
+        hashed_walker, Choices, Choices, rollout_t,
+        monte_carlo::uniform_value_delta<double>, ec_t>;
+
+    constexpr size_t depth = 6;
+
+    std::mt19937  rng(12);
+    visits_t      visits;
+    value_t       value;
+    hashed_walker walker;
+    rollout_t     rollout(rng);
+    ec_t          ec(0.5);
+    monte_carlo::uniform_value_delta<double> delta;
+
+    const uint64_t root = monte_carlo::hash_mix(13);
+    sim_t          s(visits, value, visits, value, walker, rollout, delta, ec, root);
+
+    const auto t0 = clock_type::now();
+    for (size_t i = 0; i < sims; ++i)
+    {
+        uint64_t h = root;
+        for (size_t d = 0; d < depth; ++d)
+            h = walker.walk(h, s.choose(choices, choices));
+        delta.set_value(hashed_game::reward(h));
+        s.terminate();
+        s.reset(root);
+    }
+    const double seconds = seconds_since(t0);
+
+    std::cout << "  " << std::left << std::setw(28) << label << std::right << std::fixed
+              << std::setprecision(0) << std::setw(8) << seconds * 1e9 / static_cast<double>(sims)
+              << " ns/sim    root visits " << visits.get_visits(root) << "\n";
+}
+
+void bench_arity()
+{
+    constexpr size_t selections = 20000000;
+    constexpr size_t sims       = 300000;
+
+    std::cout << "arity: select_child over N visited children, " << selections << " selections\n";
+    arity_select_row<4, false>("N=4, size_t count", selections);
+    arity_select_row<4, true>("N=4, integral_constant", selections);
+    arity_select_row<8, false>("N=8, size_t count", selections);
+    arity_select_row<8, true>("N=8, integral_constant", selections);
+
+    const std::vector<int>   vector = {0, 1, 2, 3, 4, 5, 6, 7};
+    const std::array<int, 8> array  = {0, 1, 2, 3, 4, 5, 6, 7};
+
+    std::cout << "arity: sim on the hashed game (depth 6, 8 choices), " << sims << " sims\n";
+    arity_sim_row("std::vector<int>", vector, sims);
+    arity_sim_row("std::array<int, 8>", array, sims);
+    arity_sim_row("choice_span<int, 8>", monte_carlo::choice_span<int, 8>(array), sims);
+}
+
+// ---------------------------------------------------------------------------
+// prefetch: child-entry prefetch on a table far larger than the last-level
+// cache.  One compact_stats_table over incremental_hash_map (16-byte slots)
+// holds many independent trees (hashed game, 16 choices), each pre-filled
+// to depth 3 with visited nodes (4369 per tree), so a scan at depths 0-2
+// reads 16 visited children that are almost never cached.  Each tree is
+// then searched by 20 sims (depth 8, c=0.5).  Half the trees are searched
+// through a view of the table without prefetch(), the other half with it.
+// Reports ns/sim for 50 trees (about 7 MB, cache-resident; 40 rounds over
+// the same trees) and for 4000 (about 1 GB of slots, one round).
+// ---------------------------------------------------------------------------
+
+using prefetch_table_t = monte_carlo::compact_stats_table<uint64_t, double, monte_carlo::incremental_hash_map>;
+
+// Forwards the table without its prefetch(), so the engines take the plain path.
+struct unhinted_table
+{
+    prefetch_table_t& table;
+
+    size_t get_visits(const uint64_t& h) const       { return table.get_visits(h); }
+    double get_value(const uint64_t& h) const        { return table.get_value(h); }
+    void   set_visits(const uint64_t& h, size_t v)   { table.set_visits(h, v); }
+    void   set_value(const uint64_t& h, double v)    { table.set_value(h, v); }
+};
+
+uint64_t prefetch_root(size_t tree) { return monte_carlo::hash_mix(0xfeed0000 + tree); }
+
+// Writes h's subtree down to `levels` below it; returns h's visits.
+size_t prefetch_fill(prefetch_table_t& table, const hashed_game& game, uint64_t h, size_t levels)
+{
+    size_t visits = 1;
+    if (levels > 0)
+        for (int c : game.choices)
+            visits += prefetch_fill(table, game, hashed_walker{}.walk(h, c), levels - 1);
+    table.set_visits(h, visits);
+    table.set_value(h, static_cast<double>(visits) * hashed_game::reward(h));
+    return visits;
+}
+
+template<typename Table>
+double prefetch_run(Table& table, const hashed_game& game, size_t first, size_t trees, size_t sims)
+{
+    using ec_t  = monte_carlo::uniform_exploration_constant<double>;
+    using sim_t = monte_carlo::sim<
+        uint64_t, int, double,
+        Table, Table, Table, Table,
+        hashed_walker, std::vector<int>, std::vector<int>, edge_rollout_t,
+        monte_carlo::uniform_value_delta<double>, ec_t>;
+
+    std::mt19937   rng(14);
+    hashed_walker  walker;
+    edge_rollout_t rollout(rng);
+    ec_t           ec(0.5);
+    monte_carlo::uniform_value_delta<double> delta;
+
+    const auto t0 = clock_type::now();
+    for (size_t k = first; k < first + trees; ++k)
+    {
+        const uint64_t root = prefetch_root(k);
+        sim_t          s(table, table, table, table, walker, rollout, delta, ec, root);
+        for (size_t i = 0; i < sims; ++i)
+        {
+            uint64_t h = root;
+            for (size_t d = 0; d < game.depth; ++d)
+                h = walker.walk(h, s.choose(game.choices, game.choices));
+            delta.set_value(hashed_game::reward(h));
+            s.terminate();
+            s.reset(root);
+        }
+    }
+    return seconds_since(t0) * 1e9 / static_cast<double>(trees * sims);
+}
+
+void prefetch_row(const char* label, size_t trees, size_t sims, size_t rounds)
+{
+    const hashed_game game(8, 16);
+
+    prefetch_table_t table;
+    table.reserve(trees * (4369 + 8 * sims));
+    for (size_t k = 0; k < trees; ++k)
+        prefetch_fill(table, game, prefetch_root(k), 3);
+
+    // Rounds alternate the two halves, so drift on the machine hits both.
+    unhinted_table plain{table};
+    double         plain_ns  = 0.0;
+    double         hinted_ns = 0.0;
+    for (size_t r = 0; r < rounds; ++r)
+    {
+        plain_ns  += prefetch_run(plain, game, 0, trees / 2, sims) / static_cast<double>(rounds);
+        hinted_ns += prefetch_run(table, game, trees / 2, trees / 2, sims) / static_cast<double>(rounds);
+    }
+
+    std::cout << "  " << std::left << std::setw(20) << label << std::right << std::fixed
+              << std::setprecision(0) << std::setw(8) << plain_ns << " ns/sim plain"
+              << std::setw(8) << hinted_ns << " ns/sim prefetch  ("
+              << std::setprecision(2) << plain_ns / hinted_ns << "x)\n";
+}
+
+void bench_prefetch()
+{
+    constexpr size_t sims = 20;
+
+    std::cout << "prefetch: sim on compact_stats_table<incremental_hash_map>, "
+              << sims << " sims per tree (pre-filled to depth 3, 16 choices)\n";
+    prefetch_row("50 trees (7 MB)", 50, sims, 40);
+    prefetch_row("4000 trees (1 GB)", 4000, sims, 1);
+}
+
+// ---------------------------------------------------------------------------
+// layout: relayout_tree on tables whose entries were created out of tree
+// order.  Many independent trees (hashed game, 16 choices, pre-filled to
+// depth 3 as for prefetch) are written into one compact_stats_table over a
+// std::pmr::unordered_map on a search_arena, in shuffled order, as a long
+// search leaves them.  relayout_tree then copies every tree into a second
+// table on a fresh arena, and each tree is searched by 20 sims in both.
+// Reports the copy time, ns/sim and, where the kernel exposes hardware
+// counters, cache and dTLB read misses per sim; on machines without a PMU
+// (most VMs) perf_event_open fails and the counts read n/a.
+// ---------------------------------------------------------------------------
+
+using layout_table_t = monte_carlo::compact_stats_table<uint64_t, double, std::pmr::unordered_map>;
+
+// One hardware counter for the calling thread, or none if the event cannot
+// be opened here.
+struct perf_counter
+{
+    perf_counter(uint32_t type, uint64_t config)
+    {
+        perf_event_attr attr{};
+        attr.size           = sizeof(attr);
+        attr.type           = type;
+        attr.config         = config;
+        attr.disabled       = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    ~perf_counter()
+    {
+        if (fd_ >= 0)
+            close(fd_);
+    }
+
+    perf_counter(const perf_counter&)            = delete;
+    perf_counter& operator=(const perf_counter&) = delete;
+
+    bool available() const { return fd_ >= 0; }
+
+    void start()
+    {
+        if (fd_ < 0)
+            return;
+        ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+    }
+
+    uint64_t stop()
+    {
+        uint64_t count = 0;
+        if (fd_ < 0)
+            return count;
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd_, &count, sizeof(count)) != sizeof(count))
+            count = 0;
+        return count;
+    }
+
+private:
+    int fd_;
+};
+
+// Appends h's subtree down to `levels` below it; returns h's visits.
+size_t layout_collect(std::vector<std::pair<uint64_t, size_t>>& out, const hashed_game& game,
+                      uint64_t h, size_t levels)
+{
+    size_t visits = 1;
+    if (levels > 0)
+        for (int c : game.choices)
+            visits += layout_collect(out, game, hashed_walker{}.walk(h, c), levels - 1);
+    out.emplace_back(h, visits);
+    return visits;
+}
+
+struct layout_counts
+{
+    double ns;
+    double cache_misses;   // per sim, or -1 if the counter is unavailable
+    double tlb_misses;
+};
+
+layout_counts layout_run(layout_table_t& table, const hashed_game& game, size_t trees, size_t sims)
+{
+    perf_counter cache(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    perf_counter tlb(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB
+                                             | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                             | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    cache.start();
+    tlb.start();
+    const double ns = prefetch_run(table, game, 0, trees, sims);
+    const double n  = static_cast<double>(trees * sims);
+    const double cm = cache.available() ? static_cast<double>(cache.stop()) / n : -1.0;
+    const double tm = tlb.available() ? static_cast<double>(tlb.stop()) / n : -1.0;
+    return {ns, cm, tm};
+}
+
+void layout_row(const char* label, const layout_counts& c)
+{
+    auto count = [](double v)
+    {
+        std::ostringstream out;
+        if (v < 0)
+            out << "n/a";
+        else
+            out << std::fixed << std::setprecision(1) << v;
+        return out.str();
+    };
+    std::cout << "  " << std::left << std::setw(20) << label << std::right << std::fixed
+              << std::setprecision(0) << std::setw(8) << c.ns << " ns/sim"
+              << std::setw(10) << count(c.cache_misses) << " cache misses/sim"
+              << std::setw(10) << count(c.tlb_misses) << " dTLB misses/sim\n";
+}
+
+void bench_layout()
+{
+    constexpr size_t  trees = 2000;
+    constexpr size_t  sims  = 20;
+    const hashed_game game(8, 16);
+
+    std::cout << "layout: sim on compact_stats_table<pmr::unordered_map>, " << trees
+              << " trees pre-filled to depth 3 (16 choices), " << sims << " sims per tree\n";
+
+    std::vector<std::pair<uint64_t, size_t>> entries;
+    entries.reserve(trees * 4369);
+    for (size_t k = 0; k < trees; ++k)
+        layout_collect(entries, game, prefetch_root(k), 3);
+    std::shuffle(entries.begin(), entries.end(), std::mt19937(15));
+
+    monte_carlo::search_arena scattered_arena;
+    auto& scattered = scattered_arena.make<layout_table_t>(scattered_arena.resource());
+    scattered.reserve(entries.size() + trees * sims * game.depth);
+    for (const auto& [h, visits] : entries)
+    {
+        scattered.set_visits(h, visits);
+        scattered.set_value(h, static_cast<double>(visits) * hashed_game::reward(h));
+    }
+    entries = {};
+
+    monte_carlo::search_arena compacted_arena;
+    auto& compacted = compacted_arena.make<layout_table_t>(compacted_arena.resource());
+    compacted.reserve(trees * 4369 + trees * sims * game.depth);
+    hashed_walker walker;
+    size_t        placed = 0;
+    const auto    t0     = clock_type::now();
+    for (size_t k = 0; k < trees; ++k)
+        placed += monte_carlo::relayout_tree(
+            scattered, scattered, compacted, compacted, walker,
+            [&](uint64_t) -> const std::vector<int>& { return game.choices; }, prefetch_root(k));
+    const double copy_ns = seconds_since(t0) * 1e9 / static_cast<double>(placed);
+
+    std::cout << "  relayout_tree: " << placed << " nodes, " << std::fixed << std::setprecision(0)
+              << copy_ns << " ns/node\n";
+    layout_row("insertion order", layout_run(scattered, game, trees, sims));
+    layout_row("relayout_tree", layout_run(compacted, game, trees, sims));
+}
+
+// ---------------------------------------------------------------------------
+// solver: MCTS-Solver (proof_table) against plain UCB1 on endgame-sized trees
+// with exact terminal rewards (depth 4, 6 choices per node; each seed is a
+// different game).  Reports the % of games whose root move is optimal after
+// N sims, and how many sims the solver needs to prove the root.  Graded
+// rewards need every leaf; win/loss rewards with bound 1 stop at the first
+// proven win.
+// ---------------------------------------------------------------------------
+
+struct endgame
+{
+    static constexpr size_t depth     = 4;
+    static constexpr int    branching = 6;
+
+    static double graded(uint64_t leaf)   { return static_cast<double>(monte_carlo::hash_mix(leaf) % 1000) / 1000.0; }
+    static double win_loss(uint64_t leaf) { return monte_carlo::hash_mix(leaf) % 400 == 0 ? 1.0 : 0.0; }
+
+    // Exact value of node at depth d: its best leaf.
+    static double exact(uint64_t node, size_t d, double (*reward)(uint64_t))
+    {
+        if (d == depth)
+            return reward(node);
+        hashed_walker walker;
+        double        best = 0.0;
+        for (int c = 0; c < branching; ++c)
+            best = std::max(best, exact(walker.walk(node, c), d + 1, reward));
+        return best;
+    }
+};
+
+template<bool Solve>
+void solver_row(const char* label, double (*reward)(uint64_t), double bound,
+                const std::vector<size_t>& checkpoints, size_t seeds)
+{
+    using visits_t  = monte_carlo::visits_table<uint64_t, std::unordered_map>;
+    using value_t   = monte_carlo::value_table<uint64_t, double, std::unordered_map>;
+    using proofs_t  = monte_carlo::proof_table<uint64_t, double, value_t, std::unordered_map>;
+    using table_t   = std::conditional_t<Solve, proofs_t, value_t>;
+    using choices_t = std::vector<int>;
+    using rollout_t = monte_carlo::random_rollout<int, std::mt19937, choices_t, choices_t>;
+    using ec_t      = monte_carlo::uniform_exploration_constant<double>;
+
+    choices_t choices(endgame::branching);
+    std::iota(choices.begin(), choices.end(), 0);
+
+    std::vector<size_t> correct(checkpoints.size(), 0);
+    size_t              solved      = 0;
+    size_t              solved_sims = 0;
+
+    for (size_t seed = 0; seed < seeds; ++seed)
+    {
+        const uint64_t root = monte_carlo::hash_mix(seed + 1);
+        hashed_walker  walker;
+
+        const double optimal = endgame::exact(root, 0, reward);
+
+        visits_t     visits;
+        value_t      value;
+        proofs_t     proofs(value, monte_carlo::proof_backup::max, bound);
+        table_t&     table = [&]() -> table_t& { if constexpr (Solve) return proofs; else return value; }();
+        std::mt19937 rng(static_cast<unsigned>(seed));
+        ec_t         ec(0.5);
+
+        size_t sims = 0;
+        bool   done = false;
+        for (size_t k = 0; k < checkpoints.size(); ++k)
+        {
+            for (; sims < checkpoints[k] && !done; ++sims)
+            {
+                rollout_t rollout(rng);
+                monte_carlo::uniform_value_delta<double> delta;
+
+                monte_carlo::sim<
+                    uint64_t, int, double,
+                    visits_t, table_t, visits_t, table_t,
+                    hashed_walker,
+                    choices_t, choices_t,
+                    rollout_t,
+                    monte_carlo::uniform_value_delta<double>,
+                    ec_t
+                > s(visits, table, visits, table, walker, rollout, delta, ec, root);
+
+                uint64_t node = root;
+                for (size_t d = 0; d < endgame::depth; ++d)
+                    node = walker.walk(node, s.choose(choices, choices));
+                delta.set_value(reward(node));
+                s.terminate();
+
+                if (s.solved())
+                {
+                    done = true;
+                    ++solved;
+                    solved_sims += sims + 1;
+                }
+            }
+
+            // Root move: the best proven child once solved, else the most visited.
+            uint64_t best   = walker.walk(root, 0);
+            double   best_s = -1.0;
+            for (int c = 0; c < endgame::branching; ++c)
+            {
+                const uint64_t child = walker.walk(root, c);
+                double         score = static_cast<double>(visits.get_visits(child));
+                if constexpr (Solve)
+                    if (done)
+                        score = proofs.get_proven_value(child);
+                if (score > best_s)
+                {
+                    best_s = score;
+                    best   = child;
+                }
+            }
+            correct[k] += endgame::exact(best, 1, reward) == optimal;
+        }
+    }
+
+    std::cout << "  " << std::left << std::setw(20) << label << std::right;
+    for (size_t c : correct)
+        std::cout << std::setw(7) << 100 * c / seeds << "%";
+    if (Solve)
+        std::cout << "   solved " << solved << "/" << seeds << ", mean "
+                  << (solved == 0 ? 0 : solved_sims / solved) << " sims";
+    std::cout << "\n";
+}
+
+void bench_solver()
+{
+    const std::vector<size_t> checkpoints = {250, 500, 1000, 2000, 4000, 8000};
+    constexpr size_t          seeds       = 50;
+    constexpr double          inf         = std::numeric_limits<double>::infinity();
+
+    std::cout << "solver: % of " << seeds << " games (depth " << endgame::depth << ", "
+              << endgame::branching << " choices, "
+              << "1296 leaves) with the optimal root move after N sims, c=0.5\n";
+    std::cout << "  " << std::setw(20) << "";
+    for (size_t n : checkpoints)
+        std::cout << std::setw(8) << n;
+    std::cout << "\n";
+
+    solver_row<false>("graded, ucb1",      endgame::graded,   inf, checkpoints, seeds);
+    solver_row<true>("graded, solver",     endgame::graded,   inf, checkpoints, seeds);
+    solver_row<false>("win/loss, ucb1",    endgame::win_loss, inf, checkpoints, seeds);
+    solver_row<true>("win/loss, solver",   endgame::win_loss, 1.0, checkpoints, seeds);
+}
+
+// ---------------------------------------------------------------------------
+// reuse: heap allocations and time per simulation in steady state on a track
+// game (length 60, jumps 1-6, int position handles, reserved unordered_map
+// tables, so after a warm-up no sim adds a node).  A sim constructed per
+// episode against one kept and reset(); dbuct with its frames inline
+// (MaxDepth 64) against frames that spill past depth 4, both reset to the
+// root every 100 sims as a training loop moving between searches would.
+// Then the same engines run by search_driver over a game model.
+// ---------------------------------------------------------------------------
+
+void reuse_row(const char* label, size_t sims, size_t allocs, double seconds, size_t moves = 0)
+{
+    std::cout << "  " << std::left << std::setw(30) << label << std::right
+              << std::fixed << std::setprecision(2) << std::setw(7)
+              << static_cast<double>(allocs) / static_cast<double>(sims) << " allocs/sim  "
+              << std::setprecision(0) << std::setw(6)
+              << seconds * 1e9 / static_cast<double>(sims) << " ns/sim";
+    if (moves != 0)
+        std::cout << std::setprecision(1) << std::setw(8)
+                  << static_cast<double>(moves) / static_cast<double>(sims) << " moves/sim";
+    std::cout << "\n";
+}
+
+// Runs `warmup` then `sims` calls of episode(i), measuring the latter.
+template<typename Episode>
+void reuse_measure(const char* label, size_t warmup, size_t sims, Episode episode)
+{
+    for (size_t i = 0; i < warmup; ++i)
+        episode(i);
+
+    const size_t a0 = g_alloc_count.load();
+    const auto   t0 = clock_type::now();
+    for (size_t i = 0; i < sims; ++i)
+        episode(warmup + i);
+    const double seconds = seconds_since(t0);
+    reuse_row(label, sims, g_alloc_count.load() - a0, seconds);
+}
+
+template<bool Reuse>
+void reuse_sim_row(const char* label, const track_game& game, size_t warmup, size_t sims)
+{
+    using ec_t  = monte_carlo::uniform_exploration_constant<double>;
+    using sim_t = monte_carlo::sim<
+        int, int, double,
+        edge_visits_t, edge_value_t, edge_visits_t, edge_value_t,
+        track_walker,
+        std::vector<int>, std::vector<int>,
+        edge_rollout_t,
+        monte_carlo::uniform_value_delta<double>,
+        ec_t>;
+
+    std::mt19937                             rng(5);
+    edge_visits_t                            visits;
+    edge_value_t                             value;
+    track_walker                             walker{game.size()};
+    edge_rollout_t                           rollout(rng);
+    monte_carlo::uniform_value_delta<double> delta;
+    ec_t                                     ec(5.0);
+    visits.reserve(4 * game.track.size());
+    value.reserve(4 * game.track.size());
+
+    sim_t kept(visits, value, visits, value, walker, rollout, delta, ec, -1);
+    reuse_measure(label, warmup, sims, [&](size_t)
+    {
+        if constexpr (Reuse)
+        {
+            track_episode(kept, delta, game, walker, -1, [](int) {});
+            kept.reset(-1);
+        }
+        else
+        {
+            sim_t s(visits, value, visits, value, walker, rollout, delta, ec, -1);
+            track_episode(s, delta, game, walker, -1, [](int) {});
+        }
+    });
+}
+
+template<size_t MaxDepth>
+void reuse_dbuct_row(const char* label, const track_game& game, size_t warmup, size_t sims)
+{
+    using ec_t         = monte_carlo::uniform_exploration_constant<double>;
+    using dispatches_t = monte_carlo::dispatches_table<int, std::unordered_map>;
+    using batch_t      = monte_carlo::linear_batch_increment;
+    using dbuct_t      = monte_carlo::dbuct<
+        int, int, double,
+        edge_visits_t, edge_value_t, edge_visits_t, edge_value_t,
+        dispatches_t, dispatches_t,
+        batch_t,
+        track_walker,
+        std::vector<int>, std::vector<int>,
+        edge_rollout_t,
+        monte_carlo::uniform_value_delta<double>,
+        ec_t,
+        monte_carlo::no_edge_visits,
+        monte_carlo::no_accumulator,
+        MaxDepth>;
+
+    std::mt19937                             rng(5);
+    edge_visits_t                            visits;
+    edge_value_t                             value;
+    dispatches_t                             dispatches;
+    batch_t                                  batch(std::numeric_limits<size_t>::max());
+    track_walker                             walker{game.size()};
+    edge_rollout_t                           rollout(rng);
+    monte_carlo::uniform_value_delta<double> delta;
+    ec_t                                     ec(5.0);
+    visits.reserve(4 * game.track.size());
+    value.reserve(4 * game.track.size());
+    dispatches.reserve(4 * game.track.size());
+
+    dbuct_t d(visits, value, visits, value, dispatches, dispatches, batch,
+              walker, rollout, delta, ec, -1);
+
+    // Handles of the frames dbuct keeps between episodes, root first.
+    std::vector<int> path = {-1};
+    path.reserve(game.track.size() + 1);
+    reuse_measure(label, warmup, sims, [&](size_t i)
+    {
+        track_episode(d, delta, game, walker, path.back(), [&](int h) { path.push_back(h); });
+        path.resize(d.depth());
+        if (i % 100 == 99)
+        {
+            d.reset(-1);
+            path.resize(1);
+        }
+    });
+}
+
+// search_driver game model over a track game; positions are track_walker
+// handles, so a terminal position carries its reward.
+struct track_model
+{
+    const track_game& game;
+    int               pos   = -1;
+    size_t            moves = 0;   // apply() and undo() calls
+
+    int  root() const     { return -1; }
+    void restart()        { pos = -1; }
+    bool terminal() const { return track_terminal(game, pos); }
+
+    const std::vector<int>& choice_count() const { return game.jumps; }
+    const std::vector<int>& choice_at() const    { return game.jumps; }
+
+    void apply(int j)
+    {
+        pos = track_walker{game.size()}.walk(pos, j);
+        ++moves;
+    }
+
+    double reward() const { return track_reward(game, pos); }
+};
+
+// The same model made and unmade in place.
+struct track_undo_model : track_model
+{
+    std::vector<int> history = {};
+
+    void apply(int j)
+    {
+        history.push_back(pos);
+        track_model::apply(j);
+    }
+
+    void undo()
+    {
+        pos = history.back();
+        history.pop_back();
+        ++moves;
+    }
+};
+
+// Runs the driver 100 sims per run() call, reset() after each for dbuct;
+// tables are the dbuct-only constructor arguments.
+template<typename Engine, typename Model = track_model, typename... Tables>
+void reuse_driver_row(const char* label, const track_game& game, size_t warmup, size_t sims,
+                      Tables&... tables)
+{
+    std::mt19937                             rng(5);
+    edge_visits_t                            visits;
+    edge_value_t                             value;
+    track_walker                             walker{game.size()};
+    edge_rollout_t                           rollout(rng);
+    monte_carlo::uniform_value_delta<double> delta;
+    monte_carlo::uniform_exploration_constant<double> ec(5.0);
+    visits.reserve(4 * game.track.size());
+    value.reserve(4 * game.track.size());
+
+    Model model{{game}};
+    if constexpr (requires { model.history; })
+        model.history.reserve(game.track.size() + 1);
+
+    monte_carlo::search_driver<Engine, Model, monte_carlo::uniform_value_delta<double>> driver(
+        model, delta, visits, value, visits, value, tables..., walker, rollout, delta, ec, -1);
+
+    auto chunk = [&]
+    {
+        driver.run(100);
+        if constexpr (sizeof...(Tables) != 0)
+            driver.reset();
+    };
+    for (size_t i = 0; i < warmup; i += 100)
+        chunk();
+
+    const size_t m0 = model.moves;
+    const size_t a0 = g_alloc_count.load();
+    const auto   t0 = clock_type::now();
+    for (size_t i = 0; i < sims; i += 100)
+        chunk();
+    const double seconds = seconds_since(t0);
+    reuse_row(label, sims, g_alloc_count.load() - a0, seconds, model.moves - m0);
+}
+
+void bench_reuse()
+{
+    constexpr size_t warmup = 20000;
+    constexpr size_t sims   = 100000;
+
+    const track_game game(1000, 60, {1, 2, 3, 4, 5, 6});
+
+    std::cout << "reuse: steady-state allocations and time per sim after " << warmup
+              << " warm-up sims, track game (length 60, jumps 1-6, c=5)\n";
+    reuse_sim_row<false>("sim, new per episode",       game, warmup, sims);
+    reuse_sim_row<true>("sim, kept + reset()",         game, warmup, sims);
+    reuse_dbuct_row<64>("dbuct, MaxDepth 64",          game, warmup, sims);
+    reuse_dbuct_row<4>("dbuct, MaxDepth 4 (spills)",   game, warmup, sims);
+
+    using ec_t         = monte_carlo::uniform_exploration_constant<double>;
+    using dispatches_t = monte_carlo::dispatches_table<int, std::unordered_map>;
+    using batch_t      = monte_carlo::linear_batch_increment;
+    using sim_t        = monte_carlo::sim<
+        int, int, double,
+        edge_visits_t, edge_value_t, edge_visits_t, edge_value_t,
+        track_walker,
+        std::vector<int>, std::vector<int>,
+        edge_rollout_t,
+        monte_carlo::uniform_value_delta<double>,
+        ec_t>;
+    using dbuct_t      = monte_carlo::dbuct<
+        int, int, double,
+        edge_visits_t, edge_value_t, edge_visits_t, edge_value_t,
+        dispatches_t, dispatches_t,
+        batch_t,
+        track_walker,
+        std::vector<int>, std::vector<int>,
+        edge_rollout_t,
+        monte_carlo::uniform_value_delta<double>,
+        ec_t>;
+
+    dispatches_t restarted, undone;
+    batch_t      batch(20);
+    reuse_driver_row<sim_t>("search_driver<sim>",                 game, warmup, sims);
+    reuse_driver_row<sim_t, track_undo_model>("  with undo()",    game, warmup, sims);
+    reuse_driver_row<dbuct_t>("search_driver<dbuct>, B=20",       game, warmup, sims,
+                              restarted, restarted, batch);
+    reuse_driver_row<dbuct_t, track_undo_model>("  with undo()",  game, warmup, sims,
+                                                undone, undone, batch);
+}
+
+// ---------------------------------------------------------------------------
+// pool: many small independent searches, one per session, each with its own
+// tables, model and random engine (track game, length 60, jumps 1-6), all
+// started at once with the same simulation budget.  One std::thread per
+// search against one search_pool with a worker per hardware thread, at two
+// slice sizes (a slice as large as the budget runs each search to the end
+// in turn).  Reports aggregate sims/s and each search's latency from the
+// common start to its last simulation.
+// ---------------------------------------------------------------------------
+
+using pool_sim_t = monte_carlo::sim<
+    int, int, double,
+    edge_visits_t, edge_value_t, edge_visits_t, edge_value_t,
+    track_walker,
+    std::vector<int>, std::vector<int>,
+    edge_rollout_t,
+    monte_carlo::uniform_value_delta<double>,
+    monte_carlo::uniform_exploration_constant<double>>;
+
+using pool_driver_t = monte_carlo::search_driver<pool_sim_t, track_model, monte_carlo::uniform_value_delta<double>>;
+
+struct pool_session
+{
+    edge_visits_t                                     visits;
+    edge_value_t                                      value;
+    std::mt19937                                      rng;
+    track_walker                                      walker;
+    edge_rollout_t                                    rollout;
+    monte_carlo::uniform_value_delta<double>          delta;
+    monte_carlo::uniform_exploration_constant<double> ec;
+    track_model                                       model;
+    pool_driver_t                                     driver;
+
+    pool_session(const track_game& game, unsigned seed)
+        : rng(seed)
+        , walker{game.size()}
+        , rollout(rng)
+        , ec(5.0)
+        , model{game}
+        , driver(model, delta, visits, value, visits, value, walker, rollout, delta, ec, -1)
+    {}
+};
+
+void pool_row(const char* label, size_t threads, std::vector<double>& millis, size_t budget, double seconds)
+{
+    std::sort(millis.begin(), millis.end());
+    auto pct = [&](double p) { return millis[static_cast<size_t>(p * static_cast<double>(millis.size() - 1))]; };
+
+    std::cout << "  " << std::left << std::setw(26) << label << std::right
+              << std::setw(6) << threads << " threads"
+              << std::fixed << std::setprecision(0)
+              << std::setw(10) << static_cast<double>(millis.size() * budget) / seconds << " sims/s"
+              << std::setprecision(1)
+              << "  latency p50 " << std::setw(7) << pct(0.50)
+              << "  p99 " << std::setw(7) << pct(0.99)
+              << "  max " << std::setw(7) << millis.back() << " ms\n";
+}
+
+std::vector<std::unique_ptr<pool_session>> pool_sessions(const track_game& game, size_t searches)
+{
+    std::vector<std::unique_ptr<pool_session>> sessions;
+    for (size_t k = 0; k < searches; ++k)
+        sessions.push_back(std::make_unique<pool_session>(game, static_cast<unsigned>(k)));
+    return sessions;
+}
+
+void pool_threads_row(const track_game& game, size_t searches, size_t budget)
+{
+    auto                sessions = pool_sessions(game, searches);
+    std::vector<double> millis(searches);
+
+    std::vector<std::thread> threads;
+    const auto               t0 = clock_type::now();
+    for (size_t k = 0; k < searches; ++k)
+        threads.emplace_back([&, k]
+        {
+            sessions[k]->driver.run(budget);
+            millis[k] = seconds_since(t0) * 1e3;
+        });
+    for (std::thread& t : threads)
+        t.join();
+    pool_row("thread per search", searches, millis, budget, seconds_since(t0));
+}
+
+void pool_pool_row(const char* label, const track_game& game, size_t searches, size_t budget, size_t slice)
+{
+    auto                sessions = pool_sessions(game, searches);
+    std::vector<double> millis(searches);
+    const size_t        workers  = std::max(1u, std::thread::hardware_concurrency());
+
+    monte_carlo::search_pool<pool_driver_t> pool(workers, slice);
+    std::vector<size_t>                     tickets;
+    const auto                              t0 = clock_type::now();
+    for (auto& s : sessions)
+        tickets.push_back(pool.submit(s->driver, budget));
+    for (size_t k = 0; k < searches; ++k)
+        millis[k] = std::chrono::duration<double, std::milli>(pool.wait(tickets[k]).latency).count();
+    pool_row(label, workers, millis, budget, seconds_since(t0));
+}
+
+void bench_pool()
+{
+    constexpr size_t searches = 1000;
+    constexpr size_t budget   = 1000;
+
+    const track_game game(1000, 60, {1, 2, 3, 4, 5, 6});
+
+    std::cout << "pool: " << searches << " independent searches of " << budget
+              << " sims each, track game (length 60, jumps 1-6, c=5), "
+              << std::thread::hardware_concurrency() << " hardware threads\n";
+    pool_threads_row(game, searches, budget);
+    pool_pool_row("search_pool, slice 64", game, searches, budget, 64);
+    pool_pool_row("search_pool, slice 1000", game, searches, budget, budget);
+}
+
+struct benchmark
+{
+    const char*           name;
+    std::function<void()> run;
+};
+
+const std::vector<benchmark>& benchmarks()
+{
+    static const std::vector<benchmark> all = {
+        {"spill",     bench_spill},
+        {"freeze",    bench_freeze},
+        {"compact",   bench_compact},
+        {"arena",     bench_arena},
+        {"latency",   bench_latency},
+        {"edges",     bench_edges},
+        {"edgetable", bench_edgetable},
+        {"widening",  bench_widening},
+        {"fpu",       bench_fpu},
+        {"argmax",    bench_argmax},
+        {"select",    bench_select},
+        {"solver",    bench_solver},
+        {"earlystop", bench_earlystop},
+        {"halving",   bench_halving},
+        {"rave",      bench_rave},
+        {"batch",     bench_batch},
+        {"reuse",     bench_reuse},
+        {"prefix",    bench_prefix},
+        {"forced",    bench_forced},
+        {"arity",     bench_arity},
+        {"prefetch",  bench_prefetch},
+        {"layout",    bench_layout},
+        {"pool",      bench_pool},
+    };
+    return all;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    for (const benchmark& b : benchmarks())
+    {
+        bool selected = argc == 1;
+        for (int i = 1; i < argc; ++i)
+            selected = selected || std::strcmp(argv[i], b.name) == 0;
+        if (!selected)
+            continue;
+
+        b.run();
+        std::cout << "\n";
+    }
+    return 0;
+}
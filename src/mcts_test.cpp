@@ -1,9 +1,14 @@
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <future>
 #include <iomanip>
 #include <iostream>
 #include <limits>
 #include <map>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
 #include <random>
 #include <unordered_map>
 #include <vector>
@@ -1562,3 +1567,4676 @@ TEST_F(DbuctBudgetInvariantTest, ParentBudgetGteChildBudgetAcrossLongRun)
     }
 }
 #endif
+
+// ---------------------------------------------------------------------------
+// SpillMapTest
+//
+// spill_map keeps hot_capacity entries resident and pages the rest to a
+// memory-mapped file.  Tables backed by it must behave exactly like tables
+// backed by std::unordered_map: same zero-default reads, same stats after an
+// identical sequence of sim episodes.
+// ---------------------------------------------------------------------------
+class SpillMapTest : public ::testing::Test
+{
+protected:
+    using spill_visits_t = monte_carlo::visits_table<int, monte_carlo::spill_map>;
+    using spill_value_t  = monte_carlo::value_table<int, double, monte_carlo::spill_map>;
+    using visits_t       = monte_carlo::visits_table<int, std::unordered_map>;
+    using value_t        = monte_carlo::value_table<int, double, std::unordered_map>;
+    using rollout_t      = monte_carlo::random_rollout<
+                              jump_t, std::mt19937,
+                              std::vector<jump_t>, std::vector<jump_t>>;
+
+    template<typename IVisits, typename IValue>
+    void sim_episode(IVisits&                   visits,
+                     IValue&                    value,
+                     const std::vector<double>& track,
+                     const std::vector<jump_t>& jumps,
+                     std::mt19937&              rng,
+                     double                     c)
+    {
+        rollout_t       rollout(rng);
+        position_walker walker;
+        monte_carlo::uniform_value_delta<double>        delta;
+        monte_carlo::uniform_exploration_constant<double> ec(c);
+
+        monte_carlo::sim<
+            int, jump_t, double,
+            IVisits, IValue, IVisits, IValue,
+            position_walker,
+            std::vector<jump_t>, std::vector<jump_t>,
+            rollout_t,
+            monte_carlo::uniform_value_delta<double>,
+            monte_carlo::uniform_exploration_constant<double>
+        > s(visits, value, visits, value, walker, rollout, delta, ec, -1);
+
+        int    position = -1;
+        double reward   = 0.0;
+
+        while (true)
+        {
+            jump_t chosen = s.choose(jumps, jumps);
+            int    next   = position + chosen;
+            if (next >= static_cast<int>(track.size()))
+            {
+                delta.set_value(reward);
+                s.terminate();
+                break;
+            }
+            position = next;
+            reward   = track[position];
+        }
+    }
+};
+
+TEST_F(SpillMapTest, RoundTripsEntriesAcrossSpills)
+{
+    monte_carlo::spill_map<int, size_t> m(
+        monte_carlo::spill_config{.hot_capacity = 100, .cold_buckets = 4});
+
+    for (int k = 0; k < 10000; ++k)
+        m[k] = static_cast<size_t>(k) * 3 + 1;
+
+    EXPECT_LE(m.hot_size(), 100u);
+    EXPECT_GT(m.cold_size(), 0u);
+    EXPECT_EQ(m.size(), 10000u);
+
+    for (int k = 0; k < 10000; ++k)
+    {
+        auto it = m.find(k);
+        ASSERT_NE(it, m.end()) << "lost key=" << k;
+        EXPECT_EQ(it->second, static_cast<size_t>(k) * 3 + 1);
+    }
+    EXPECT_EQ(m.find(10000), m.end());
+
+    // Writing a cold entry promotes it and keeps its value.
+    m[0] += 1;
+    EXPECT_EQ(m.find(0)->second, 2u);
+    EXPECT_EQ(m.size(), 10000u);
+}
+
+// Sparse buckets empty out as their entries are promoted: the emptied pages
+// must leave the chains and be reused rather than grow the file.
+TEST_F(SpillMapTest, ChurnReusesEmptiedPagesSeed114)
+{
+    monte_carlo::spill_map<int, size_t> m(
+        monte_carlo::spill_config{.hot_capacity = 50, .cold_buckets = 1024});
+
+    std::mt19937                       rng(114);
+    std::uniform_int_distribution<int> key(0, 399);
+    std::vector<size_t>                expected(400, 0);
+    size_t                             peak_cold = 0;
+
+    for (int step = 0; step < 20000; ++step)
+    {
+        const int k = key(rng);
+        m[k] += 1;
+        ++expected[k];
+
+        peak_cold = std::max(peak_cold, m.cold_size());
+        ASSERT_LE(m.cold_pages(), m.cold_size()) << "empty page left linked, step=" << step;
+        ASSERT_LE(m.file_pages(), peak_cold) << "step=" << step;
+    }
+
+    for (int k = 0; k < 400; ++k)
+    {
+        auto it = m.find(k);
+        if (expected[k] == 0)
+            EXPECT_EQ(it, m.end());
+        else
+        {
+            ASSERT_NE(it, m.end()) << "lost key=" << k;
+            EXPECT_EQ(it->second, expected[k]);
+        }
+    }
+}
+
+TEST_F(SpillMapTest, TablesIterateHotAndColdEntriesAndFreeze)
+{
+    const monte_carlo::spill_config config{.hot_capacity = 100, .cold_buckets = 16};
+    monte_carlo::visits_table<int, monte_carlo::spill_map>        visits(config);
+    monte_carlo::value_table<int, double, monte_carlo::spill_map> value(config);
+
+    for (int k = 0; k < 5000; ++k)
+    {
+        visits.set_visits(k, static_cast<size_t>(k) + 1);
+        value.set_value(k, 0.5 * k);
+    }
+    // Promote some cold entries back into memory.
+    for (int k = 0; k < 5000; k += 7)
+        visits.set_visits(k, visits.get_visits(k) + 1);
+
+    std::map<int, size_t> seen;
+    visits.for_each([&](int h, size_t v) { EXPECT_TRUE(seen.emplace(h, v).second) << "twice: " << h; });
+    ASSERT_EQ(seen.size(), 5000u);
+    for (const auto& [h, v] : seen)
+        EXPECT_EQ(v, static_cast<size_t>(h) + 1 + (h % 7 == 0 ? 1 : 0)) << "h=" << h;
+
+    const auto frozen = monte_carlo::freeze<int, double>(visits, value);
+    for (int k = 0; k < 5000; k += 13)
+    {
+        EXPECT_EQ(frozen.get_visits(k), visits.get_visits(k));
+        EXPECT_DOUBLE_EQ(frozen.get_value(k), 0.5 * k);
+    }
+
+    monte_carlo::spill_map<int, size_t> empty;
+    EXPECT_TRUE(empty.begin() == empty.end());
+}
+
+TEST_F(SpillMapTest, LeastValueOrderKeepsLargeCountersHot)
+{
+    monte_carlo::spill_map<int, size_t> m(
+        monte_carlo::spill_config{.hot_capacity   = 10,
+                                  .spill_fraction = 0.5,
+                                  .order          = monte_carlo::spill_order::least_value});
+
+    m[-1] = 1000;
+    for (int k = 0; k < 100; ++k)
+        m[k] = 1;
+
+    EXPECT_EQ(m.find(-1)->second, 1000u);
+    EXPECT_EQ(m.size(), 101u);
+    EXPECT_LE(m.hot_size(), 10u);
+}
+
+TEST_F(SpillMapTest, MatchesUnorderedTablesSeed60Track30Moves123)
+{
+    std::mt19937                           track_rng(60);
+    std::uniform_real_distribution<double> urd(-10, 10);
+    std::vector<double>                    track(30);
+    std::generate(track.begin(), track.end(), [&] { return urd(track_rng); });
+    const std::vector<jump_t> jumps = {1, 2, 3};
+
+    const monte_carlo::spill_config cfg{.hot_capacity = 8, .cold_buckets = 4};
+
+    std::mt19937   rng1(60), rng2(60);
+    visits_t       visits;
+    value_t        value;
+    spill_visits_t spill_visits(cfg);
+    spill_value_t  spill_value(cfg);
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        sim_episode(visits, value, track, jumps, rng1, 10.0);
+        sim_episode(spill_visits, spill_value, track, jumps, rng2, 10.0);
+    }
+
+    for (int pos = -1; pos < static_cast<int>(track.size()) + 3; ++pos)
+    {
+        EXPECT_EQ(visits.get_visits(pos), spill_visits.get_visits(pos))
+            << "visits mismatch at pos=" << pos;
+        EXPECT_DOUBLE_EQ(value.get_value(pos), spill_value.get_value(pos))
+            << "value mismatch at pos=" << pos;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// FrozenStatsTableTest
+//
+// freeze() snapshots trained tables into a minimal-perfect-hash layout.  The
+// frozen table must answer every trained handle with the trained stats
+// (value narrowed to float), answer unseen handles with zero, and support a
+// greedy read-only walk to the optimal terminal reward.
+// ---------------------------------------------------------------------------
+class FrozenStatsTableTest : public ::testing::Test
+{
+protected:
+    using visits_t  = monte_carlo::visits_table<int, std::unordered_map>;
+    using value_t   = monte_carlo::value_table<int, double, std::unordered_map>;
+    using rollout_t = monte_carlo::random_rollout<
+                         jump_t, std::mt19937,
+                         std::vector<jump_t>, std::vector<jump_t>>;
+
+    void train(visits_t&                  visits,
+               value_t&                   value,
+               const std::vector<double>& track,
+               const std::vector<jump_t>& jumps,
+               std::mt19937&              rng,
+               int                        training_sims)
+    {
+        for (int i = 0; i < training_sims; ++i)
+        {
+            rollout_t       rollout(rng);
+            position_walker walker;
+            monte_carlo::uniform_value_delta<double>        delta;
+            monte_carlo::uniform_exploration_constant<double> ec(100.0);
+
+            monte_carlo::sim<
+                int, jump_t, double,
+                visits_t, value_t, visits_t, value_t,
+                position_walker,
+                std::vector<jump_t>, std::vector<jump_t>,
+                rollout_t,
+                monte_carlo::uniform_value_delta<double>,
+                monte_carlo::uniform_exploration_constant<double>
+            > s(visits, value, visits, value, walker, rollout, delta, ec, -1);
+
+            int    position = -1;
+            double reward   = 0.0;
+
+            while (true)
+            {
+                jump_t chosen = s.choose(jumps, jumps);
+                int    next   = position + chosen;
+                if (next >= static_cast<int>(track.size()))
+                {
+                    delta.set_value(reward);
+                    s.terminate();
+                    break;
+                }
+                position = next;
+                reward   = track[position];
+            }
+        }
+    }
+
+    // Greedy read-only walk: highest mean child until the next move leaves the track.
+    template<typename IStats>
+    double greedy_reward(const IStats&              stats,
+                         const std::vector<double>& track,
+                         const std::vector<jump_t>& jumps)
+    {
+        int    position = -1;
+        double reward   = 0.0;
+
+        while (true)
+        {
+            double best_mean = -std::numeric_limits<double>::infinity();
+            jump_t best      = jumps.front();
+            for (jump_t j : jumps)
+            {
+                const size_t v = stats.get_visits(position + j);
+                if (v == 0)
+                    continue;
+                const double mean = stats.get_value(position + j) / static_cast<double>(v);
+                if (mean > best_mean)
+                {
+                    best_mean = mean;
+                    best      = j;
+                }
+            }
+
+            const int next = position + best;
+            if (next >= static_cast<int>(track.size()))
+                return reward;
+            position = next;
+            reward   = track[position];
+        }
+    }
+};
+
+TEST_F(FrozenStatsTableTest, MatchesTrainedTablesSeed46Track15Moves123)
+{
+    std::mt19937                           rng(46);
+    std::uniform_real_distribution<double> urd(-10, 10);
+    std::vector<double>                    track(15);
+    std::generate(track.begin(), track.end(), [&] { return urd(rng); });
+    const std::vector<jump_t> jumps = {1, 2, 3};
+
+    visits_t visits;
+    value_t  value;
+    train(visits, value, track, jumps, rng, 20000);
+
+    const auto frozen = monte_carlo::freeze<int, double>(visits, value);
+
+    size_t trained = 0;
+    visits.for_each([&](const int& h, size_t v)
+    {
+        ++trained;
+        EXPECT_EQ(frozen.get_visits(h), v) << "visits mismatch at pos=" << h;
+        EXPECT_FLOAT_EQ(static_cast<float>(frozen.get_value(h)),
+                        static_cast<float>(value.get_value(h)))
+            << "value mismatch at pos=" << h;
+    });
+    EXPECT_EQ(frozen.size(), trained);
+
+    EXPECT_EQ(frozen.get_visits(1000), 0u);
+    EXPECT_EQ(frozen.get_value(1000), 0.0);
+
+    EXPECT_NEAR(greedy_reward(frozen, track, jumps),
+                optimal_last_position_score(track, jumps), 0.001);
+}
+
+TEST_F(FrozenStatsTableTest, PathHandlesAndEmptyTable)
+{
+    monte_carlo::visits_table<std::vector<int>, path_unordered_map>        visits;
+    monte_carlo::value_table<std::vector<int>, double, path_unordered_map> value;
+
+    const auto empty = monte_carlo::freeze<std::vector<int>, double, VectorIntHash>(visits, value);
+    EXPECT_EQ(empty.size(), 0u);
+    EXPECT_EQ(empty.get_visits({-1}), 0u);
+
+    for (int a = 0; a < 50; ++a)
+        for (int b = 0; b < 50; ++b)
+        {
+            visits.set_visits({-1, a, b}, static_cast<size_t>(a * 50 + b + 1));
+            value.set_value({-1, a, b}, 0.5 * (a - b));
+        }
+
+    const auto frozen = monte_carlo::freeze<std::vector<int>, double, VectorIntHash>(visits, value);
+    ASSERT_EQ(frozen.size(), 2500u);
+    for (int a = 0; a < 50; ++a)
+        for (int b = 0; b < 50; ++b)
+        {
+            EXPECT_EQ(frozen.get_visits({-1, a, b}), static_cast<size_t>(a * 50 + b + 1));
+            EXPECT_DOUBLE_EQ(frozen.get_value({-1, a, b}), 0.5 * (a - b));
+        }
+    EXPECT_EQ(frozen.get_visits({-1, 50, 0}), 0u);
+}
+
+// ---------------------------------------------------------------------------
+// CompactStatsTableTest
+//
+// compact_stats_table packs visits and value into one narrow record; the
+// Counter parameter of visits_table / dispatches_table narrows the counters.
+// Both engines must still converge with 32-bit counters and float values, and
+// narrow counters must saturate rather than wrap.
+// ---------------------------------------------------------------------------
+class CompactStatsTableTest : public ::testing::Test
+{
+protected:
+    using rollout_t = monte_carlo::random_rollout<
+                         jump_t, std::mt19937,
+                         std::vector<jump_t>, std::vector<jump_t>>;
+
+    static constexpr double kTolerance = 0.001;
+
+    // Terminal-reward sim episodes, one stats object for visits and value.
+    template<typename IStats>
+    void sim_train(IStats&                    stats,
+                   const std::vector<double>& track,
+                   const std::vector<jump_t>& jumps,
+                   std::mt19937&              rng,
+                   double                     c,
+                   int                        n)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            rollout_t       rollout(rng);
+            position_walker walker;
+            monte_carlo::uniform_value_delta<double>        delta;
+            monte_carlo::uniform_exploration_constant<double> ec(c);
+
+            monte_carlo::sim<
+                int, jump_t, double,
+                IStats, IStats, IStats, IStats,
+                position_walker,
+                std::vector<jump_t>, std::vector<jump_t>,
+                rollout_t,
+                monte_carlo::uniform_value_delta<double>,
+                monte_carlo::uniform_exploration_constant<double>
+            > s(stats, stats, stats, stats, walker, rollout, delta, ec, -1);
+
+            int    position = -1;
+            double reward   = 0.0;
+
+            while (true)
+            {
+                jump_t chosen = s.choose(jumps, jumps);
+                int    next   = position + chosen;
+                if (next >= static_cast<int>(track.size()))
+                {
+                    delta.set_value(reward);
+                    s.terminate();
+                    break;
+                }
+                position = next;
+                reward   = track[position];
+            }
+        }
+    }
+
+    // Terminal-reward dbuct episodes with a finite grant increment interval.
+    template<typename IStats, typename IDispatches>
+    void dbuct_train(IStats&                    stats,
+                     IDispatches&               dispatches,
+                     const std::vector<double>& track,
+                     const std::vector<jump_t>& jumps,
+                     std::mt19937&              rng,
+                     size_t                     gii,
+                     int                        n)
+    {
+        using batch_t = monte_carlo::linear_batch_increment;
+
+        rollout_t       rollout(rng);
+        position_walker walker;
+        batch_t         batch(gii);
+        monte_carlo::uniform_value_delta<double>        delta;
+        monte_carlo::uniform_exploration_constant<double> ec(100.0);
+
+        monte_carlo::dbuct<
+            int, jump_t, double,
+            IStats, IStats, IStats, IStats,
+            IDispatches, IDispatches,
+            batch_t,
+            position_walker,
+            std::vector<jump_t>, std::vector<jump_t>,
+            rollout_t,
+            monte_carlo::uniform_value_delta<double>,
+            monte_carlo::uniform_exploration_constant<double>
+        > d(stats, stats, stats, stats, dispatches, dispatches, batch,
+            walker, rollout, delta, ec, -1);
+
+        std::vector<int> path = {-1};
+
+        for (int i = 0; i < n; ++i)
+        {
+            int    position = path.back();
+            double reward   = 0.0;
+
+            while (true)
+            {
+                jump_t chosen = d.choose(jumps, jumps);
+                int    next   = position + chosen;
+                if (!d.in_rollout())
+                    path.push_back(next);
+                if (next >= static_cast<int>(track.size()))
+                {
+                    delta.set_value(reward);
+                    d.terminate();
+                    path.resize(d.depth());
+                    break;
+                }
+                position = next;
+                reward   = track[position];
+            }
+        }
+    }
+
+    // Greedy read-only walk: highest mean child until the next move leaves the track.
+    template<typename IStats>
+    double greedy_reward(const IStats&              stats,
+                         const std::vector<double>& track,
+                         const std::vector<jump_t>& jumps)
+    {
+        int    position = -1;
+        double reward   = 0.0;
+
+        while (true)
+        {
+            double best_mean = -std::numeric_limits<double>::infinity();
+            jump_t best      = jumps.front();
+            for (jump_t j : jumps)
+            {
+                const size_t v = stats.get_visits(position + j);
+                if (v == 0)
+                    continue;
+                const double mean = stats.get_value(position + j) / static_cast<double>(v);
+                if (mean > best_mean)
+                {
+                    best_mean = mean;
+                    best      = j;
+                }
+            }
+
+            const int next = position + best;
+            if (next >= static_cast<int>(track.size()))
+                return reward;
+            position = next;
+            reward   = track[position];
+        }
+    }
+
+    static std::vector<double> make_track(int seed, size_t length)
+    {
+        std::mt19937                           rng(seed);
+        std::uniform_real_distribution<double> urd(-10, 10);
+        std::vector<double>                    track(length);
+        std::generate(track.begin(), track.end(), [&] { return urd(rng); });
+        return track;
+    }
+};
+
+TEST_F(CompactStatsTableTest, NarrowCountersSaturateInsteadOfWrapping)
+{
+    monte_carlo::visits_table<int, std::unordered_map, uint8_t>          visits;
+    monte_carlo::dispatches_table<int, std::unordered_map, uint8_t>      dispatches;
+    monte_carlo::compact_stats_table<int, double, std::unordered_map, uint8_t> stats;
+
+    visits.set_visits(1, 255);
+    dispatches.set_dispatches(1, 255);
+    stats.set_visits(1, 255);
+    EXPECT_FALSE(visits.saturated());
+    EXPECT_FALSE(dispatches.saturated());
+    EXPECT_FALSE(stats.saturated());
+
+    visits.set_visits(1, 256);
+    dispatches.set_dispatches(1, 1000);
+    stats.set_visits(1, 256);
+    EXPECT_EQ(visits.get_visits(1), 255u);
+    EXPECT_EQ(dispatches.get_dispatches(1), 255u);
+    EXPECT_EQ(stats.get_visits(1), 255u);
+    EXPECT_TRUE(visits.saturated());
+    EXPECT_TRUE(dispatches.saturated());
+    EXPECT_TRUE(stats.saturated());
+}
+
+// Back-up order as in sim: set_visits(n + 1), then set_value(old + reward).
+// A float Value stores the mean, a double one the sum; both keep the mean.
+template<typename Stats>
+void expect_mean_survives_saturation(Stats& stats)
+{
+    for (int n = 0; n < 1000; ++n)
+    {
+        stats.set_visits(1, stats.get_visits(1) + 1);
+        stats.set_value(1, stats.get_value(1) + 0.25);
+    }
+    EXPECT_TRUE(stats.saturated());
+    EXPECT_EQ(stats.get_visits(1), 255u);
+    EXPECT_NEAR(stats.get_value(1) / 255.0, 0.25, 1e-6);
+
+    // Rewards that change after saturation move the mean toward them.
+    for (int n = 0; n < 5000; ++n)
+    {
+        stats.set_visits(1, stats.get_visits(1) + 1);
+        stats.set_value(1, stats.get_value(1) + 0.75);
+    }
+    EXPECT_GT(stats.get_value(1) / 255.0, 0.7);
+    EXPECT_LE(stats.get_value(1) / 255.0, 0.75 + 1e-6);
+}
+
+TEST_F(CompactStatsTableTest, MeanSurvivesSaturation)
+{
+    monte_carlo::compact_stats_table<int, double, std::unordered_map, uint8_t>         mean_stats;
+    monte_carlo::compact_stats_table<int, double, std::unordered_map, uint8_t, double> sum_stats;
+    static_assert(decltype(mean_stats)::stores_mean && !decltype(sum_stats)::stores_mean);
+
+    expect_mean_survives_saturation(mean_stats);
+    expect_mean_survives_saturation(sum_stats);
+}
+
+// Past 2^24 unit updates a float sum stops growing; the stored mean does not
+// decay with it.
+TEST_F(CompactStatsTableTest, FloatMeanHoldsPast2To24Updates)
+{
+    monte_carlo::compact_stats_table<int, double, std::unordered_map> stats;
+
+    constexpr size_t n = size_t{1} << 25;
+    for (size_t i = 0; i < n; ++i)
+    {
+        stats.set_visits(1, stats.get_visits(1) + 1);
+        stats.set_value(1, stats.get_value(1) + static_cast<double>(i % 2));
+    }
+    EXPECT_EQ(stats.get_visits(1), n);
+    EXPECT_NEAR(stats.get_value(1) / static_cast<double>(n), 0.5, 0.01);
+}
+
+TEST_F(CompactStatsTableTest, SimWithSaturatingCountersNeverSeesZero)
+{
+    const std::vector<double> track = make_track(45, 10);
+    const std::vector<jump_t> jumps = {1, 2, 3, 4};
+    std::mt19937              rng(45);
+
+    monte_carlo::compact_stats_table<int, double, std::unordered_map, uint8_t> stats;
+    sim_train(stats, track, jumps, rng, 100.0, 5000);
+
+    EXPECT_TRUE(stats.saturated());
+    EXPECT_EQ(stats.get_visits(-1), 255u);
+    stats.for_each([](const int& h, size_t v)
+    {
+        EXPECT_GE(v, 1u) << "visited node reads as unvisited at pos=" << h;
+    });
+}
+
+TEST_F(CompactStatsTableTest, SimConvergesWith32BitFloatRecordsSeed46Track15Moves123)
+{
+    const std::vector<double> track = make_track(46, 15);
+    const std::vector<jump_t> jumps = {1, 2, 3};
+    std::mt19937              rng(46);
+
+    monte_carlo::compact_stats_table<int, double, std::unordered_map> stats;
+    static_assert(sizeof(decltype(stats)::record) == 8);
+
+    sim_train(stats, track, jumps, rng, 100.0, 20000);
+
+    EXPECT_FALSE(stats.saturated());
+    EXPECT_NEAR(greedy_reward(stats, track, jumps),
+                optimal_last_position_score(track, jumps), kTolerance);
+}
+
+TEST_F(CompactStatsTableTest, DbuctConvergesWith32BitFloatRecordsSeed44Track10Moves25)
+{
+    const std::vector<double> track = make_track(44, 10);
+    const std::vector<jump_t> jumps = {2, 5};
+    std::mt19937              rng(44);
+
+    monte_carlo::compact_stats_table<int, double, std::unordered_map>        stats;
+    monte_carlo::dispatches_table<int, std::unordered_map, uint32_t>         dispatches;
+
+    dbuct_train(stats, dispatches, track, jumps, rng, 5, 10000);
+
+    EXPECT_NEAR(greedy_reward(stats, track, jumps),
+                optimal_last_position_score(track, jumps), kTolerance);
+}
+
+// ---------------------------------------------------------------------------
+// SearchArenaTest
+//
+// Tables over a std::pmr map take a memory_resource through their forwarding
+// constructor.  With a search_arena every node (and, for pmr path handles,
+// every stored key) is carved from a few large upstream blocks, and the whole
+// tree is freed by release().
+// ---------------------------------------------------------------------------
+class SearchArenaTest : public ::testing::Test
+{
+protected:
+    // Upstream resource that counts the blocks the arena asks for.
+    struct counting_resource : std::pmr::memory_resource
+    {
+        size_t allocations = 0;
+
+    private:
+        void* do_allocate(size_t n, size_t align) override
+        {
+            ++allocations;
+            return std::pmr::new_delete_resource()->allocate(n, align);
+        }
+
+        void do_deallocate(void* p, size_t n, size_t align) override
+        {
+            std::pmr::new_delete_resource()->deallocate(p, n, align);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& o) const noexcept override
+        {
+            return this == &o;
+        }
+    };
+
+    struct PmrVectorIntHash
+    {
+        size_t operator()(const std::pmr::vector<int>& v) const noexcept
+        {
+            return VectorIntHash{}(std::vector<int>(v.begin(), v.end()));
+        }
+    };
+
+    template<typename K, typename V>
+    using pmr_path_map = std::pmr::unordered_map<K, V, PmrVectorIntHash>;
+
+    using visits_t  = monte_carlo::visits_table<int, std::pmr::unordered_map>;
+    using value_t   = monte_carlo::value_table<int, double, std::pmr::unordered_map>;
+    using rollout_t = monte_carlo::random_rollout<
+                         jump_t, std::mt19937,
+                         std::vector<jump_t>, std::vector<jump_t>>;
+
+    double sim_episode(visits_t&                  visits,
+                       value_t&                   value,
+                       const std::vector<double>& track,
+                       const std::vector<jump_t>& jumps,
+                       std::mt19937&              rng,
+                       double                     c)
+    {
+        rollout_t       rollout(rng);
+        position_walker walker;
+        monte_carlo::uniform_value_delta<double>        delta;
+        monte_carlo::uniform_exploration_constant<double> ec(c);
+
+        monte_carlo::sim<
+            int, jump_t, double,
+            visits_t, value_t, visits_t, value_t,
+            position_walker,
+            std::vector<jump_t>, std::vector<jump_t>,
+            rollout_t,
+            monte_carlo::uniform_value_delta<double>,
+            monte_carlo::uniform_exploration_constant<double>
+        > s(visits, value, visits, value, walker, rollout, delta, ec, -1);
+
+        int    position = -1;
+        double reward   = 0.0;
+
+        while (true)
+        {
+            jump_t chosen = s.choose(jumps, jumps);
+            int    next   = position + chosen;
+            if (next >= static_cast<int>(track.size()))
+            {
+                delta.set_value(reward);
+                s.terminate();
+                return reward;
+            }
+            position = next;
+            reward   = track[position];
+        }
+    }
+};
+
+TEST_F(SearchArenaTest, ArenaTablesConvergeSeed49Track20Moves123)
+{
+    std::mt19937                           rng(49);
+    std::uniform_real_distribution<double> urd(-10, 10);
+    std::vector<double>                    track(20);
+    std::generate(track.begin(), track.end(), [&] { return urd(rng); });
+    const std::vector<jump_t> jumps = {1, 2, 3};
+
+    counting_resource         upstream;
+    monte_carlo::search_arena arena(4096, &upstream);
+
+    auto& visits = arena.make<visits_t>(arena.resource());
+    auto& value  = arena.make<value_t>(arena.resource());
+
+    for (int i = 0; i < 50000; ++i)
+        sim_episode(visits, value, track, jumps, rng, 100.0);
+
+    EXPECT_NEAR(sim_episode(visits, value, track, jumps, rng, 0.0),
+                optimal_last_position_score(track, jumps), 0.001);
+
+    // A handful of geometrically growing blocks, not one per node.
+    EXPECT_GT(upstream.allocations, 0u);
+    EXPECT_LT(upstream.allocations, 20u);
+
+    arena.release();
+}
+
+TEST_F(SearchArenaTest, PmrPathHandlesAreCopiedIntoTheArena)
+{
+    monte_carlo::search_arena arena;
+    monte_carlo::visits_table<std::pmr::vector<int>, pmr_path_map> visits(arena.resource());
+
+    for (int a = 0; a < 20; ++a)
+        visits.set_visits(std::pmr::vector<int>{-1, a, a + 1}, static_cast<size_t>(a + 1));
+
+    size_t n = 0;
+    visits.for_each([&](const std::pmr::vector<int>& h, size_t v)
+    {
+        ++n;
+        EXPECT_EQ(h.get_allocator().resource(), arena.resource());
+        EXPECT_EQ(v, static_cast<size_t>(h[1] + 1));
+    });
+    EXPECT_EQ(n, 20u);
+    EXPECT_EQ(visits.get_visits(std::pmr::vector<int>{-1, 3, 4}), 4u);
+    EXPECT_EQ(visits.get_visits(std::pmr::vector<int>{-1, 3, 5}), 0u);
+}
+
+// ---------------------------------------------------------------------------
+// IncrementalHashMapTest
+//
+// incremental_hash_map spreads each resize over the following inserts by
+// draining the previous table a few slots at a time.  Every key must stay
+// visible exactly once while a drain is in flight, and tables backed by it
+// must match tables backed by std::unordered_map.
+// ---------------------------------------------------------------------------
+class IncrementalHashMapTest : public ::testing::Test
+{
+protected:
+    // A non-trivial value that counts its live objects.
+    struct counted
+    {
+        static inline int live = 0;
+
+        std::string text;
+
+        counted() { ++live; }
+        counted(const counted& o) : text(o.text) { ++live; }
+        counted(counted&& o) noexcept : text(std::move(o.text)) { ++live; }
+        counted& operator=(const counted&) = default;
+        counted& operator=(counted&&)      = default;
+        ~counted() { --live; }
+    };
+
+    using inc_visits_t = monte_carlo::visits_table<int, monte_carlo::incremental_hash_map>;
+    using inc_value_t  = monte_carlo::value_table<int, double, monte_carlo::incremental_hash_map>;
+    using visits_t     = monte_carlo::visits_table<int, std::unordered_map>;
+    using value_t      = monte_carlo::value_table<int, double, std::unordered_map>;
+    using rollout_t    = monte_carlo::random_rollout<
+                            jump_t, std::mt19937,
+                            std::vector<jump_t>, std::vector<jump_t>>;
+
+    template<typename IVisits, typename IValue>
+    void sim_episode(IVisits&                   visits,
+                     IValue&                    value,
+                     const std::vector<double>& track,
+                     const std::vector<jump_t>& jumps,
+                     std::mt19937&              rng,
+                     double                     c)
+    {
+        rollout_t       rollout(rng);
+        position_walker walker;
+        monte_carlo::uniform_value_delta<double>        delta;
+        monte_carlo::uniform_exploration_constant<double> ec(c);
+
+        monte_carlo::sim<
+            int, jump_t, double,
+            IVisits, IValue, IVisits, IValue,
+            position_walker,
+            std::vector<jump_t>, std::vector<jump_t>,
+            rollout_t,
+            monte_carlo::uniform_value_delta<double>,
+            monte_carlo::uniform_exploration_constant<double>
+        > s(visits, value, visits, value, walker, rollout, delta, ec, -1);
+
+        int    position = -1;
+        double reward   = 0.0;
+
+        while (true)
+        {
+            jump_t chosen = s.choose(jumps, jumps);
+            int    next   = position + chosen;
+            if (next >= static_cast<int>(track.size()))
+            {
+                delta.set_value(reward);
+                s.terminate();
+                break;
+            }
+            position = next;
+            reward   = track[position];
+        }
+    }
+};
+
+TEST_F(IncrementalHashMapTest, KeysStayVisibleOnceWhileDraining)
+{
+    monte_carlo::incremental_hash_map<uint64_t, size_t> m;
+    std::unordered_map<uint64_t, size_t>                ref;
+    std::mt19937_64                                     rng(30);
+
+    bool saw_drain = false;
+    for (int i = 0; i < 20000; ++i)
+    {
+        const uint64_t k = rng() % 15000;
+        m[k]   += 1;
+        ref[k] += 1;
+
+        if (m.draining() && !saw_drain)
+        {
+            saw_drain = true;
+            size_t n = 0;
+            for (auto it = m.begin(); it != m.end(); ++it, ++n)
+                EXPECT_EQ(it->second, ref.at(it->first));
+            EXPECT_EQ(n, ref.size());
+        }
+    }
+    EXPECT_TRUE(saw_drain);
+    EXPECT_EQ(m.size(), ref.size());
+
+    for (const auto& [k, v] : ref)
+    {
+        auto it = m.find(k);
+        ASSERT_NE(it, m.end()) << "lost key=" << k;
+        EXPECT_EQ(it->second, v);
+    }
+    EXPECT_EQ(m.find(15000), m.end());
+}
+
+// Growths at 8, 16, ..., 65536 entries; each drain must be over before the
+// next growth starts another, and every entry constructed must be destroyed.
+TEST_F(IncrementalHashMapTest, EachDrainFinishesBeforeTheNextGrowth)
+{
+    {
+        monte_carlo::incremental_hash_map<int, counted> m;
+        int  drains = 0;
+        bool was    = false;
+        for (int k = 0; k < 100000; ++k)
+        {
+            m[k].text = std::to_string(k);
+            if (m.draining() && !was)
+                ++drains;
+            was = m.draining();
+        }
+        EXPECT_EQ(drains, 14);
+
+        for (int k = 0; k < 100000; k += 997)
+        {
+            auto it = m.find(k);
+            ASSERT_NE(it, m.end()) << "lost key=" << k;
+            EXPECT_EQ(it->second.text, std::to_string(k));
+        }
+    }
+    EXPECT_EQ(counted::live, 0);
+}
+
+TEST_F(IncrementalHashMapTest, ReserveSizesUpFrontAndTablesForwardIt)
+{
+    monte_carlo::incremental_hash_map<int, int> m;
+    m.reserve(1000);
+    for (int k = 0; k < 1000; ++k)
+    {
+        m[k] = k;
+        EXPECT_FALSE(m.draining()) << "resized at k=" << k;
+    }
+
+    // reserve() is forwarded when the Map has it and ignored otherwise.
+    inc_visits_t inc_visits;
+    inc_visits.reserve(64);
+    monte_carlo::visits_table<int, std::map> ordered_visits;
+    ordered_visits.reserve(64);
+    monte_carlo::compact_stats_table<int, double, std::unordered_map> compact;
+    compact.reserve(64);
+    EXPECT_EQ(inc_visits.get_visits(1), 0u);
+    EXPECT_EQ(ordered_visits.get_visits(1), 0u);
+}
+
+TEST_F(IncrementalHashMapTest, MatchesUnorderedTablesSeed61Track200Moves123)
+{
+    std::mt19937                           track_rng(61);
+    std::uniform_real_distribution<double> urd(-10, 10);
+    std::vector<double>                    track(200);
+    std::generate(track.begin(), track.end(), [&] { return urd(track_rng); });
+    const std::vector<jump_t> jumps = {1, 2, 3};
+
+    std::mt19937 rng1(61), rng2(61);
+    visits_t     visits;
+    value_t      value;
+    inc_visits_t inc_visits;
+    inc_value_t  inc_value;
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        sim_episode(visits, value, track, jumps, rng1, 10.0);
+        sim_episode(inc_visits, inc_value, track, jumps, rng2, 10.0);
+    }
+
+    for (int pos = -1; pos < static_cast<int>(track.size()) + 3; ++pos)
+    {
+        EXPECT_EQ(visits.get_visits(pos), inc_visits.get_visits(pos))
+            << "visits mismatch at pos=" << pos;
+        EXPECT_DOUBLE_EQ(value.get_value(pos), inc_value.get_value(pos))
+            << "value mismatch at pos=" << pos;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// EdgeVisitsTest
+//
+// With an edge table, sim and dbuct select on edge visits (the track game is
+// a DAG: position handles are reached by many jump sequences).  Edge counts
+// out of a node must add up to the visits that node passed on to children,
+// and both engines must still converge.
+// ---------------------------------------------------------------------------
+class EdgeVisitsTest : public ::testing::Test
+{
+protected:
+    using visits_t  = monte_carlo::visits_table<int, std::unordered_map>;
+    using value_t   = monte_carlo::value_table<int, double, std::unordered_map>;
+    using edges_t   = monte_carlo::int_edge_unordered_table<int>;
+    using rollout_t = monte_carlo::random_rollout<
+                         jump_t, std::mt19937,
+                         std::vector<jump_t>, std::vector<jump_t>>;
+
+    static constexpr double kTolerance = 0.001;
+
+    template<typename IEdges>
+    void sim_train(visits_t&                  visits,
+                   value_t&                   value,
+                   IEdges&                    edges,
+                   const std::vector<double>& track,
+                   const std::vector<jump_t>& jumps,
+                   std::mt19937&              rng,
+                   double                     c,
+                   int                        n)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            rollout_t       rollout(rng);
+            position_walker walker;
+            monte_carlo::uniform_value_delta<double>        delta;
+            monte_carlo::uniform_exploration_constant<double> ec(c);
+
+            monte_carlo::sim<
+                int, jump_t, double,
+                visits_t, value_t, visits_t, value_t,
+                position_walker,
+                std::vector<jump_t>, std::vector<jump_t>,
+                rollout_t,
+                monte_carlo::uniform_value_delta<double>,
+                monte_carlo::uniform_exploration_constant<double>,
+                IEdges
+            > s(visits, value, visits, value, walker, rollout, delta, ec, edges, -1);
+
+            int    position = -1;
+            double reward   = 0.0;
+
+            while (true)
+            {
+                jump_t chosen = s.choose(jumps, jumps);
+                int    next   = position + chosen;
+                if (next >= static_cast<int>(track.size()))
+                {
+                    delta.set_value(reward);
+                    s.terminate();
+                    break;
+                }
+                position = next;
+                reward   = track[position];
+            }
+        }
+    }
+
+    void dbuct_train(visits_t&                  visits,
+                     value_t&                   value,
+                     edges_t&                   edges,
+                     const std::vector<double>& track,
+                     const std::vector<jump_t>& jumps,
+                     std::mt19937&              rng,
+                     size_t                     gii,
+                     int                        n)
+    {
+        using batch_t      = monte_carlo::linear_batch_increment;
+        using dispatches_t = monte_carlo::dispatches_table<int, std::unordered_map>;
+
+        rollout_t       rollout(rng);
+        position_walker walker;
+        batch_t         batch(gii);
+        dispatches_t    dispatches;
+        monte_carlo::uniform_value_delta<double>        delta;
+        monte_carlo::uniform_exploration_constant<double> ec(100.0);
+
+        monte_carlo::dbuct<
+            int, jump_t, double,
+            visits_t, value_t, visits_t, value_t,
+            dispatches_t, dispatches_t,
+            batch_t,
+            position_walker,
+            std::vector<jump_t>, std::vector<jump_t>,
+            rollout_t,
+            monte_carlo::uniform_value_delta<double>,
+            monte_carlo::uniform_exploration_constant<double>,
+            edges_t
+        > d(visits, value, visits, value, dispatches, dispatches, batch,
+            walker, rollout, delta, ec, edges, -1);
+
+        std::vector<int> path = {-1};
+
+        for (int i = 0; i < n; ++i)
+        {
+            int    position = path.back();
+            double reward   = 0.0;
+
+            while (true)
+            {
+                jump_t chosen = d.choose(jumps, jumps);
+                int    next   = position + chosen;
+                if (!d.in_rollout())
+                    path.push_back(next);
+                if (next >= static_cast<int>(track.size()))
+                {
+                    delta.set_value(reward);
+                    d.terminate();
+                    path.resize(d.depth());
+                    break;
+                }
+                position = next;
+                reward   = track[position];
+            }
+        }
+    }
+
+    static size_t edges_out(const edges_t& edges, int parent, const std::vector<jump_t>& jumps)
+    {
+        size_t n = 0;
+        for (jump_t j : jumps)
+            n += edges.get_edge_visits(parent, parent + j);
+        return n;
+    }
+
+    // Greedy read-only walk: highest mean child until the next move leaves the track.
+    static double greedy_reward(const visits_t&            visits,
+                                const value_t&             value,
+                                const std::vector<double>& track,
+                                const std::vector<jump_t>& jumps)
+    {
+        int    position = -1;
+        double reward   = 0.0;
+
+        while (true)
+        {
+            double best_mean = -std::numeric_limits<double>::infinity();
+            jump_t best      = jumps.front();
+            for (jump_t j : jumps)
+            {
+                const size_t v = visits.get_visits(position + j);
+                if (v == 0)
+                    continue;
+                const double mean = value.get_value(position + j) / static_cast<double>(v);
+                if (mean > best_mean)
+                {
+                    best_mean = mean;
+                    best      = j;
+                }
+            }
+
+            const int next = position + best;
+            if (next >= static_cast<int>(track.size()))
+                return reward;
+            position = next;
+            reward   = track[position];
+        }
+    }
+};
+
+TEST_F(EdgeVisitsTest, SimEdgeCountsFollowTheSelectionPath)
+{
+    std::mt19937                           rng(62);
+    std::uniform_real_distribution<double> urd(-10, 10);
+    std::vector<double>                    track(12);
+    std::generate(track.begin(), track.end(), [&] { return urd(rng); });
+    const std::vector<jump_t> jumps = {1, 2, 3};
+
+    visits_t visits;
+    value_t  value;
+    edges_t  edges;
+    sim_train(visits, value, edges, track, jumps, rng, 10.0, 3000);
+
+    // Every episode leaves the root by exactly one edge.
+    EXPECT_EQ(edges_out(edges, -1, jumps), 3000u);
+    EXPECT_EQ(visits.get_visits(-1), 3000u);
+
+    // Transposed positions receive visits from several parents, so a node's
+    // visits exceed any single incoming edge; outgoing edges never exceed it.
+    bool saw_transposition = false;
+    for (int pos = 0; pos < static_cast<int>(track.size()); ++pos)
+    {
+        EXPECT_LE(edges_out(edges, pos, jumps), visits.get_visits(pos)) << "pos=" << pos;
+        for (jump_t j : jumps)
+            if (pos - j >= -1 && edges.get_edge_visits(pos - j, pos) > 0
+                && edges.get_edge_visits(pos - j, pos) < visits.get_visits(pos))
+                saw_transposition = true;
+    }
+    EXPECT_TRUE(saw_transposition);
+}
+
+TEST_F(EdgeVisitsTest, SimWithEdgesConvergesSeed63Track20Moves123)
+{
+    std::mt19937                           rng(63);
+    std::uniform_real_distribution<double> urd(-10, 10);
+    std::vector<double>                    track(20);
+    std::generate(track.begin(), track.end(), [&] { return urd(rng); });
+    const std::vector<jump_t> jumps = {1, 2, 3};
+
+    visits_t visits;
+    value_t  value;
+    edges_t  edges;
+    sim_train(visits, value, edges, track, jumps, rng, 10.0, 20000);
+
+    EXPECT_NEAR(greedy_reward(visits, value, track, jumps),
+                optimal_last_position_score(track, jumps), kTolerance);
+}
+
+TEST_F(EdgeVisitsTest, DbuctWithEdgesConvergesSeed64Track20Moves123)
+{
+    std::mt19937                           rng(64);
+    std::uniform_real_distribution<double> urd(-10, 10);
+    std::vector<double>                    track(20);
+    std::generate(track.begin(), track.end(), [&] { return urd(rng); });
+    const std::vector<jump_t> jumps = {1, 2, 3};
+
+    visits_t visits;
+    value_t  value;
+    edges_t  edges;
+    dbuct_train(visits, value, edges, track, jumps, rng, 25, 20000);
+
+    // Root visits arrive only through backstep(), together with its edges.
+    EXPECT_EQ(edges_out(edges, -1, jumps), visits.get_visits(-1));
+    EXPECT_NEAR(greedy_reward(visits, value, track, jumps),
+                optimal_last_position_score(track, jumps), kTolerance);
+}
+
+// ---------------------------------------------------------------------------
+// WideEdgeTableTest
+//
+// wide_edge_table and parent_edge_table store both handles whole, so 64-bit
+// handles that agree in their low 32 bits stay distinct edges.  Driving sim
+// with either must give exactly the statistics of int_edge_unordered_table.
+// ---------------------------------------------------------------------------
+class WideEdgeTableTest : public EdgeVisitsTest
+{};
+
+TEST_F(WideEdgeTableTest, SixtyFourBitHandlesDoNotAlias)
+{
+    monte_carlo::wide_edge_table<uint64_t>   wide;
+    monte_carlo::parent_edge_table<uint64_t> per_parent;
+
+    const uint64_t p  = 0x1'0000'0007ull, p2 = 0x2'0000'0007ull;
+    const uint64_t c  = 0x5'0000'0009ull, c2 = 0x9ull;
+
+    wide.set_edge_visits(p, c, 3);
+    per_parent.set_edge_visits(p, c, 3);
+
+    EXPECT_EQ(wide.get_edge_visits(p, c), 3u);
+    EXPECT_EQ(wide.get_edge_visits(p2, c), 0u);
+    EXPECT_EQ(wide.get_edge_visits(p, c2), 0u);
+    EXPECT_EQ(per_parent.get_edge_visits(p, c), 3u);
+    EXPECT_EQ(per_parent.get_edge_visits(p2, c), 0u);
+    EXPECT_EQ(per_parent.get_edge_visits(p, c2), 0u);
+}
+
+TEST_F(WideEdgeTableTest, ParentEdgesStayContiguousAcrossRelocation)
+{
+    monte_carlo::parent_edge_table<uint64_t> edges;
+
+    // Interleave parents so every block is relocated several times.
+    for (uint64_t child = 0; child < 100; ++child)
+        for (uint64_t parent = 0; parent < 5; ++parent)
+            edges.set_edge_visits(parent << 40, child, parent * 1000 + child);
+
+    EXPECT_EQ(edges.parents(), 5u);
+    for (uint64_t parent = 0; parent < 5; ++parent)
+    {
+        const auto e = edges.edges(parent << 40);
+        ASSERT_EQ(e.size, 100u);
+        for (size_t i = 0; i < e.size; ++i)
+        {
+            EXPECT_EQ(e.children[i], i);
+            EXPECT_EQ(e.counts[i], parent * 1000 + i);
+        }
+    }
+    EXPECT_EQ(edges.edges(7).size, 0u);
+
+    edges.set_edge_visits(0, 42, 1);
+    EXPECT_EQ(edges.get_edge_visits(0, 42), 1u);
+    EXPECT_EQ(edges.edges(0).size, 100u);
+}
+
+TEST_F(WideEdgeTableTest, SimMatchesIntEdgeTableSeed65Track25Moves123)
+{
+    std::mt19937                           track_rng(65);
+    std::uniform_real_distribution<double> urd(-10, 10);
+    std::vector<double>                    track(25);
+    std::generate(track.begin(), track.end(), [&] { return urd(track_rng); });
+    const std::vector<jump_t> jumps = {1, 2, 3};
+
+    std::mt19937                        rng1(65), rng2(65), rng3(65);
+    visits_t                            visits1, visits2, visits3;
+    value_t                             value1, value2, value3;
+    edges_t                             int_edges;
+    monte_carlo::wide_edge_table<int>   wide_edges;
+    monte_carlo::parent_edge_table<int> parent_edges;
+
+    sim_train(visits1, value1, int_edges,    track, jumps, rng1, 10.0, 3000);
+    sim_train(visits2, value2, wide_edges,   track, jumps, rng2, 10.0, 3000);
+    sim_train(visits3, value3, parent_edges, track, jumps, rng3, 10.0, 3000);
+
+    for (int pos = -1; pos < static_cast<int>(track.size()); ++pos)
+    {
+        EXPECT_EQ(visits1.get_visits(pos), visits2.get_visits(pos)) << "pos=" << pos;
+        EXPECT_EQ(visits1.get_visits(pos), visits3.get_visits(pos)) << "pos=" << pos;
+        for (jump_t j : jumps)
+        {
+            EXPECT_EQ(int_edges.get_edge_visits(pos, pos + j), wide_edges.get_edge_visits(pos, pos + j));
+            EXPECT_EQ(int_edges.get_edge_visits(pos, pos + j), parent_edges.get_edge_visits(pos, pos + j));
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// ProgressiveWideningTest
+//
+// One-move bandit with many arms: the root's children are the arms and each
+// episode ends after one choice.  With progressive_widening as the choice
+// argument, selection may only expand the first ceil(k * N^alpha) arms.
+// ---------------------------------------------------------------------------
+class ProgressiveWideningTest : public ::testing::Test
+{
+protected:
+    using arms_t    = std::vector<int>;
+    using widen_t   = monte_carlo::progressive_widening<arms_t>;
+    using visits_t  = monte_carlo::visits_table<int, std::unordered_map>;
+    using value_t   = monte_carlo::value_table<int, double, std::unordered_map>;
+    using rollout_t = monte_carlo::random_rollout<int, std::mt19937, widen_t, widen_t>;
+
+    // Arm a leads to node a + 1; the root is node 0.
+    struct arm_walker
+    {
+        int walk(const int&, int a) const { return a + 1; }
+    };
+
+    static double arm_reward(int a) { return a == 150 ? 1.0 : 0.1; }
+
+    void sim_train(visits_t& visits, value_t& value, const widen_t& arms,
+                   std::mt19937& rng, int n)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            rollout_t  rollout(rng);
+            arm_walker walker;
+            monte_carlo::uniform_value_delta<double>        delta;
+            monte_carlo::uniform_exploration_constant<double> ec(0.5);
+
+            monte_carlo::sim<
+                int, int, double,
+                visits_t, value_t, visits_t, value_t,
+                arm_walker,
+                widen_t, widen_t,
+                rollout_t,
+                monte_carlo::uniform_value_delta<double>,
+                monte_carlo::uniform_exploration_constant<double>
+            > s(visits, value, visits, value, walker, rollout, delta, ec, 0);
+
+            delta.set_value(arm_reward(s.choose(arms, arms)));
+            s.terminate();
+        }
+    }
+
+    void dbuct_train(visits_t& visits, value_t& value, const widen_t& arms,
+                     std::mt19937& rng, int n)
+    {
+        using batch_t      = monte_carlo::linear_batch_increment;
+        using dispatches_t = monte_carlo::dispatches_table<int, std::unordered_map>;
+
+        rollout_t    rollout(rng);
+        arm_walker   walker;
+        batch_t      batch(4);
+        dispatches_t dispatches;
+        monte_carlo::uniform_value_delta<double>        delta;
+        monte_carlo::uniform_exploration_constant<double> ec(0.5);
+
+        monte_carlo::dbuct<
+            int, int, double,
+            visits_t, value_t, visits_t, value_t,
+            dispatches_t, dispatches_t,
+            batch_t,
+            arm_walker,
+            widen_t, widen_t,
+            rollout_t,
+            monte_carlo::uniform_value_delta<double>,
+            monte_carlo::uniform_exploration_constant<double>
+        > d(visits, value, visits, value, dispatches, dispatches, batch,
+            walker, rollout, delta, ec, 0);
+
+        for (int i = 0; i < n; ++i)
+        {
+            // A camping arm frame ends its episode without another choice.
+            if (d.depth() == 1)
+                delta.set_value(arm_reward(d.choose(arms, arms)));
+            d.terminate();
+        }
+    }
+
+    static size_t expanded_arms(const visits_t& visits, size_t arm_count)
+    {
+        size_t n = 0;
+        for (size_t a = 0; a < arm_count; ++a)
+            n += visits.get_visits(static_cast<int>(a) + 1) > 0;
+        return n;
+    }
+};
+
+TEST_F(ProgressiveWideningTest, WidenedSizeGrowsAsPowerOfVisits)
+{
+    arms_t arms(100);
+    std::iota(arms.begin(), arms.end(), 0);
+
+    const widen_t pw(arms, 2.0, 0.5);
+    EXPECT_EQ(pw.size(), 100u);
+    EXPECT_EQ(pw.widened_size(0), 1u);
+    EXPECT_EQ(pw.widened_size(1), 2u);
+    EXPECT_EQ(pw.widened_size(100), 20u);
+    EXPECT_EQ(pw.widened_size(101), 21u);
+    EXPECT_EQ(pw.widened_size(10000), 100u);
+
+    const std::vector<size_t> order = monte_carlo::prior_order(arms.size(), [](size_t i)
+    {
+        return i == 42 ? 1.0 : 0.0;
+    });
+    const widen_t by_prior(arms, 2.0, 0.5, order);
+    EXPECT_EQ(by_prior.at(0), 42);
+    EXPECT_EQ(by_prior.at(1), 0);
+    EXPECT_EQ(by_prior.at(42), 41);
+    EXPECT_EQ(by_prior.at(43), 43);
+}
+
+TEST_F(ProgressiveWideningTest, SimExpandsOnlyTheWidenedPrefix)
+{
+    arms_t arms(200);
+    std::iota(arms.begin(), arms.end(), 0);
+    std::mt19937 rng(66);
+
+    visits_t visits;
+    value_t  value;
+    sim_train(visits, value, widen_t(arms, 1.0, 0.5), rng, 400);
+
+    // N = 399 at the last selection: ceil(sqrt(399)) = 20 arms.
+    EXPECT_EQ(expanded_arms(visits, arms.size()), 20u);
+    for (int a = 20; a < 200; ++a)
+        EXPECT_EQ(visits.get_visits(a + 1), 0u) << "arm " << a << " outside the prefix";
+
+    // Without widening every arm is tried once before any is repeated.
+    visits_t full_visits;
+    value_t  full_value;
+    sim_train(full_visits, full_value, widen_t(arms, 1e9, 0.0), rng, 400);
+    EXPECT_EQ(expanded_arms(full_visits, arms.size()), 200u);
+}
+
+TEST_F(ProgressiveWideningTest, PriorOrderWidensTowardsTheBestArm)
+{
+    arms_t arms(200);
+    std::iota(arms.begin(), arms.end(), 0);
+    std::mt19937 rng(67);
+
+    const std::vector<size_t> order = monte_carlo::prior_order(arms.size(), [](size_t i)
+    {
+        return -std::abs(static_cast<double>(i) - 150.0);
+    });
+
+    visits_t visits;
+    value_t  value;
+    sim_train(visits, value, widen_t(arms, 1.0, 0.5, order), rng, 400);
+
+    size_t best_visits = 0;
+    int    best_arm    = -1;
+    for (int a = 0; a < 200; ++a)
+        if (visits.get_visits(a + 1) > best_visits)
+        {
+            best_visits = visits.get_visits(a + 1);
+            best_arm    = a;
+        }
+    EXPECT_EQ(best_arm, 150);
+    EXPECT_EQ(expanded_arms(visits, arms.size()), 20u);
+}
+
+TEST_F(ProgressiveWideningTest, DbuctExpandsOnlyTheWidenedPrefix)
+{
+    arms_t arms(200);
+    std::iota(arms.begin(), arms.end(), 0);
+    std::mt19937 rng(68);
+
+    visits_t visits;
+    value_t  value;
+    dbuct_train(visits, value, widen_t(arms, 1.0, 0.5), rng, 2000);
+
+    // Root visits lag by at most one camping lump, so the prefix is bounded
+    // by the final root count.
+    const size_t root_visits = visits.get_visits(0);
+    EXPECT_GT(expanded_arms(visits, arms.size()), 1u);
+    EXPECT_LE(expanded_arms(visits, arms.size()),
+              static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(root_visits)))) + 1);
+}
+
+// ---------------------------------------------------------------------------
+// FirstPlayUrgencyTest
+//
+// With first_play_urgency as the exploration-constant policy, an unvisited
+// child scores the FPU value instead of +infinity, so a good child can be
+// revisited before its siblings are tried.  An FPU of +infinity must give
+// exactly the default statistics.
+// ---------------------------------------------------------------------------
+class FirstPlayUrgencyTest : public EdgeVisitsTest
+{
+protected:
+    using ec_t  = monte_carlo::uniform_exploration_constant<double>;
+    using fpu_t = monte_carlo::first_play_urgency<double, ec_t>;
+
+    template<typename IGetExplorationConstant>
+    void sim_train(visits_t&                  visits,
+                   value_t&                   value,
+                   IGetExplorationConstant&   ec,
+                   const std::vector<double>& track,
+                   const std::vector<jump_t>& jumps,
+                   std::mt19937&              rng,
+                   int                        n)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            rollout_t       rollout(rng);
+            position_walker walker;
+            monte_carlo::uniform_value_delta<double> delta;
+
+            monte_carlo::sim<
+                int, jump_t, double,
+                visits_t, value_t, visits_t, value_t,
+                position_walker,
+                std::vector<jump_t>, std::vector<jump_t>,
+                rollout_t,
+                monte_carlo::uniform_value_delta<double>,
+                IGetExplorationConstant
+            > s(visits, value, visits, value, walker, rollout, delta, ec, -1);
+
+            int    position = -1;
+            double reward   = 0.0;
+
+            while (true)
+            {
+                jump_t chosen = s.choose(jumps, jumps);
+                int    next   = position + chosen;
+                if (next >= static_cast<int>(track.size()))
+                {
+                    delta.set_value(reward);
+                    s.terminate();
+                    break;
+                }
+                position = next;
+                reward   = track[position];
+            }
+        }
+    }
+
+    template<typename IGetExplorationConstant>
+    void dbuct_train(visits_t&                  visits,
+                     value_t&                   value,
+                     IGetExplorationConstant&   ec,
+                     const std::vector<double>& track,
+                     const std::vector<jump_t>& jumps,
+                     std::mt19937&              rng,
+                     size_t                     gii,
+                     int                        n)
+    {
+        using batch_t      = monte_carlo::linear_batch_increment;
+        using dispatches_t = monte_carlo::dispatches_table<int, std::unordered_map>;
+
+        rollout_t       rollout(rng);
+        position_walker walker;
+        batch_t         batch(gii);
+        dispatches_t    dispatches;
+        monte_carlo::uniform_value_delta<double> delta;
+
+        monte_carlo::dbuct<
+            int, jump_t, double,
+            visits_t, value_t, visits_t, value_t,
+            dispatches_t, dispatches_t,
+            batch_t,
+            position_walker,
+            std::vector<jump_t>, std::vector<jump_t>,
+            rollout_t,
+            monte_carlo::uniform_value_delta<double>,
+            IGetExplorationConstant
+        > d(visits, value, visits, value, dispatches, dispatches, batch,
+            walker, rollout, delta, ec, -1);
+
+        std::vector<int> path = {-1};
+
+        for (int i = 0; i < n; ++i)
+        {
+            int    position = path.back();
+            double reward   = 0.0;
+
+            while (true)
+            {
+                jump_t chosen = d.choose(jumps, jumps);
+                int    next   = position + chosen;
+                if (!d.in_rollout())
+                    path.push_back(next);
+                if (next >= static_cast<int>(track.size()))
+                {
+                    delta.set_value(reward);
+                    d.terminate();
+                    path.resize(d.depth());
+                    break;
+                }
+                position = next;
+                reward   = track[position];
+            }
+        }
+    }
+};
+
+TEST_F(FirstPlayUrgencyTest, PolicyForwardsConstantAndScoresUnvisitedChildren)
+{
+    ec_t ec(1.5);
+
+    const fpu_t constant(ec, monte_carlo::fpu_mode::constant, 0.25);
+    EXPECT_DOUBLE_EQ(constant.get_exploration_constant(7), 1.5);
+    EXPECT_DOUBLE_EQ(constant.get_first_play_urgency(7, 3.0), 0.25);
+
+    const fpu_t reduced(ec, monte_carlo::fpu_mode::parent_mean, 0.25);
+    EXPECT_DOUBLE_EQ(reduced.get_first_play_urgency(7, 3.0), 2.75);
+    EXPECT_DOUBLE_EQ(reduced.get_first_play_urgency(7, 0.0), -0.25);
+}
+
+TEST_F(FirstPlayUrgencyTest, SimRevisitsAGoodChildBeforeTryingTheRest)
+{
+    // Jumps 1 and 2 land on 0.1, jump 3 on 1.0, the rest leave the track.
+    const std::vector<double> track = {0.1, 0.1, 1.0};
+    std::vector<jump_t>       jumps(200, 100);
+    jumps[0] = 1;
+    jumps[1] = 2;
+    jumps[2] = 3;
+    std::mt19937 rng(69);
+
+    // c = 0.3: a 0.1 child stays below the 0.5 FPU (until ln N > 1.78), the
+    // 1.0 child always beats it, so selection never reaches the fourth jump.
+    ec_t  ec(0.3);
+    fpu_t fpu(ec, monte_carlo::fpu_mode::constant, 0.5);
+
+    visits_t visits;
+    value_t  value;
+    sim_train(visits, value, fpu, track, jumps, rng, 100);
+
+    EXPECT_EQ(visits.get_visits(0), 1u);
+    EXPECT_EQ(visits.get_visits(1), 1u);
+    EXPECT_EQ(visits.get_visits(2), 98u);
+    EXPECT_EQ(visits.get_visits(99), 0u);
+}
+
+TEST_F(FirstPlayUrgencyTest, InfiniteFpuMatchesTheDefaultSeed70Track20Moves123)
+{
+    std::mt19937                           rng(70);
+    std::uniform_real_distribution<double> urd(-10, 10);
+    std::vector<double>                    track(20);
+    std::generate(track.begin(), track.end(), [&] { return urd(rng); });
+    const std::vector<jump_t> jumps = {1, 2, 3};
+
+    ec_t  ec(10.0);
+    fpu_t fpu(ec, monte_carlo::fpu_mode::constant, std::numeric_limits<double>::infinity());
+
+    visits_t     plain_visits, fpu_visits;
+    value_t      plain_value,  fpu_value;
+    std::mt19937 plain_rng(71), fpu_rng(71);
+    sim_train(plain_visits, plain_value, ec, track, jumps, plain_rng, 2000);
+    sim_train(fpu_visits, fpu_value, fpu, track, jumps, fpu_rng, 2000);
+
+    for (int p = -1; p < static_cast<int>(track.size()); ++p)
+    {
+        EXPECT_EQ(fpu_visits.get_visits(p), plain_visits.get_visits(p)) << "position " << p;
+        EXPECT_DOUBLE_EQ(fpu_value.get_value(p), plain_value.get_value(p)) << "position " << p;
+    }
+}
+
+TEST_F(FirstPlayUrgencyTest, SimWithParentMeanFpuConvergesSeed72Track20Moves123)
+{
+    std::mt19937                           rng(72);
+    std::uniform_real_distribution<double> urd(-10, 10);
+    std::vector<double>                    track(20);
+    std::generate(track.begin(), track.end(), [&] { return urd(rng); });
+    const std::vector<jump_t> jumps = {1, 2, 3};
+
+    ec_t  ec(10.0);
+    fpu_t fpu(ec, monte_carlo::fpu_mode::parent_mean, 0.0);
+
+    visits_t visits;
+    value_t  value;
+    sim_train(visits, value, fpu, track, jumps, rng, 20000);
+
+    EXPECT_NEAR(greedy_reward(visits, value, track, jumps),
+                optimal_last_position_score(track, jumps), kTolerance);
+}
+
+TEST_F(FirstPlayUrgencyTest, DbuctWithParentMeanFpuConvergesSeed73Track20Moves123)
+{
+    std::mt19937                           rng(73);
+    std::uniform_real_distribution<double> urd(-10, 10);
+    std::vector<double>                    track(20);
+    std::generate(track.begin(), track.end(), [&] { return urd(rng); });
+    const std::vector<jump_t> jumps = {1, 2, 3};
+
+    ec_t  ec(100.0);
+    fpu_t fpu(ec, monte_carlo::fpu_mode::parent_mean, 0.0);
+
+    visits_t visits;
+    value_t  value;
+    dbuct_train(visits, value, fpu, track, jumps, rng, 25, 20000);
+
+    EXPECT_NEAR(greedy_reward(visits, value, track, jumps),
+                optimal_last_position_score(track, jumps), kTolerance);
+}
+
+// ---------------------------------------------------------------------------
+// UcbArgmaxTableTest
+//
+// On a tree, selection through ucb_argmax_table must make exactly the choices
+// of the engines' scanning loop: every run below is replayed with the plain
+// exploration constant and the choice sequences compared.
+// ---------------------------------------------------------------------------
+class UcbArgmaxTableTest : public ::testing::Test
+{
+protected:
+    using arms_t    = std::vector<int>;
+    using visits_t  = monte_carlo::visits_table<uint64_t, std::unordered_map>;
+    using value_t   = monte_carlo::value_table<uint64_t, double, std::unordered_map>;
+    using ec_t      = monte_carlo::uniform_exploration_constant<double>;
+    using fpu_t     = monte_carlo::first_play_urgency<double, ec_t>;
+    using widen_t   = monte_carlo::progressive_widening<arms_t>;
+
+    template<typename IGetExplorationConstant>
+    using argmax_t = monte_carlo::ucb_argmax_table<uint64_t, double, IGetExplorationConstant,
+                                                   std::unordered_map>;
+
+    // Child a of node h is h * branching + a + 1, so handles never repeat.
+    struct tree_walker
+    {
+        uint64_t walk(const uint64_t& h, int a) const { return h * 64 + static_cast<uint64_t>(a) + 1; }
+    };
+
+    static constexpr int depth = 3;
+
+    static double leaf_reward(uint64_t h)
+    {
+        return static_cast<double>(monte_carlo::hash_mix(h) % 1000) / 1000.0;
+    }
+
+    // Runs n sim episodes and returns every choice made, in order.
+    template<typename IChoices, typename IGetExplorationConstant>
+    std::vector<int> sim_choices(const IChoices& choices, IGetExplorationConstant& ec,
+                                 double (*reward)(uint64_t), unsigned seed, int n)
+    {
+        using rollout_t = monte_carlo::random_rollout<int, std::mt19937, IChoices, IChoices>;
+
+        visits_t         visits;
+        value_t          value;
+        std::mt19937     rng(seed);
+        std::vector<int> made;
+
+        for (int i = 0; i < n; ++i)
+        {
+            rollout_t   rollout(rng);
+            tree_walker walker;
+            monte_carlo::uniform_value_delta<double> delta;
+
+            monte_carlo::sim<
+                uint64_t, int, double,
+                visits_t, value_t, visits_t, value_t,
+                tree_walker,
+                IChoices, IChoices,
+                rollout_t,
+                monte_carlo::uniform_value_delta<double>,
+                IGetExplorationConstant
+            > s(visits, value, visits, value, walker, rollout, delta, ec, 0);
+
+            uint64_t h = 0;
+            for (int d = 0; d < depth; ++d)
+            {
+                made.push_back(s.choose(choices, choices));
+                h = walker.walk(h, made.back());
+            }
+            delta.set_value(reward(h));
+            s.terminate();
+        }
+        return made;
+    }
+
+    // Runs n dbuct terminations likewise; camping frames resume below the root.
+    template<typename IGetExplorationConstant>
+    std::vector<int> dbuct_choices(const arms_t& choices, IGetExplorationConstant& ec,
+                                   unsigned seed, int n)
+    {
+        using rollout_t    = monte_carlo::random_rollout<int, std::mt19937, arms_t, arms_t>;
+        using batch_t      = monte_carlo::linear_batch_increment;
+        using dispatches_t = monte_carlo::dispatches_table<uint64_t, std::unordered_map>;
+
+        visits_t         visits;
+        value_t          value;
+        std::mt19937     rng(seed);
+        rollout_t        rollout(rng);
+        tree_walker      walker;
+        batch_t          batch(4);
+        dispatches_t     dispatches;
+        std::vector<int> made;
+        monte_carlo::uniform_value_delta<double> delta;
+
+        monte_carlo::dbuct<
+            uint64_t, int, double,
+            visits_t, value_t, visits_t, value_t,
+            dispatches_t, dispatches_t,
+            batch_t,
+            tree_walker,
+            arms_t, arms_t,
+            rollout_t,
+            monte_carlo::uniform_value_delta<double>,
+            IGetExplorationConstant
+        > d(visits, value, visits, value, dispatches, dispatches, batch,
+            walker, rollout, delta, ec, 0);
+
+        std::vector<uint64_t> path = {0};
+        for (int i = 0; i < n; ++i)
+        {
+            uint64_t h = path.back();
+            for (int k = static_cast<int>(path.size()) - 1; k < depth; ++k)
+            {
+                const bool in_tree = !d.in_rollout();
+                made.push_back(d.choose(choices, choices));
+                h = walker.walk(h, made.back());
+                if (in_tree)
+                    path.push_back(h);
+            }
+            delta.set_value(leaf_reward(h));
+            d.terminate();
+            path.resize(d.depth());
+        }
+        return made;
+    }
+};
+
+TEST_F(UcbArgmaxTableTest, SimMatchesTheScanSeed74Depth3Branching40)
+{
+    arms_t arms(40);
+    std::iota(arms.begin(), arms.end(), 0);
+
+    ec_t           ec(0.5);
+    argmax_t<ec_t> argmax(ec);
+
+    const std::vector<int> scan = sim_choices(arms, ec, leaf_reward, 74, 20000);
+    const std::vector<int> fast = sim_choices(arms, argmax, leaf_reward, 74, 20000);
+    EXPECT_EQ(fast, scan);
+    EXPECT_GT(argmax.size(), 40u);
+}
+
+TEST_F(UcbArgmaxTableTest, TiesGoToTheLowerIndexLikeTheScanSeed75)
+{
+    arms_t arms(40);
+    std::iota(arms.begin(), arms.end(), 0);
+
+    // Every leaf pays the same, so equal-visit siblings tie exactly.
+    ec_t           ec(0.5);
+    argmax_t<ec_t> argmax(ec);
+    auto           flat = [](uint64_t) { return 0.5; };
+
+    const std::vector<int> scan = sim_choices(arms, ec, +flat, 75, 5000);
+    const std::vector<int> fast = sim_choices(arms, argmax, +flat, 75, 5000);
+    EXPECT_EQ(fast, scan);
+}
+
+TEST_F(UcbArgmaxTableTest, SimWithFpuAndWideningMatchesTheScanSeed76)
+{
+    arms_t arms(40);
+    std::iota(arms.begin(), arms.end(), 0);
+    const widen_t pw(arms, 1.0, 0.5);
+
+    ec_t            ec(0.5);
+    fpu_t           fpu(ec, monte_carlo::fpu_mode::parent_mean, -0.1);
+    argmax_t<fpu_t> argmax(fpu);
+
+    const std::vector<int> scan = sim_choices(pw, fpu, leaf_reward, 76, 20000);
+    const std::vector<int> fast = sim_choices(pw, argmax, leaf_reward, 76, 20000);
+    EXPECT_EQ(fast, scan);
+}
+
+TEST_F(UcbArgmaxTableTest, DbuctMatchesTheScanSeed77Depth3Branching40)
+{
+    arms_t arms(40);
+    std::iota(arms.begin(), arms.end(), 0);
+
+    ec_t           ec(0.5);
+    argmax_t<ec_t> argmax(ec);
+
+    const std::vector<int> scan = dbuct_choices(arms, ec, 77, 20000);
+    const std::vector<int> fast = dbuct_choices(arms, argmax, 77, 20000);
+    EXPECT_EQ(fast, scan);
+}
+
+// ---------------------------------------------------------------------------
+// SelectPolicyTest
+//
+// Score-based ISelect policies through the shared select_child() loop:
+// ucb1 must reproduce the bare exploration constant, ucb1_tuned reads the
+// squared deltas that a value_moments_table accumulates, and puct follows
+// its prior.  Node h's child a is h * 64 + a + 1, so the tree has no
+// transpositions; rewards are Bernoulli with a per-leaf mean.
+// ---------------------------------------------------------------------------
+class SelectPolicyTest : public ::testing::Test
+{
+protected:
+    using arms_t    = std::vector<int>;
+    using visits_t  = monte_carlo::visits_table<uint64_t, std::unordered_map>;
+    using value_t   = monte_carlo::value_table<uint64_t, double, std::unordered_map>;
+    using moments_t = monte_carlo::value_moments_table<uint64_t, double, std::unordered_map>;
+    using ec_t      = monte_carlo::uniform_exploration_constant<double>;
+    using prior_t   = monte_carlo::prior_table<uint64_t, double, std::unordered_map>;
+
+    struct tree_walker
+    {
+        uint64_t walk(const uint64_t& h, int a) const { return h * 64 + static_cast<uint64_t>(a) + 1; }
+    };
+
+    // Mean reward of a leaf; Bernoulli draws around it.
+    static double leaf_mean(uint64_t h)
+    {
+        return static_cast<double>(monte_carlo::hash_mix(h) % 1000) / 1000.0;
+    }
+
+    static arms_t make_arms(int n)
+    {
+        arms_t arms(static_cast<size_t>(n));
+        std::iota(arms.begin(), arms.end(), 0);
+        return arms;
+    }
+
+    // Root child with the most visits.
+    static int most_visited(const visits_t& visits, int arms)
+    {
+        const tree_walker walker;
+        int               best = 0;
+        for (int a = 1; a < arms; ++a)
+            if (visits.get_visits(walker.walk(0, a)) > visits.get_visits(walker.walk(0, best)))
+                best = a;
+        return best;
+    }
+
+    // Root children visited at least once.
+    static int tried(const visits_t& visits, int arms)
+    {
+        const tree_walker walker;
+        int               count = 0;
+        for (int a = 0; a < arms; ++a)
+            count += visits.get_visits(walker.walk(0, a)) != 0;
+        return count;
+    }
+
+    // Runs n sim episodes of the given depth; returns every choice made.
+    template<typename IValue, typename ISelect>
+    std::vector<int> sim_run(visits_t& visits, IValue& value, const arms_t& arms,
+                             ISelect& select, int depth, unsigned seed, int n)
+    {
+        using rollout_t = monte_carlo::random_rollout<int, std::mt19937, arms_t, arms_t>;
+
+        std::mt19937     rng(seed);
+        std::vector<int> made;
+
+        for (int i = 0; i < n; ++i)
+        {
+            rollout_t   rollout(rng);
+            tree_walker walker;
+            monte_carlo::uniform_value_delta<double> delta;
+
+            monte_carlo::sim<
+                uint64_t, int, double,
+                visits_t, IValue, visits_t, IValue,
+                tree_walker,
+                arms_t, arms_t,
+                rollout_t,
+                monte_carlo::uniform_value_delta<double>,
+                ISelect
+            > s(visits, value, visits, value, walker, rollout, delta, select, 0);
+
+            uint64_t h = 0;
+            for (int d = 0; d < depth; ++d)
+            {
+                made.push_back(s.choose(arms, arms));
+                h = walker.walk(h, made.back());
+            }
+            delta.set_value(std::bernoulli_distribution(leaf_mean(h))(rng) ? 1.0 : 0.0);
+            s.terminate();
+        }
+        return made;
+    }
+
+    // Runs n dbuct terminations of the given depth.
+    template<typename IValue, typename ISelect>
+    void dbuct_run(visits_t& visits, IValue& value, const arms_t& arms,
+                   ISelect& select, int depth, unsigned seed, int n)
+    {
+        using rollout_t    = monte_carlo::random_rollout<int, std::mt19937, arms_t, arms_t>;
+        using batch_t      = monte_carlo::linear_batch_increment;
+        using dispatches_t = monte_carlo::dispatches_table<uint64_t, std::unordered_map>;
+
+        std::mt19937 rng(seed);
+        rollout_t    rollout(rng);
+        tree_walker  walker;
+        batch_t      batch(4);
+        dispatches_t dispatches;
+        monte_carlo::uniform_value_delta<double> delta;
+
+        monte_carlo::dbuct<
+            uint64_t, int, double,
+            visits_t, IValue, visits_t, IValue,
+            dispatches_t, dispatches_t,
+            batch_t,
+            tree_walker,
+            arms_t, arms_t,
+            rollout_t,
+            monte_carlo::uniform_value_delta<double>,
+            ISelect
+        > d(visits, value, visits, value, dispatches, dispatches, batch,
+            walker, rollout, delta, select, 0);
+
+        std::vector<uint64_t> path = {0};
+        for (int i = 0; i < n; ++i)
+        {
+            uint64_t h = path.back();
+            for (int k = static_cast<int>(path.size()) - 1; k < depth; ++k)
+            {
+                const bool in_tree = !d.in_rollout();
+                h = walker.walk(h, d.choose(arms, arms));
+                if (in_tree)
+                    path.push_back(h);
+            }
+            delta.set_value(std::bernoulli_distribution(leaf_mean(h))(rng) ? 1.0 : 0.0);
+            d.terminate();
+            path.resize(d.depth());
+        }
+    }
+};
+
+TEST_F(SelectPolicyTest, Ucb1MatchesTheBareConstantSeed78Depth3Branching20)
+{
+    const arms_t arms = make_arms(20);
+
+    ec_t                           ec(0.7);
+    monte_carlo::ucb1<double, ec_t> ucb(ec);
+
+    visits_t v1, v2;
+    value_t  q1, q2;
+    EXPECT_EQ(sim_run(v1, q1, arms, ucb, 3, 78, 5000),
+              sim_run(v2, q2, arms, ec, 3, 78, 5000));
+}
+
+TEST_F(SelectPolicyTest, MomentsTableKeepsTheSumOfSquaredDeltas)
+{
+    // 0/1 rewards square to themselves, so squares == value at every node.
+    const arms_t arms = make_arms(8);
+
+    ec_t                                  ec(1.0);
+    monte_carlo::ucb1_tuned<double, ec_t> tuned(ec);
+
+    visits_t  sim_visits, dbuct_visits;
+    moments_t sim_moments, dbuct_moments;
+    sim_run(sim_visits, sim_moments, arms, tuned, 2, 79, 2000);
+    dbuct_run(dbuct_visits, dbuct_moments, arms, tuned, 2, 79, 2000);
+
+    const tree_walker walker;
+    for (const moments_t* m : {&sim_moments, &dbuct_moments})
+    {
+        EXPECT_GT(m->get_value(0), 0.0);
+        EXPECT_DOUBLE_EQ(m->get_value_squares(0), m->get_value(0));
+        for (int a = 0; a < 8; ++a)
+            EXPECT_DOUBLE_EQ(m->get_value_squares(walker.walk(0, a)),
+                             m->get_value(walker.walk(0, a)));
+    }
+    EXPECT_EQ(sim_visits.get_visits(0), 2000u);
+}
+
+TEST_F(SelectPolicyTest, Ucb1TunedFindsTheBestArmSeed80Bandit20)
+{
+    const arms_t arms = make_arms(20);
+    int          best = 0;
+    for (int a = 1; a < 20; ++a)
+        if (leaf_mean(tree_walker{}.walk(0, a)) > leaf_mean(tree_walker{}.walk(0, best)))
+            best = a;
+
+    ec_t                                  ec(1.0);
+    monte_carlo::ucb1_tuned<double, ec_t> tuned(ec);
+
+    visits_t  sim_visits, dbuct_visits;
+    moments_t sim_moments, dbuct_moments;
+    sim_run(sim_visits, sim_moments, arms, tuned, 1, 80, 5000);
+    dbuct_run(dbuct_visits, dbuct_moments, arms, tuned, 1, 80, 5000);
+
+    EXPECT_EQ(most_visited(sim_visits, 20), best);
+    EXPECT_EQ(most_visited(dbuct_visits, 20), best);
+    EXPECT_GT(sim_visits.get_visits(tree_walker{}.walk(0, best)), 2500u);
+}
+
+TEST_F(SelectPolicyTest, PriorTableRowsAndFallback)
+{
+    prior_t priors(0.25);
+    EXPECT_TRUE(priors.priors(7).empty());
+    EXPECT_DOUBLE_EQ(priors.get_prior(7, 3), 0.25);
+
+    const std::vector<double> row = {0.5, 0.3, 0.2};
+    priors.set_priors(7, row);
+    ASSERT_EQ(priors.priors(7).size(), 3u);
+    EXPECT_DOUBLE_EQ(priors.get_prior(7, 1), 0.3);
+    EXPECT_DOUBLE_EQ(priors.get_prior(7, 3), 0.25);
+    EXPECT_EQ(priors.size(), 1u);
+}
+
+TEST_F(SelectPolicyTest, PuctFollowsAGoodPriorWithoutTryingEveryArmSeed81)
+{
+    // The prior puts most of its mass on the best arm; PUCT should settle on
+    // it while leaving most of the 40 arms untried, unlike UCB1.
+    const arms_t arms = make_arms(40);
+    int          best = 0;
+    for (int a = 1; a < 40; ++a)
+        if (leaf_mean(tree_walker{}.walk(0, a)) > leaf_mean(tree_walker{}.walk(0, best)))
+            best = a;
+
+    std::vector<double> row(40, 0.1 / 39);
+    row[static_cast<size_t>(best)] = 0.9;
+    prior_t priors;
+    priors.set_priors(0, row);
+
+    ec_t                                     ec(1.5);
+    monte_carlo::puct<double, ec_t, prior_t> puct(ec, priors);
+
+    visits_t sim_visits, dbuct_visits;
+    value_t  sim_value, dbuct_value;
+    sim_run(sim_visits, sim_value, arms, puct, 1, 81, 400);
+    dbuct_run(dbuct_visits, dbuct_value, arms, puct, 1, 81, 400);
+
+    EXPECT_EQ(most_visited(sim_visits, 40), best);
+    EXPECT_EQ(most_visited(dbuct_visits, 40), best);
+    EXPECT_LT(tried(sim_visits, 40), 40);
+    EXPECT_LT(tried(dbuct_visits, 40), 40);
+}
+
+TEST_F(SelectPolicyTest, PuctWithUniformPriorSpreadsAndConvergesSeed82)
+{
+    const arms_t arms = make_arms(10);
+    int          best = 0;
+    for (int a = 1; a < 10; ++a)
+        if (leaf_mean(tree_walker{}.walk(0, a)) > leaf_mean(tree_walker{}.walk(0, best)))
+            best = a;
+
+    // parent_mean + 1 first-play value tries every arm before settling.
+    ec_t                                          ec(1.0);
+    monte_carlo::first_play_urgency<double, ec_t> fpu(ec, monte_carlo::fpu_mode::parent_mean, -1.0);
+    monte_carlo::uniform_prior<double>            uniform(0.1);
+    monte_carlo::puct<double, decltype(fpu), decltype(uniform)> puct(fpu, uniform);
+
+    visits_t visits;
+    value_t  value;
+    sim_run(visits, value, arms, puct, 1, 82, 5000);
+
+    EXPECT_EQ(tried(visits, 10), 10);
+    EXPECT_EQ(most_visited(visits, 10), best);
+}
+
+// ---------------------------------------------------------------------------
+// SolverTest
+//
+// With a proof_table as the value table, episodes ending at a terminal in the
+// tree prove it and the proofs climb to the root.  The game is a tree of
+// depth 3 and branching 5 whose leaves pay a fixed reward, so the root's
+// exact value is the best leaf reward.  A proven child competes in selection
+// by its exact value, so once the best one is proven its siblings are
+// revisited only as their explore terms grow; the solving tests use c = 2.
+// ---------------------------------------------------------------------------
+class SolverTest : public ::testing::Test
+{
+protected:
+    using arms_t   = std::vector<int>;
+    using visits_t = monte_carlo::visits_table<uint64_t, std::unordered_map>;
+    using value_t  = monte_carlo::value_table<uint64_t, double, std::unordered_map>;
+    using proofs_t = monte_carlo::proof_table<uint64_t, double, value_t, std::unordered_map>;
+    using ec_t     = monte_carlo::uniform_exploration_constant<double>;
+
+    struct tree_walker
+    {
+        uint64_t walk(const uint64_t& h, int a) const { return h * 64 + static_cast<uint64_t>(a) + 1; }
+    };
+
+    static constexpr int depth     = 3;
+    static constexpr int branching = 5;
+
+    static double leaf_reward(uint64_t h)
+    {
+        return static_cast<double>(monte_carlo::hash_mix(h) % 1000) / 1000.0;
+    }
+
+    // 1 for roughly one leaf in eight, else 0.
+    static double win_loss(uint64_t h)
+    {
+        return monte_carlo::hash_mix(h) % 8 == 0 ? 1.0 : 0.0;
+    }
+
+    static double best_leaf(double (*reward)(uint64_t))
+    {
+        const tree_walker walker;
+        double            best = -1.0;
+        for (int a = 0; a < branching; ++a)
+            for (int b = 0; b < branching; ++b)
+                for (int c = 0; c < branching; ++c)
+                    best = std::max(best, reward(walker.walk(walker.walk(walker.walk(0, a), b), c)));
+        return best;
+    }
+
+    SolverTest() : arms(branching)
+    {
+        std::iota(arms.begin(), arms.end(), 0);
+    }
+
+    // One sim episode; returns solved() after it.
+    bool sim_episode(visits_t& visits, proofs_t& proofs, ec_t& ec,
+                     double (*reward)(uint64_t), std::mt19937& rng)
+    {
+        using rollout_t = monte_carlo::random_rollout<int, std::mt19937, arms_t, arms_t>;
+
+        rollout_t   rollout(rng);
+        tree_walker walker;
+        monte_carlo::uniform_value_delta<double> delta;
+
+        monte_carlo::sim<
+            uint64_t, int, double,
+            visits_t, proofs_t, visits_t, proofs_t,
+            tree_walker,
+            arms_t, arms_t,
+            rollout_t,
+            monte_carlo::uniform_value_delta<double>,
+            ec_t
+        > s(visits, proofs, visits, proofs, walker, rollout, delta, ec, 0);
+
+        uint64_t h = 0;
+        for (int d = 0; d < depth; ++d)
+            h = walker.walk(h, s.choose(arms, arms));
+        delta.set_value(reward(h));
+        s.terminate();
+        return s.solved();
+    }
+
+    arms_t arms;
+};
+
+TEST_F(SolverTest, ProofTableCountsChildrenAndHonoursTheBound)
+{
+    value_t  value;
+    proofs_t proofs(value, monte_carlo::proof_backup::max, 1.0);
+
+    proofs.set_child_count(1, 3);
+    proofs.set_child_count(1, 7);   // kept once known
+    EXPECT_FALSE(proofs.add_proven_child(1, 0.2));
+    EXPECT_FALSE(proofs.add_proven_child(1, 0.6));
+    EXPECT_FALSE(proofs.is_proven(1));
+    EXPECT_TRUE(proofs.add_proven_child(1, 0.4));
+    EXPECT_TRUE(proofs.is_proven(1));
+    EXPECT_DOUBLE_EQ(proofs.get_proven_value(1), 0.6);
+    EXPECT_FALSE(proofs.add_proven_child(1, 0.9));   // already proven
+
+    // A child at the bound proves its parent at once.
+    proofs.set_child_count(2, 5);
+    EXPECT_TRUE(proofs.add_proven_child(2, 1.0));
+    EXPECT_DOUBLE_EQ(proofs.get_proven_value(2), 1.0);
+
+    EXPECT_TRUE(proofs.prove(3, 0.5));
+    EXPECT_FALSE(proofs.prove(3, 0.7));
+    EXPECT_DOUBLE_EQ(proofs.get_proven_value(3), 0.5);
+
+    proofs.set_value(3, 2.5);
+    EXPECT_DOUBLE_EQ(value.get_value(3), 2.5);
+}
+
+TEST_F(SolverTest, NegamaxBackupNegatesTheBestChild)
+{
+    value_t  value;
+    proofs_t proofs(value, monte_carlo::proof_backup::negamax);
+
+    proofs.set_child_count(1, 2);
+    EXPECT_FALSE(proofs.add_proven_child(1, -1.0));
+    EXPECT_TRUE(proofs.add_proven_child(1, 0.0));
+    EXPECT_DOUBLE_EQ(proofs.get_proven_value(1), 0.0);
+}
+
+TEST_F(SolverTest, SimSolvesTheRootWithTheBestLeafSeed83)
+{
+    visits_t     visits;
+    value_t      value;
+    proofs_t     proofs(value);
+    ec_t         ec(2.0);
+    std::mt19937 rng(83);
+
+    int sims = 0;
+    while (!sim_episode(visits, proofs, ec, leaf_reward, rng))
+        ASSERT_LT(++sims, 5000);
+
+    EXPECT_TRUE(proofs.is_proven(0));
+    EXPECT_DOUBLE_EQ(proofs.get_proven_value(0), best_leaf(leaf_reward));
+
+    // Once solved, only the best root child can win selection.
+    const tree_walker   walker;
+    std::vector<size_t> before;
+    int                 best = 0;
+    for (int a = 0; a < branching; ++a)
+    {
+        before.push_back(visits.get_visits(walker.walk(0, a)));
+        if (proofs.get_proven_value(walker.walk(0, a)) > proofs.get_proven_value(walker.walk(0, best)))
+            best = a;
+    }
+    for (int i = 0; i < 100; ++i)
+        sim_episode(visits, proofs, ec, leaf_reward, rng);
+    for (int a = 0; a < branching; ++a)
+        if (a == best)
+            EXPECT_EQ(visits.get_visits(walker.walk(0, a)), before[static_cast<size_t>(a)] + 100);
+        else
+            EXPECT_EQ(visits.get_visits(walker.walk(0, a)), before[static_cast<size_t>(a)]);
+}
+
+TEST_F(SolverTest, ProvenBestChildKeepsItsVisitsBeforeTheRootIsSolvedSeed114)
+{
+    using rollout_t = monte_carlo::random_rollout<int, std::mt19937, arms_t, arms_t>;
+    using delta_t   = monte_carlo::uniform_value_delta<double>;
+
+    // Root choice 0 ends the game at once with 0.9, proven on its first
+    // visit; choice 1 leads into the depth-3 tree, paying at most 0.5.
+    const arms_t root_arms = {0, 1};
+    const auto   reward    = [](uint64_t h) { return 0.5 * leaf_reward(h); };
+
+    visits_t     visits;
+    value_t      value;
+    proofs_t     proofs(value);
+    ec_t         ec(0.5);
+    std::mt19937 rng(114);
+    tree_walker  walker;
+    delta_t      delta;
+
+    for (int i = 0; i < 300; ++i)
+    {
+        rollout_t rollout(rng);
+        monte_carlo::sim<
+            uint64_t, int, double,
+            visits_t, proofs_t, visits_t, proofs_t,
+            tree_walker, arms_t, arms_t, rollout_t, delta_t, ec_t
+        > s(visits, proofs, visits, proofs, walker, rollout, delta, ec, 0);
+
+        uint64_t h = walker.walk(0, s.choose(root_arms, root_arms));
+        if (h == walker.walk(0, 0))
+            delta.set_value(0.9);
+        else
+        {
+            for (int d = 0; d < depth; ++d)
+                h = walker.walk(h, s.choose(arms, arms));
+            delta.set_value(reward(h));
+        }
+        s.terminate();
+        ASSERT_FALSE(s.solved()) << "sim " << i;
+    }
+
+    // A visit-based decision taken now picks the proven best move.
+    const uint64_t proven = walker.walk(0, 0);
+    const uint64_t open   = walker.walk(0, 1);
+    ASSERT_TRUE(proofs.is_proven(proven));
+    ASSERT_FALSE(proofs.is_proven(open));
+    EXPECT_GT(visits.get_visits(proven), visits.get_visits(open));
+    EXPECT_GT(visits.get_visits(open), 1u);
+}
+
+TEST_F(SolverTest, BoundProvesAWinWithoutSolvingEveryLeafSeed85)
+{
+    ASSERT_DOUBLE_EQ(best_leaf(win_loss), 1.0);
+
+    visits_t     visits;
+    value_t      value;
+    proofs_t     proofs(value, monte_carlo::proof_backup::max, 1.0);
+    ec_t         ec(0.5);
+    std::mt19937 rng(85);
+
+    int sims = 0;
+    while (!sim_episode(visits, proofs, ec, win_loss, rng))
+        ASSERT_LT(++sims, 5000);
+
+    EXPECT_DOUBLE_EQ(proofs.get_proven_value(0), 1.0);
+    // Full proof needs all 125 leaves expanded, plus the 30 inner nodes.
+    EXPECT_LT(sims, 155);
+}
+
+TEST_F(SolverTest, DriverStopsOnceTheRootIsSolvedSeed113)
+{
+    using rollout_t = monte_carlo::random_rollout<int, std::mt19937, arms_t, arms_t>;
+    using delta_t   = monte_carlo::uniform_value_delta<double>;
+    using sim_t     = monte_carlo::sim<
+                          uint64_t, int, double,
+                          visits_t, proofs_t, visits_t, proofs_t,
+                          tree_walker, arms_t, arms_t,
+                          rollout_t, delta_t, ec_t>;
+
+    // The solver tree as a search_driver game.
+    struct tree_model
+    {
+        const arms_t& arms;
+        uint64_t      h = 0;
+        int           d = 0;
+
+        uint64_t      root() const         { return 0; }
+        void          restart()            { h = 0; d = 0; }
+        bool          terminal() const     { return d == depth; }
+        const arms_t& choice_count() const { return arms; }
+        const arms_t& choice_at() const    { return arms; }
+        double        reward() const       { return leaf_reward(h); }
+
+        void apply(int a)
+        {
+            h = tree_walker{}.walk(h, a);
+            ++d;
+        }
+    };
+
+    visits_t     visits;
+    value_t      value;
+    proofs_t     proofs(value);
+    ec_t         ec(2.0);
+    std::mt19937 rng(113);
+    rollout_t    rollout(rng);
+    tree_walker  walker;
+    delta_t      delta;
+    tree_model   game{arms};
+
+    monte_carlo::search_driver<sim_t, tree_model, delta_t> driver(
+        game, delta, visits, proofs, visits, proofs, walker, rollout, delta, ec, 0);
+
+    const size_t ran = driver.run(5000);
+    EXPECT_LT(ran, 1000u);
+    EXPECT_TRUE(driver.engine().solved());
+    EXPECT_DOUBLE_EQ(proofs.get_proven_value(0), best_leaf(leaf_reward));
+    EXPECT_EQ(visits.get_visits(0), ran);
+
+    EXPECT_EQ(driver.run(100), 0u);
+    EXPECT_EQ(driver.run_until(std::chrono::steady_clock::now() + std::chrono::seconds(10), 16), 0u);
+    EXPECT_EQ(driver.simulations(), ran);
+}
+
+TEST_F(SolverTest, DbuctSolvesTheRootWithTheBestLeafSeed84)
+{
+    using rollout_t    = monte_carlo::random_rollout<int, std::mt19937, arms_t, arms_t>;
+    using batch_t      = monte_carlo::linear_batch_increment;
+    using dispatches_t = monte_carlo::dispatches_table<uint64_t, std::unordered_map>;
+
+    visits_t     visits;
+    value_t      value;
+    proofs_t     proofs(value);
+    ec_t         ec(2.0);
+    std::mt19937 rng(84);
+    rollout_t    rollout(rng);
+    tree_walker  walker;
+    batch_t      batch(4);
+    dispatches_t dispatches;
+    monte_carlo::uniform_value_delta<double> delta;
+
+    monte_carlo::dbuct<
+        uint64_t, int, double,
+        visits_t, proofs_t, visits_t, proofs_t,
+        dispatches_t, dispatches_t,
+        batch_t,
+        tree_walker,
+        arms_t, arms_t,
+        rollout_t,
+        monte_carlo::uniform_value_delta<double>,
+        ec_t
+    > d(visits, proofs, visits, proofs, dispatches, dispatches, batch,
+        walker, rollout, delta, ec, 0);
+
+    std::vector<uint64_t> path = {0};
+    int                   sims = 0;
+    while (!d.solved())
+    {
+        ASSERT_LT(++sims, 5000);
+        uint64_t h = path.back();
+        for (int k = static_cast<int>(path.size()) - 1; k < depth; ++k)
+        {
+            const bool in_tree = !d.in_rollout();
+            h = walker.walk(h, d.choose(arms, arms));
+            if (in_tree)
+                path.push_back(h);
+        }
+        delta.set_value(leaf_reward(h));
+        d.terminate();
+        path.resize(d.depth());
+    }
+
+    EXPECT_DOUBLE_EQ(proofs.get_proven_value(0), best_leaf(leaf_reward));
+}
+
+// ---------------------------------------------------------------------------
+// EarlyStopTest
+//
+// early_stop reads the root's children every K simulations and stops once
+// the root decision is settled: by visit gap against the remaining budget,
+// or by separated confidence bounds on the child means.
+// ---------------------------------------------------------------------------
+class EarlyStopTest : public ::testing::Test
+{
+protected:
+    using arms_t   = std::vector<int>;
+    using visits_t = monte_carlo::visits_table<int, std::unordered_map>;
+    using value_t  = monte_carlo::value_table<int, double, std::unordered_map>;
+
+    struct arm_walker
+    {
+        int walk(const int& h, int a) const { return h * 10 + a + 1; }
+    };
+
+    using stop_t = monte_carlo::early_stop<int, double, visits_t, value_t, arm_walker>;
+
+    // Sets root child a to v visits with mean m.
+    void set_arm(int a, size_t v, double m)
+    {
+        visits.set_visits(walker.walk(0, a), v);
+        value.set_value(walker.walk(0, a), m * static_cast<double>(v));
+    }
+
+    // Bernoulli bandit on the root's children, one sim episode per pull;
+    // returns the number of simulations run.
+    size_t bandit(const arms_t& arms, const std::vector<double>& p, size_t budget, stop_t* stop)
+    {
+        using rollout_t = monte_carlo::random_rollout<int, std::mt19937, arms_t, arms_t>;
+        using ec_t      = monte_carlo::uniform_exploration_constant<double>;
+
+        std::mt19937 rng(86);
+        ec_t         ec(0.5);
+
+        for (size_t i = 1; i <= budget; ++i)
+        {
+            rollout_t rollout(rng);
+            monte_carlo::uniform_value_delta<double> delta;
+
+            monte_carlo::sim<
+                int, int, double,
+                visits_t, value_t, visits_t, value_t,
+                arm_walker,
+                arms_t, arms_t,
+                rollout_t,
+                monte_carlo::uniform_value_delta<double>,
+                ec_t
+            > s(visits, value, visits, value, walker, rollout, delta, ec, 0);
+
+            const int a = s.choose(arms, arms);
+            delta.set_value(std::bernoulli_distribution(p[static_cast<size_t>(a)])(rng) ? 1.0 : 0.0);
+            s.terminate();
+
+            if (stop && stop->should_stop(0, arms, arms, i, budget))
+                return i;
+        }
+        return budget;
+    }
+
+    int most_visited(const arms_t& arms) const
+    {
+        int best = 0;
+        for (int a : arms)
+            if (visits.get_visits(walker.walk(0, a)) > visits.get_visits(walker.walk(0, best)))
+                best = a;
+        return best;
+    }
+
+    visits_t   visits;
+    value_t    value;
+    arm_walker walker;
+};
+
+TEST_F(EarlyStopTest, VisitGapStopsOnlyWhenTheBudgetCannotChangeTheLeader)
+{
+    const arms_t arms = {0, 1, 2};
+    stop_t       stop(visits, value, walker, monte_carlo::stop_rule::visit_gap, 50);
+
+    set_arm(0, 10, 0.5);
+    set_arm(1, 100, 0.5);
+    set_arm(2, 40, 0.5);
+
+    // Gap 60: stops once fewer than 60 simulations remain, at checks only.
+    EXPECT_FALSE(stop.should_stop(0, arms, arms, 100, 200));
+    EXPECT_FALSE(stop.should_stop(0, arms, arms, 140, 200));
+    EXPECT_FALSE(stop.should_stop(0, arms, arms, 149, 200));
+    EXPECT_TRUE(stop.should_stop(0, arms, arms, 150, 200));
+    EXPECT_EQ(stop.checks(), 2u);
+}
+
+TEST_F(EarlyStopTest, ConfidenceNeedsSeparatedBoundsOverEveryChild)
+{
+    const arms_t arms = {0, 1, 2};
+    stop_t       stop(visits, value, walker, monte_carlo::stop_rule::confidence, 1, 1.0, 0.05);
+
+    set_arm(0, 1000, 0.8);
+    set_arm(1, 1000, 0.5);
+    EXPECT_FALSE(stop.should_stop(0, arms, arms, 1, 100000));   // arm 2 unvisited
+
+    set_arm(2, 1000, 0.4);
+    EXPECT_TRUE(stop.should_stop(0, arms, arms, 2, 100000));
+
+    // Radius at 1000 visits is about 0.05, so 0.8 vs 0.75 overlaps.
+    set_arm(1, 1000, 0.75);
+    EXPECT_FALSE(stop.should_stop(0, arms, arms, 3, 100000));
+}
+
+TEST_F(EarlyStopTest, VisitGapKeepsTheFullBudgetDecisionSeed86)
+{
+    const arms_t              arms = {0, 1, 2, 3, 4};
+    const std::vector<double> p    = {0.3, 0.5, 0.8, 0.4, 0.6};
+
+    const size_t full = bandit(arms, p, 20000, nullptr);
+    const int    full_choice = most_visited(arms);
+
+    visits = {};
+    value  = {};
+    stop_t       stop(visits, value, walker, monte_carlo::stop_rule::visit_gap, 100);
+    const size_t used = bandit(arms, p, 20000, &stop);
+
+    EXPECT_EQ(full, 20000u);
+    EXPECT_LT(used, 15000u);
+    EXPECT_EQ(most_visited(arms), full_choice);
+    EXPECT_EQ(full_choice, 2);
+}
+
+// ---------------------------------------------------------------------------
+// SequentialHalvingTest
+//
+// sequential_halving replaces UCB1 at the root only: each round brings the
+// survivors to a common visit target and keeps the better half by mean.
+// Root children of node 0 are 1..k; their children are leaves paying a
+// Bernoulli reward.
+// ---------------------------------------------------------------------------
+class SequentialHalvingTest : public ::testing::Test
+{
+protected:
+    using arms_t    = std::vector<int>;
+    using visits_t  = monte_carlo::visits_table<int, std::unordered_map>;
+    using value_t   = monte_carlo::value_table<int, double, std::unordered_map>;
+    using ec_t      = monte_carlo::uniform_exploration_constant<double>;
+    using halving_t = monte_carlo::sequential_halving<int, double, ec_t>;
+
+    struct arm_walker
+    {
+        int walk(const int& h, int a) const { return h * 16 + a + 1; }
+    };
+
+    static double arm_mean(int a) { return 0.2 + 0.05 * a; }   // arm k-1 is best
+
+    // Runs budget sim episodes of depth 1 against the given selection policy.
+    template<typename ISelect>
+    void bandit(visits_t& visits, value_t& value, const arms_t& arms, ISelect& select,
+                size_t budget, unsigned seed)
+    {
+        using rollout_t = monte_carlo::random_rollout<int, std::mt19937, arms_t, arms_t>;
+
+        std::mt19937 rng(seed);
+        arm_walker   walker;
+
+        for (size_t i = 0; i < budget; ++i)
+        {
+            rollout_t rollout(rng);
+            monte_carlo::uniform_value_delta<double> delta;
+
+            monte_carlo::sim<
+                int, int, double,
+                visits_t, value_t, visits_t, value_t,
+                arm_walker,
+                arms_t, arms_t,
+                rollout_t,
+                monte_carlo::uniform_value_delta<double>,
+                ISelect
+            > s(visits, value, visits, value, walker, rollout, delta, select, 0);
+
+            const int a = s.choose(arms, arms);
+            delta.set_value(std::bernoulli_distribution(arm_mean(a))(rng) ? 1.0 : 0.0);
+            s.terminate();
+        }
+    }
+
+    static arms_t make_arms(int k)
+    {
+        arms_t arms(static_cast<size_t>(k));
+        std::iota(arms.begin(), arms.end(), 0);
+        return arms;
+    }
+
+    static int most_visited(const visits_t& visits, const arms_t& arms)
+    {
+        int best = 0;
+        for (int a : arms)
+            if (visits.get_visits(arm_walker{}.walk(0, a)) > visits.get_visits(arm_walker{}.walk(0, best)))
+                best = a;
+        return best;
+    }
+};
+
+TEST_F(SequentialHalvingTest, RoundsBringSurvivorsToTheirVisitTargets)
+{
+    // 8 children, 240 sims: 3 rounds of 80, targets 10, 30 and 70 visits.
+    const arms_t arms = make_arms(8);
+    ec_t         ec(1.0);
+    halving_t    halving(ec, 0, 240);
+    visits_t     visits;
+    value_t      value;
+
+    bandit(visits, value, arms, halving, 240, 87);
+
+    std::vector<size_t> counts;
+    for (int a : arms)
+        counts.push_back(visits.get_visits(arm_walker{}.walk(0, a)));
+    std::sort(counts.begin(), counts.end());
+    EXPECT_EQ(counts, (std::vector<size_t>{10, 10, 10, 10, 30, 30, 70, 70}));
+
+    // The last halving runs at the next root selection.
+    EXPECT_EQ(halving.round(), 2u);
+    ASSERT_EQ(halving.survivors().size(), 2u);
+
+    auto mean = [&](size_t i)
+    {
+        const int child = arm_walker{}.walk(0, static_cast<int>(i));
+        return value.get_value(child) / static_cast<double>(visits.get_visits(child));
+    };
+    const size_t a      = halving.survivors()[0];
+    const size_t b      = halving.survivors()[1];
+    const int    leader = static_cast<int>(mean(b) > mean(a) ? b : a);
+    const size_t before = visits.get_visits(arm_walker{}.walk(0, leader));
+
+    // Past the budget every root visit goes to the better of the two.
+    bandit(visits, value, arms, halving, 20, 88);
+    EXPECT_EQ(halving.round(), 3u);
+    ASSERT_EQ(halving.survivors().size(), 1u);
+    EXPECT_EQ(static_cast<int>(halving.survivors().front()), leader);
+    EXPECT_EQ(visits.get_visits(arm_walker{}.walk(0, leader)), before + 20);
+}
+
+TEST_F(SequentialHalvingTest, PicksTheBestArmMoreOftenThanUcb1AtSmallBudgets)
+{
+    const arms_t arms = make_arms(16);
+    int          halving_right = 0;
+    int          ucb_right     = 0;
+
+    for (unsigned seed = 0; seed < 100; ++seed)
+    {
+        ec_t      ec(1.0);
+        halving_t halving(ec, 0, 200);
+        visits_t  hv, uv;
+        value_t   hq, uq;
+
+        bandit(hv, hq, arms, halving, 200, seed);
+        bandit(uv, uq, arms, ec, 200, seed);
+
+        halving_right += static_cast<int>(halving.survivors().front()) == 15;
+        ucb_right     += most_visited(uv, arms) == 15;
+    }
+
+    EXPECT_GT(halving_right, ucb_right);
+}
+
+TEST_F(SequentialHalvingTest, DbuctHalvesTheRootAndSearchesBelowIt)
+{
+    using rollout_t    = monte_carlo::random_rollout<int, std::mt19937, arms_t, arms_t>;
+    using batch_t      = monte_carlo::linear_batch_increment;
+    using dispatches_t = monte_carlo::dispatches_table<int, std::unordered_map>;
+
+    const arms_t arms = make_arms(8);
+    ec_t         ec(1.0);
+    halving_t    halving(ec, 0, 400);
+    visits_t     visits;
+    value_t      value;
+    dispatches_t dispatches;
+    batch_t      batch(4);
+    std::mt19937 rng(89);
+    rollout_t    rollout(rng);
+    arm_walker   walker;
+    monte_carlo::uniform_value_delta<double> delta;
+
+    monte_carlo::dbuct<
+        int, int, double,
+        visits_t, value_t, visits_t, value_t,
+        dispatches_t, dispatches_t,
+        batch_t,
+        arm_walker,
+        arms_t, arms_t,
+        rollout_t,
+        monte_carlo::uniform_value_delta<double>,
+        halving_t
+    > d(visits, value, visits, value, dispatches, dispatches, batch,
+        walker, rollout, delta, halving, 0);
+
+    // Depth 2: the second move picks a leaf whose mean is its parent's arm mean.
+    std::vector<int> path = {0};
+    for (int i = 0; i < 500; ++i)
+    {
+        int h = path.back();
+        for (int k = static_cast<int>(path.size()) - 1; k < 2; ++k)
+        {
+            const bool in_tree = !d.in_rollout();
+            h = walker.walk(h, d.choose(arms, arms));
+            if (in_tree)
+                path.push_back(h);
+        }
+        delta.set_value(std::bernoulli_distribution(arm_mean((h - 1) / 16 - 1))(rng) ? 1.0 : 0.0);
+        d.terminate();
+        path.resize(d.depth());
+    }
+
+    EXPECT_EQ(halving.survivors().size(), 1u);
+    EXPECT_GE(halving.survivors().front(), 4u);
+    // Below the root the wrapped UCB1 still spreads over all eight leaves.
+    const int leader = walker.walk(0, static_cast<int>(halving.survivors().front()));
+    for (int a : arms)
+        EXPECT_GT(visits.get_visits(walker.walk(leader, a)), 0u);
+}
+
+// ---------------------------------------------------------------------------
+// RaveTest
+//
+// An order-free picking game: each of D steps picks one of K items, and the
+// reward is the mean value of the picked items, however they were ordered.
+// AMAF credits an item wherever it was picked, which is exact here.  The
+// last item is worth 1 and the rest at most 0.8, so the best path is unique.
+// ---------------------------------------------------------------------------
+class RaveTest : public ::testing::Test
+{
+protected:
+    using items_t   = std::vector<int>;
+    using visits_t  = monte_carlo::visits_table<int, std::unordered_map>;
+    using value_t   = monte_carlo::value_table<int, double, std::unordered_map>;
+    using ec_t      = monte_carlo::uniform_exploration_constant<double>;
+    using amaf_t    = monte_carlo::amaf_table<int, int, double, std::map>;
+    using rave_t    = monte_carlo::rave<double, ec_t, amaf_t>;
+    using rollout_t = monte_carlo::random_rollout<int, std::mt19937, items_t, items_t>;
+
+    static constexpr int kItems = 16;
+    static constexpr int kDepth = 4;
+
+    struct pick_walker
+    {
+        int walk(const int& h, int a) const { return h * kItems + a + 1; }
+    };
+
+    static double item_value(int a)
+    {
+        return a == kItems - 1 ? 1.0 : 0.8 * (a * 5 % kItems) / double(kItems - 1);
+    }
+
+    // One sim episode of the picking game; returns the items picked.
+    template<typename ISelect>
+    items_t play(visits_t& visits, value_t& value, ISelect& select, std::mt19937& rng)
+    {
+        const items_t items = make_items();
+        rollout_t     rollout(rng);
+        pick_walker   walker;
+        monte_carlo::uniform_value_delta<double> delta;
+
+        monte_carlo::sim<
+            int, int, double,
+            visits_t, value_t, visits_t, value_t,
+            pick_walker,
+            items_t, items_t,
+            rollout_t,
+            monte_carlo::uniform_value_delta<double>,
+            ISelect
+        > s(visits, value, visits, value, walker, rollout, delta, select, 0);
+
+        items_t picked;
+        double  total = 0.0;
+        for (int d = 0; d < kDepth; ++d)
+        {
+            picked.push_back(s.choose(items, items));
+            total += item_value(picked.back());
+        }
+        delta.set_value(total / kDepth);
+        s.terminate();
+        return picked;
+    }
+
+    static items_t make_items()
+    {
+        items_t items(kItems);
+        std::iota(items.begin(), items.end(), 0);
+        return items;
+    }
+
+    // True once the most-visited path from the root picks the best item at
+    // every step, each node on it visited more than once.
+    static bool best_path(const visits_t& visits)
+    {
+        int h = 0;
+        for (int d = 0; d < kDepth; ++d)
+        {
+            int pick = 0;
+            for (int a = 1; a < kItems; ++a)
+                if (visits.get_visits(pick_walker{}.walk(h, a)) > visits.get_visits(pick_walker{}.walk(h, pick)))
+                    pick = a;
+            h = pick_walker{}.walk(h, pick);
+            if (pick != kItems - 1 || visits.get_visits(h) < 2)
+                return false;
+        }
+        return true;
+    }
+
+    // Sims until best_path() holds, checked every 10, or the cap.
+    template<typename ISelect>
+    int sims_to_best_path(ISelect& select, unsigned seed, int cap)
+    {
+        visits_t     visits;
+        value_t      value;
+        std::mt19937 rng(seed);
+        for (int i = 1; i <= cap; ++i)
+        {
+            play(visits, value, select, rng);
+            if (i % 10 == 0 && best_path(visits))
+                return i;
+        }
+        return cap;
+    }
+};
+
+TEST_F(RaveTest, TerminateCreditsEachLaterChoiceOncePerPathNode)
+{
+    ec_t         ec(1.0);
+    amaf_t       amaf;
+    rave_t       rave(ec, amaf, 100.0);
+    visits_t     visits;
+    value_t      value;
+    std::mt19937 rng(90);
+
+    // Grow the tree, checking every episode's AMAF credits as they land.
+    for (int e = 0; e < 50; ++e)
+    {
+        const amaf_t  before = amaf;
+        const items_t picked = play(visits, value, rave, rng);
+
+        double total = 0.0;
+        for (int a : picked)
+            total += item_value(a);
+
+        // The selection path ends at the node this episode expanded.
+        std::vector<int> path = {0};
+        while (path.size() <= picked.size())
+        {
+            path.push_back(pick_walker{}.walk(path.back(), picked[path.size() - 1]));
+            if (visits.get_visits(path.back()) == 1)
+                break;
+        }
+
+        std::map<std::pair<int, int>, size_t> expected;
+        for (size_t j = 0; j < path.size() && j < picked.size(); ++j)
+        {
+            std::vector<int> seen;
+            for (size_t k = j; k < picked.size(); ++k)
+                if (std::find(seen.begin(), seen.end(), picked[k]) == seen.end())
+                {
+                    seen.push_back(picked[k]);
+                    ++expected[{path[j], picked[k]}];
+                }
+        }
+
+        for (const auto& [key, n] : expected)
+        {
+            const auto now  = amaf.get_amaf(key.first, key.second);
+            const auto then = before.get_amaf(key.first, key.second);
+            EXPECT_EQ(now.visits, then.visits + n);
+            EXPECT_NEAR(now.value, then.value + n * total / kDepth, 1e-9);
+        }
+    }
+}
+
+TEST_F(RaveTest, FindsTheBestPathInFewerSimsThanUcb1)
+{
+    // Each with its own tuned constant: AMAF already spreads the early visits.
+    int rave_sims = 0;
+    int ucb_sims  = 0;
+
+    for (unsigned seed = 0; seed < 20; ++seed)
+    {
+        ec_t   rave_ec(0.1);
+        ec_t   ucb_ec(0.3);
+        amaf_t amaf;
+        rave_t rave(rave_ec, amaf, 100.0);
+
+        rave_sims += sims_to_best_path(rave, seed, 20000);
+        ucb_sims  += sims_to_best_path(ucb_ec, seed, 20000);
+    }
+
+    std::cerr << "sims to the best path over 20 seeds: rave " << rave_sims
+              << ", ucb1 " << ucb_sims << "\n";
+    EXPECT_LT(rave_sims * 2, ucb_sims);
+}
+
+TEST_F(RaveTest, SequentialHalvingForwardsAmaf)
+{
+    using halving_t = monte_carlo::sequential_halving<int, double, rave_t>;
+    static_assert(requires (halving_t& h) { h.amaf(); });
+
+    ec_t         ec(0.1);
+    amaf_t       amaf;
+    rave_t       rave(ec, amaf, 100.0);
+    halving_t    halving(rave, 0, 200);
+    visits_t     visits;
+    value_t      value;
+    std::mt19937 rng(92);
+
+    EXPECT_EQ(&halving.amaf(), &amaf);
+    for (int e = 0; e < 200; ++e)
+    {
+        const amaf_t  before = amaf;
+        const items_t picked = play(visits, value, halving, rng);
+        EXPECT_EQ(amaf.get_amaf(0, picked.back()).visits, before.get_amaf(0, picked.back()).visits + 1);
+    }
+}
+
+TEST_F(RaveTest, MinimumMseScheduleAlsoConverges)
+{
+    ec_t   ec(0.1);
+    amaf_t amaf;
+    rave_t rave(ec, amaf, 0.1, monte_carlo::rave_schedule::minimum_mse);
+
+    EXPECT_LT(sims_to_best_path(rave, 91, 20000), 20000);
+}
+
+// ---------------------------------------------------------------------------
+// BatchPolicyTest
+//
+// geometric_batch_increment and adaptive_batch_size on their own, then as
+// dbuct's IComputeBatchSize on the coin-collecting game (path handles).
+// ---------------------------------------------------------------------------
+class BatchPolicyTest : public ::testing::Test
+{
+protected:
+    using visits_t     = monte_carlo::visits_table<std::vector<int>, path_unordered_map>;
+    using value_t      = monte_carlo::value_table<std::vector<int>, double, path_unordered_map>;
+    using dispatches_t = monte_carlo::dispatches_table<std::vector<int>, path_unordered_map>;
+    using rollout_t    = monte_carlo::random_rollout<
+                            jump_t, std::mt19937,
+                            std::vector<jump_t>, std::vector<jump_t>>;
+    using ec_t         = monte_carlo::uniform_exploration_constant<double>;
+    using adaptive_t   = monte_carlo::adaptive_batch_size<double>;
+    using child_t      = monte_carlo::ucb_child<double>;
+
+    static child_t visited(double mean, size_t n) { return {mean, n, n, 0.0, false, 0.0, 0}; }
+
+    // Consecutive UCB1 selections of child `chosen` with every mean frozen.
+    static size_t ucb1_run(std::vector<child_t> children, size_t parent_visits, size_t chosen,
+                           double c, size_t cap)
+    {
+        size_t run = 0;
+        while (run < cap)
+        {
+            size_t best       = 0;
+            double best_score = -std::numeric_limits<double>::infinity();
+            for (size_t i = 0; i < children.size(); ++i)
+            {
+                const double score = children[i].exploit
+                                   + c * std::sqrt(std::log(static_cast<double>(parent_visits))
+                                                   / static_cast<double>(children[i].n));
+                if (score > best_score)
+                {
+                    best_score = score;
+                    best       = i;
+                }
+            }
+            if (best != chosen)
+                break;
+            ++run;
+            ++children[chosen].n;
+            ++parent_visits;
+        }
+        return run;
+    }
+
+    // Trains dbuct on a coin-collecting track; returns the frames pushed
+    // (in-tree choices) and whether the greedy walk over means is optimal.
+    template<typename IBatch>
+    std::pair<size_t, bool> train(IBatch& batch, int seed, size_t track_length,
+                                  const std::vector<jump_t>& jumps, int sims)
+    {
+        using dbuct_t = monte_carlo::dbuct<
+            std::vector<int>, jump_t, double,
+            visits_t, value_t, visits_t, value_t,
+            dispatches_t, dispatches_t,
+            IBatch,
+            path_walker,
+            std::vector<jump_t>, std::vector<jump_t>,
+            rollout_t,
+            monte_carlo::uniform_value_delta<double>,
+            ec_t>;
+
+        std::mt19937                           rng(seed);
+        std::uniform_real_distribution<double> urd(-10, 10);
+        std::vector<double>                    track(track_length);
+        std::generate(track.begin(), track.end(), [&] { return urd(rng); });
+
+        visits_t         visits;
+        value_t          value;
+        dispatches_t     dispatches;
+        rollout_t        rollout(rng);
+        path_walker      walker;
+        ec_t             ec(100.0);
+        std::vector<int> path = {-1};
+        monte_carlo::uniform_value_delta<double> delta;
+
+        dbuct_t d(visits, value, visits, value, dispatches, dispatches, batch,
+                  walker, rollout, delta, ec, path);
+
+        size_t frames = 0;
+        for (int i = 0; i < sims; ++i)
+        {
+            double score = 0.0;
+            for (int pos : path)
+                if (pos >= 0 && pos < static_cast<int>(track.size()))
+                    score += track[pos];
+
+            int position = path.back();
+            while (true)
+            {
+                const bool in_tree = !d.in_rollout();
+                position += d.choose(jumps, jumps);
+                if (in_tree)
+                {
+                    path.push_back(position);
+                    ++frames;
+                }
+                if (position >= static_cast<int>(track.size()))
+                    break;
+                score += track[position];
+            }
+            delta.set_value(score);
+            d.terminate();
+            path.resize(d.depth());
+        }
+
+        // Greedy walk over node means.
+        std::vector<int> node  = {-1};
+        double           score = 0.0;
+        while (node.back() < static_cast<int>(track.size()))
+        {
+            std::vector<int> best;
+            double           best_mean = -std::numeric_limits<double>::infinity();
+            for (jump_t j : jumps)
+            {
+                std::vector<int> child = walker.walk(node, j);
+                const size_t     v     = visits.get_visits(child);
+                if (v > 0 && value.get_value(child) / static_cast<double>(v) > best_mean)
+                {
+                    best_mean = value.get_value(child) / static_cast<double>(v);
+                    best      = child;
+                }
+            }
+            if (best.empty())
+                return {frames, false};
+            node = best;
+            if (node.back() < static_cast<int>(track.size()))
+                score += track[node.back()];
+        }
+        return {frames, std::abs(score - optimal_cumulative_score(track, jumps)) < 1e-9};
+    }
+};
+
+TEST_F(BatchPolicyTest, GeometricGrantDoublesEveryIntervalUpToCap)
+{
+    monte_carlo::geometric_batch_increment batch(3, 5);
+
+    std::vector<size_t> grants;
+    for (size_t d = 0; d < 12; ++d)
+        grants.push_back(batch.compute_batch_size(d));
+    EXPECT_EQ(grants, (std::vector<size_t>{1, 1, 1, 2, 2, 2, 4, 4, 4, 5, 5, 5}));
+
+    monte_carlo::geometric_batch_increment vanilla(std::numeric_limits<size_t>::max());
+    EXPECT_EQ(vanilla.compute_batch_size(1000000), 1u);
+
+    monte_carlo::geometric_batch_increment uncapped(1);
+    EXPECT_EQ(uncapped.compute_batch_size(10), 1024u);
+    EXPECT_EQ(uncapped.compute_batch_size(200), std::numeric_limits<size_t>::max());
+}
+
+TEST_F(BatchPolicyTest, UcbGapGrantsTheRunUcb1WouldGiveTheChosenChild)
+{
+    adaptive_t batch(monte_carlo::batch_signal::ucb_gap, 1000);
+
+    // A clear leader, a close call, and a leader far ahead on visits.
+    const std::vector<std::vector<child_t>> cases = {
+        {visited(0.9, 20), visited(0.2, 10), visited(0.1, 10)},
+        {visited(0.50, 30), visited(0.49, 30)},
+        {visited(0.75, 400), visited(0.6, 50), visited(0.3, 50)},
+    };
+    for (const auto& children : cases)
+    {
+        size_t parent_visits = 1;
+        for (const child_t& c : children)
+            parent_visits += c.n;
+
+        auto stats = [&](size_t i) { return children[i]; };
+        const size_t run   = ucb1_run(children, parent_visits, 0, 0.5, 1000);
+        const size_t grant = batch.compute_batch_size(0, parent_visits, children.size(), 0, 0.5, stats);
+        ASSERT_GE(run, 1u);
+        EXPECT_EQ(grant, run);
+    }
+
+    // An unvisited sibling is expanded next, so the grant is 1.
+    std::vector<child_t> open = {visited(0.9, 100), visited(0.1, 1), {0.0, 0, 0, 0.0, false, 0.0, 0}};
+    auto open_stats = [&](size_t i) { return open[i]; };
+    EXPECT_EQ(batch.compute_batch_size(0, 102, 3, 0, 1.0, open_stats), 1u);
+}
+
+TEST_F(BatchPolicyTest, VisitShareGrantsTheChosenChildsOdds)
+{
+    adaptive_t batch(monte_carlo::batch_signal::visit_share, 5, 10);
+
+    std::vector<child_t> children = {visited(0.5, 90), visited(0.4, 6), visited(0.1, 3)};
+    auto stats = [&](size_t i) { return children[i]; };
+
+    EXPECT_EQ(batch.compute_batch_size(10, 100, 3, 0, 1.0, stats), 5u);   // 9, capped
+    EXPECT_EQ(batch.compute_batch_size(10, 100, 3, 1, 1.0, stats), 1u);   // 6 / 94
+    EXPECT_EQ(batch.compute_batch_size(9,  100, 3, 0, 1.0, stats), 1u);   // warming up
+
+    adaptive_t uncapped(monte_carlo::batch_signal::visit_share, 1000);
+    EXPECT_EQ(uncapped.compute_batch_size(0, 100, 3, 0, 1.0, stats), 9u);
+}
+
+TEST_F(BatchPolicyTest, DbuctConvergesWithEveryPolicyAndFewerFramesThanVanilla)
+{
+    const std::vector<jump_t> jumps = {2, 3, 5};
+
+    monte_carlo::linear_batch_increment    vanilla(std::numeric_limits<size_t>::max());
+    monte_carlo::geometric_batch_increment geometric(3, 64);
+    adaptive_t                             gap(monte_carlo::batch_signal::ucb_gap, 64, 3);
+    adaptive_t                             share(monte_carlo::batch_signal::visit_share, 64, 3);
+
+    const auto [vanilla_frames, vanilla_ok]     = train(vanilla, 34, 15, jumps, 20000);
+    const auto [geometric_frames, geometric_ok] = train(geometric, 34, 15, jumps, 20000);
+    const auto [gap_frames, gap_ok]             = train(gap, 34, 15, jumps, 20000);
+    const auto [share_frames, share_ok]         = train(share, 34, 15, jumps, 20000);
+
+    std::cerr << "frames pushed over 20000 sims: vanilla " << vanilla_frames
+              << ", geometric " << geometric_frames << ", ucb gap " << gap_frames
+              << ", visit share " << share_frames << "\n";
+
+    EXPECT_TRUE(vanilla_ok);
+    EXPECT_TRUE(geometric_ok);
+    EXPECT_TRUE(gap_ok);
+    EXPECT_TRUE(share_ok);
+    EXPECT_LT(geometric_frames, vanilla_frames);
+    EXPECT_LT(gap_frames, vanilla_frames);
+    EXPECT_LT(share_frames, vanilla_frames);
+}
+
+// ---------------------------------------------------------------------------
+// EngineReuseTest
+//
+// inline_stack on its own, then one sim / dbuct object reused across
+// episodes with reset(), against fresh objects on the terminal-reward game
+// (position handles).
+// ---------------------------------------------------------------------------
+class EngineReuseTest : public ::testing::Test
+{
+protected:
+    using visits_t     = monte_carlo::visits_table<int, std::map>;
+    using value_t      = monte_carlo::value_table<int, double, std::map>;
+    using dispatches_t = monte_carlo::dispatches_table<int, std::map>;
+    using batch_t      = monte_carlo::linear_batch_increment;
+    using rollout_t    = monte_carlo::random_rollout<
+                            jump_t, std::mt19937,
+                            std::vector<jump_t>, std::vector<jump_t>>;
+    using ec_t         = monte_carlo::uniform_exploration_constant<double>;
+    using delta_t      = monte_carlo::uniform_value_delta<double>;
+    using sim_t        = monte_carlo::sim<
+                            int, jump_t, double,
+                            visits_t, value_t, visits_t, value_t,
+                            position_walker,
+                            std::vector<jump_t>, std::vector<jump_t>,
+                            rollout_t, delta_t, ec_t>;
+
+    template<size_t MaxDepth>
+    using dbuct_t = monte_carlo::dbuct<
+                        int, jump_t, double,
+                        visits_t, value_t, visits_t, value_t,
+                        dispatches_t, dispatches_t,
+                        batch_t,
+                        position_walker,
+                        std::vector<jump_t>, std::vector<jump_t>,
+                        rollout_t, delta_t, ec_t,
+                        monte_carlo::no_edge_visits,
+                        monte_carlo::no_accumulator,
+                        MaxDepth>;
+
+    static std::vector<double> make_track(int seed, size_t length)
+    {
+        std::mt19937                           rng(seed);
+        std::uniform_real_distribution<double> urd(-10, 10);
+        std::vector<double>                    track(length);
+        std::generate(track.begin(), track.end(), [&] { return urd(rng); });
+        return track;
+    }
+
+    // Plays one episode from position `from`; returns the last in-bounds
+    // position.  on_tree(pos) is called for each in-tree dbuct choice.
+    template<typename Engine, typename OnTree>
+    static int play(Engine& e, delta_t& delta, const std::vector<double>& track,
+                    const std::vector<jump_t>& jumps, int from, OnTree on_tree)
+    {
+        const int size = static_cast<int>(track.size());
+        int       pos  = from;
+        int       last = from;
+        while (pos < size)
+        {
+            bool in_tree = false;
+            if constexpr (requires { e.in_rollout(); })
+                in_tree = !e.in_rollout();
+            last = pos;
+            pos += e.choose(jumps, jumps);
+            if (in_tree)
+                on_tree(pos);
+        }
+        // A dbuct frame camped past the end starts there and never moves.
+        delta.set_value(last < 0 || last >= size ? 0.0 : track[last]);
+        e.terminate();
+        return last;
+    }
+
+    static std::map<int, std::pair<size_t, double>> snapshot(const visits_t& visits, const value_t& value)
+    {
+        std::map<int, std::pair<size_t, double>> all;
+        visits.for_each([&](int h, size_t v) { all[h] = {v, value.get_value(h)}; });
+        return all;
+    }
+};
+
+TEST_F(EngineReuseTest, InlineStackSpillsPastCapacityAndKeepsOrder)
+{
+    monte_carlo::inline_stack<std::vector<int>, 4> stack;
+    for (int i = 0; i < 10; ++i)
+        stack.push(std::vector<int>(static_cast<size_t>(i), i));
+
+    ASSERT_EQ(stack.size(), 10u);
+    for (int i = 0; i < 10; ++i)
+        EXPECT_EQ(stack[static_cast<size_t>(i)], std::vector<int>(static_cast<size_t>(i), i));
+
+    const auto copy = stack;
+    while (stack.size() > 2)
+        stack.pop();
+    EXPECT_EQ(stack.top(), std::vector<int>(1, 1));
+    EXPECT_EQ(copy.size(), 10u);
+    EXPECT_EQ(copy.top(), std::vector<int>(9, 9));
+
+    stack.emplace(3, 7);
+    EXPECT_EQ(stack.top(), (std::vector<int>{7, 7, 7}));
+    stack.clear();
+    EXPECT_TRUE(stack.empty());
+}
+
+TEST_F(EngineReuseTest, ResetSimMatchesAFreshSimPerEpisode)
+{
+    const std::vector<double> track = make_track(92, 30);
+    const std::vector<jump_t> jumps = {1, 2, 3};
+
+    visits_t     fresh_visits, reused_visits;
+    value_t      fresh_value, reused_value;
+    std::mt19937 fresh_rng(92), reused_rng(92);
+    rollout_t    fresh_rollout(fresh_rng), reused_rollout(reused_rng);
+    position_walker walker;
+    delta_t      delta;
+    ec_t         ec(5.0);
+
+    sim_t reused(reused_visits, reused_value, reused_visits, reused_value,
+                 walker, reused_rollout, delta, ec, -1);
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        sim_t fresh(fresh_visits, fresh_value, fresh_visits, fresh_value,
+                    walker, fresh_rollout, delta, ec, -1);
+        const int a = play(fresh, delta, track, jumps, -1, [](int) {});
+
+        const int b = play(reused, delta, track, jumps, -1, [](int) {});
+        EXPECT_EQ(reused.length(), fresh.length());
+        reused.reset(-1);
+
+        ASSERT_EQ(a, b) << "episode " << i;
+    }
+    EXPECT_EQ(snapshot(fresh_visits, fresh_value), snapshot(reused_visits, reused_value));
+}
+
+TEST_F(EngineReuseTest, ResetDbuctFlushesLumpsAndStartsOverAtTheNewRoot)
+{
+    const std::vector<double> track = make_track(93, 30);
+    const std::vector<jump_t> jumps = {1, 2, 3};
+
+    visits_t        visits;
+    value_t         value;
+    dispatches_t    dispatches;
+    batch_t         batch(2);
+    std::mt19937    rng(93);
+    rollout_t       rollout(rng);
+    position_walker walker;
+    delta_t         delta;
+    ec_t            ec(5.0);
+
+    dbuct_t<64> d(visits, value, visits, value, dispatches, dispatches, batch,
+                  walker, rollout, delta, ec, -1);
+
+    std::vector<int> path = {-1};
+    for (int i = 0; i < 500; ++i)
+    {
+        play(d, delta, track, jumps, path.back(), [&](int pos) { path.push_back(pos); });
+        path.resize(d.depth());
+    }
+    ASSERT_GT(d.depth(), 1u);   // a frame is camping with its lump pending
+    EXPECT_LT(visits.get_visits(-1), 500u);
+
+    d.reset(0);
+    EXPECT_EQ(d.depth(), 1u);
+    EXPECT_EQ(visits.get_visits(-1), 500u);
+
+    // The next episodes start at position 0.
+    const size_t before = visits.get_visits(0);
+    path = {0};
+    for (int i = 0; i < 100; ++i)
+    {
+        play(d, delta, track, jumps, path.back(), [&](int pos) { path.push_back(pos); });
+        path.resize(d.depth());
+    }
+    d.reset(0);
+    EXPECT_EQ(visits.get_visits(0), before + 100);
+    EXPECT_EQ(visits.get_visits(-1), 500u);
+}
+
+TEST_F(EngineReuseTest, FramesPastMaxDepthSpillWithoutChangingTheSearch)
+{
+    const std::vector<double> track = make_track(94, 60);
+    const std::vector<jump_t> jumps = {1, 2};
+
+    auto run = [&](auto tag)
+    {
+        constexpr size_t MaxDepth = decltype(tag)::value;
+
+        visits_t        visits;
+        value_t         value;
+        dispatches_t    dispatches;
+        batch_t         batch(5);
+        std::mt19937    rng(94);
+        rollout_t       rollout(rng);
+        position_walker walker;
+        delta_t         delta;
+        ec_t            ec(5.0);
+        size_t          deepest = 0;
+
+        dbuct_t<MaxDepth> d(visits, value, visits, value, dispatches, dispatches, batch,
+                            walker, rollout, delta, ec, -1);
+
+        std::vector<int> path = {-1};
+        for (int i = 0; i < 3000; ++i)
+        {
+            play(d, delta, track, jumps, path.back(), [&](int pos)
+            {
+                path.push_back(pos);
+                deepest = std::max(deepest, path.size());
+            });
+            path.resize(d.depth());
+        }
+        d.reset(-1);
+        return std::make_pair(snapshot(visits, value), deepest);
+    };
+
+    const auto [spilled, spilled_depth] = run(std::integral_constant<size_t, 2>{});
+    const auto [inline_only, depth]     = run(std::integral_constant<size_t, 256>{});
+
+    EXPECT_GT(spilled_depth, 2u);
+    EXPECT_EQ(spilled_depth, depth);
+    EXPECT_EQ(spilled, inline_only);
+}
+
+// ---------------------------------------------------------------------------
+// SearchDriverTest
+//
+// search_driver over a game model of the terminal-reward game (position
+// handles), against the hand-written per-episode loops of EngineReuseTest.
+// ---------------------------------------------------------------------------
+class SearchDriverTest : public EngineReuseTest
+{
+protected:
+    // Reward: the last in-bounds position reached.
+    struct track_model
+    {
+        const std::vector<double>& track;
+        std::vector<jump_t>        jumps;
+        int                        pos  = -1;
+        int                        last = -1;
+
+        int  root() const     { return -1; }
+        void restart()        { pos = last = -1; }
+        bool terminal() const { return pos >= static_cast<int>(track.size()); }
+
+        const std::vector<jump_t>& choice_count() const { return jumps; }
+        const std::vector<jump_t>& choice_at() const    { return jumps; }
+
+        void apply(jump_t j)
+        {
+            last = pos;
+            pos += j;
+            ++applies;
+        }
+
+        double reward() const { return last < 0 ? 0.0 : track[last]; }
+
+        size_t applies = 0;
+    };
+
+    // The same game made and unmade in place: no restart(), undo() instead.
+    struct undo_model
+    {
+        track_model      model;
+        std::vector<int> history = {};   // last before each apply
+
+        int  root() const     { return model.root(); }
+        bool terminal() const { return model.terminal(); }
+
+        const std::vector<jump_t>& choice_count() const { return model.jumps; }
+        const std::vector<jump_t>& choice_at() const    { return model.jumps; }
+
+        void apply(jump_t j)
+        {
+            history.push_back(model.last);
+            model.apply(j);
+        }
+
+        void undo()
+        {
+            model.pos  = model.last;
+            model.last = history.back();
+            history.pop_back();
+        }
+
+        double reward() const { return model.reward(); }
+    };
+
+    template<typename Engine, typename Game = track_model>
+    using driver_t = monte_carlo::search_driver<Engine, Game, delta_t>;
+};
+
+TEST_F(SearchDriverTest, RunMatchesAHandWrittenSimLoopSeed95)
+{
+    const std::vector<double> track = make_track(95, 30);
+    const std::vector<jump_t> jumps = {1, 2, 3};
+
+    visits_t        loop_visits, driver_visits;
+    value_t         loop_value, driver_value;
+    std::mt19937    loop_rng(95), driver_rng(95);
+    rollout_t       loop_rollout(loop_rng), driver_rollout(driver_rng);
+    position_walker walker;
+    delta_t         loop_delta, driver_delta;
+    ec_t            ec(5.0);
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        sim_t s(loop_visits, loop_value, loop_visits, loop_value, walker, loop_rollout, loop_delta, ec, -1);
+        play(s, loop_delta, track, jumps, -1, [](int) {});
+    }
+
+    track_model          game{track, jumps};
+    driver_t<sim_t>      driver(game, driver_delta, driver_visits, driver_value, driver_visits,
+                                driver_value, walker, driver_rollout, driver_delta, ec, -1);
+    driver.run(1500);
+    driver.run(500);
+
+    EXPECT_EQ(driver.simulations(), 2000u);
+    EXPECT_EQ(snapshot(loop_visits, loop_value), snapshot(driver_visits, driver_value));
+}
+
+TEST_F(SearchDriverTest, DbuctResumesAtTheCampedFrameSeed96)
+{
+    const std::vector<double> track = make_track(96, 30);
+    const std::vector<jump_t> jumps = {1, 2, 3};
+
+    visits_t        loop_visits, driver_visits;
+    value_t         loop_value, driver_value;
+    dispatches_t    loop_dispatches, driver_dispatches;
+    batch_t         batch(3);
+    std::mt19937    loop_rng(96), driver_rng(96);
+    rollout_t       loop_rollout(loop_rng), driver_rollout(driver_rng);
+    position_walker walker;
+    delta_t         loop_delta, driver_delta;
+    ec_t            ec(5.0);
+
+    dbuct_t<64> d(loop_visits, loop_value, loop_visits, loop_value, loop_dispatches, loop_dispatches,
+                  batch, walker, loop_rollout, loop_delta, ec, -1);
+    // play() scores a frame camped past the end as its own position; the
+    // model scores the position it was reached from.
+    std::vector<int> path = {-1};
+    for (int i = 0; i < 1000; ++i)
+    {
+        if (path.back() >= static_cast<int>(track.size()))
+        {
+            loop_delta.set_value(path[path.size() - 2] < 0 ? 0.0 : track[path[path.size() - 2]]);
+            d.terminate();
+        }
+        else
+            play(d, loop_delta, track, jumps, path.back(), [&](int pos) { path.push_back(pos); });
+        path.resize(d.depth());
+    }
+
+    track_model           game{track, jumps};
+    driver_t<dbuct_t<64>> driver(game, driver_delta, driver_visits, driver_value, driver_visits,
+                                 driver_value, driver_dispatches, driver_dispatches, batch, walker,
+                                 driver_rollout, driver_delta, ec, -1);
+    driver.run(1000);
+
+    ASSERT_EQ(driver.engine().depth(), d.depth());
+    EXPECT_EQ(snapshot(loop_visits, loop_value), snapshot(driver_visits, driver_value));
+
+    d.reset(-1);
+    driver.reset();
+    EXPECT_EQ(driver.engine().depth(), 1u);
+    EXPECT_EQ(driver_visits.get_visits(-1), 1000u);
+    EXPECT_EQ(snapshot(loop_visits, loop_value), snapshot(driver_visits, driver_value));
+}
+
+TEST_F(SearchDriverTest, RunUntilReadsTheClockEveryCheckInterval)
+{
+    const std::vector<double> track = make_track(97, 30);
+    const std::vector<jump_t> jumps = {1, 2, 3};
+
+    visits_t        visits;
+    value_t         value;
+    std::mt19937    rng(97);
+    rollout_t       rollout(rng);
+    position_walker walker;
+    delta_t         delta;
+    ec_t            ec(5.0);
+
+    track_model     game{track, jumps};
+    driver_t<sim_t> driver(game, delta, visits, value, visits, value, walker, rollout, delta, ec, -1);
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(driver.run_until(start), 0u);
+
+    const size_t ran = driver.run_until(start + std::chrono::milliseconds(20), 16);
+    EXPECT_GE(std::chrono::steady_clock::now(), start + std::chrono::milliseconds(20));
+    EXPECT_GT(ran, 0u);
+    EXPECT_EQ(ran % 16, 0u);
+    EXPECT_EQ(driver.simulations(), ran);
+    EXPECT_EQ(visits.get_visits(-1), ran);
+}
+
+TEST_F(SearchDriverTest, StopRuleEndsTheRunBeforeItsBudgetSeed112)
+{
+    using stop_t = monte_carlo::early_stop<int, double, visits_t, value_t, position_walker>;
+
+    const std::vector<double> track = make_track(112, 30);
+    const std::vector<jump_t> jumps = {1, 2, 3};
+
+    auto stopped_run = [&](auto& game)
+    {
+        visits_t        visits;
+        value_t         value;
+        std::mt19937    rng(112);
+        rollout_t       rollout(rng);
+        position_walker walker;
+        delta_t         delta;
+        ec_t            ec(5.0);
+        stop_t          stop(visits, value, walker, monte_carlo::stop_rule::visit_gap, 100);
+
+        using game_t = std::remove_reference_t<decltype(game)>;
+        driver_t<sim_t, game_t> driver(game, delta, visits, value, visits, value, walker, rollout,
+                                       delta, ec, -1);
+        const size_t ran = driver.run(20000, stop, 100);
+
+        EXPECT_LT(ran, 20000u);
+        EXPECT_EQ(ran % 100, 0u);
+        EXPECT_EQ(stop.checks(), ran / 100);
+        EXPECT_EQ(driver.simulations(), ran);
+        EXPECT_EQ(visits.get_visits(-1), ran);
+
+        // The leader's margin over the runner-up exceeds what is left.
+        std::vector<size_t> root_visits;
+        for (jump_t j : jumps)
+            root_visits.push_back(visits.get_visits(walker.walk(-1, j)));
+        std::sort(root_visits.rbegin(), root_visits.rend());
+        EXPECT_GT(root_visits[0] - root_visits[1], 20000 - ran);
+        return ran;
+    };
+
+    track_model restarted{track, jumps};
+    undo_model  undone{{track, jumps}};
+    EXPECT_EQ(stopped_run(restarted), stopped_run(undone));
+    EXPECT_TRUE(undone.history.empty());
+}
+
+TEST_F(SearchDriverTest, UndoMatchesRestartAndReplayWithFewerMovesSeed98)
+{
+    const std::vector<double> track = make_track(98, 30);
+    const std::vector<jump_t> jumps = {1, 2, 3};
+
+    position_walker walker;
+    ec_t            ec(5.0);
+
+    auto run = [&](auto& game, auto engine_tag, auto&&... tables)
+    {
+        using engine_t = typename decltype(engine_tag)::type;
+        using game_t   = std::remove_reference_t<decltype(game)>;
+
+        visits_t     visits;
+        value_t      value;
+        std::mt19937 rng(98);
+        rollout_t    rollout(rng);
+        delta_t      delta;
+
+        driver_t<engine_t, game_t> driver(game, delta, visits, value, visits, value, tables...,
+                                          walker, rollout, delta, ec, -1);
+        driver.run(700);
+        driver.run(300);
+        return snapshot(visits, value);
+    };
+
+    // sim: every episode undone back to the root.
+    {
+        track_model restarted{track, jumps};
+        undo_model  undone{{track, jumps}, {}};
+        EXPECT_EQ(run(restarted, std::type_identity<sim_t>{}),
+                  run(undone, std::type_identity<sim_t>{}));
+        EXPECT_EQ(undone.model.pos, -1);
+        EXPECT_EQ(undone.model.applies, restarted.applies);
+    }
+
+    // dbuct: undone down to the camped frame, and no prefix replay.
+    {
+        dispatches_t restarted_dispatches, undone_dispatches;
+        batch_t      batch(3);
+        track_model  restarted{track, jumps};
+        undo_model   undone{{track, jumps}, {}};
+        EXPECT_EQ(run(restarted, std::type_identity<dbuct_t<64>>{},
+                      restarted_dispatches, restarted_dispatches, batch),
+                  run(undone, std::type_identity<dbuct_t<64>>{},
+                      undone_dispatches, undone_dispatches, batch));
+        EXPECT_EQ(undone.model.pos, -1);
+        EXPECT_TRUE(undone.history.empty());
+        EXPECT_LT(undone.model.applies, restarted.applies);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// DbuctAccumulatorTest
+//
+// The coin-collecting game of DbuctCoinCollectingGameTest with the camped
+// position and coin sum carried on dbuct's frames, against the path and
+// prefix sum the caller recomputes each episode in train().
+// ---------------------------------------------------------------------------
+class DbuctAccumulatorTest : public DbuctCoinCollectingGameTest
+{
+protected:
+    struct prefix
+    {
+        int    position = -1;
+        double score    = 0.0;
+    };
+
+    using prefix_dbuct_t = monte_carlo::dbuct<
+                               std::vector<int>, jump_t, double,
+                               visits_t, value_t, visits_t, value_t,
+                               dispatches_t, dispatches_t,
+                               batch_t,
+                               path_walker,
+                               std::vector<jump_t>, std::vector<jump_t>,
+                               rollout_t,
+                               monte_carlo::uniform_value_delta<double>,
+                               monte_carlo::uniform_exploration_constant<double>,
+                               monte_carlo::no_edge_visits,
+                               prefix>;
+};
+
+TEST_F(DbuctAccumulatorTest, FramesCarryTheCampedPrefixSeed99)
+{
+    std::mt19937                           track_rng(99);
+    std::uniform_real_distribution<double> urd(-10, 10);
+    std::vector<double>                    track(20);
+    std::generate(track.begin(), track.end(), [&] { return urd(track_rng); });
+    const std::vector<jump_t> jumps = {1, 2, 3};
+    const int                 size  = static_cast<int>(track.size());
+
+    visits_t         visits, prefix_visits;
+    value_t          value, prefix_value;
+    dispatches_t     dispatches, prefix_dispatches;
+    batch_t          batch(50);
+    std::mt19937     rng(99), prefix_rng(99);
+    rollout_t        rollout(rng), prefix_rollout(prefix_rng);
+    path_walker      walker;
+    monte_carlo::uniform_value_delta<double>          delta, prefix_delta;
+    monte_carlo::uniform_exploration_constant<double> ec(100.0);
+    const std::vector<int> root = {-1};
+
+    dbuct_t        d(visits, value, visits, value, dispatches, dispatches, batch,
+                     walker, rollout, delta, ec, root);
+    prefix_dbuct_t p(prefix_visits, prefix_value, prefix_visits, prefix_value,
+                     prefix_dispatches, prefix_dispatches, batch,
+                     walker, prefix_rollout, prefix_delta, ec, root);
+
+    auto accumulate = [&](const prefix& from, const std::vector<int>&, jump_t j)
+    {
+        const int to = from.position + j;
+        return prefix{to, from.score + (to < size ? track[to] : 0.0)};
+    };
+
+    std::vector<int> path    = root;
+    size_t           resumed = 0;
+    for (int i = 0; i < 20000; ++i)
+    {
+        // As in train(): the prefix recomputed over the camped path.
+        double base_score = 0.0;
+        for (int pos : path)
+            if (pos >= 0 && pos < size)
+                base_score += track[pos];
+
+        ASSERT_EQ(p.depth(), d.depth());
+        ASSERT_EQ(p.accumulated().position, path.back()) << "episode " << i;
+        ASSERT_DOUBLE_EQ(p.accumulated().score, base_score) << "episode " << i;
+        resumed += path.size() > 1;
+
+        int    position = path.back();
+        double ep_score = base_score;
+        while (position < size)
+        {
+            const jump_t chosen = d.choose(jumps, jumps);
+            position += chosen;
+            if (!d.in_rollout())
+                path.push_back(position);
+            if (position < size)
+                ep_score += track[position];
+        }
+        delta.set_value(ep_score);
+        d.terminate();
+        path.resize(d.depth());
+
+        // The accumulator alone: no path, no recomputation.
+        prefix at = p.accumulated();
+        while (at.position < size)
+            at = accumulate(at, root, p.choose(jumps, jumps, accumulate));
+        prefix_delta.set_value(at.score);
+        p.terminate();
+    }
+
+    EXPECT_GT(resumed, 1000u);
+    EXPECT_EQ(prefix_visits.get_visits(root), visits.get_visits(root));
+
+    d.reset(root);
+    p.reset(root);
+    EXPECT_EQ(p.depth(), 1u);
+    EXPECT_EQ(p.accumulated().position, -1);
+    EXPECT_EQ(p.accumulated().score, 0.0);
+
+    size_t nodes = 0;
+    visits.for_each([&](const std::vector<int>& h, size_t v)
+    {
+        ++nodes;
+        EXPECT_EQ(prefix_visits.get_visits(h), v);
+        EXPECT_DOUBLE_EQ(prefix_value.get_value(h), value.get_value(h));
+    });
+    EXPECT_GT(nodes, 100u);
+}
+
+
+// Corridor coin game: the jumps are {1, 2, 3} from the start and from every
+// position p with p % 5 == 4, and {1} everywhere else; the reward is the
+// coin sum.  With forced_moves no node reached by a forced step is stored.
+class ForcedMovesTest : public ::testing::Test
+{
+protected:
+    using visits_t     = monte_carlo::visits_table<std::vector<int>, path_unordered_map>;
+    using value_t      = monte_carlo::value_table<std::vector<int>, double, path_unordered_map>;
+    using dispatches_t = monte_carlo::dispatches_table<std::vector<int>, path_unordered_map>;
+    using batch_t      = monte_carlo::linear_batch_increment;
+    using choices_t    = monte_carlo::forced_moves<std::vector<jump_t>>;
+    using delta_t      = monte_carlo::uniform_value_delta<double>;
+    using ec_t         = monte_carlo::uniform_exploration_constant<double>;
+
+    template<typename Choices>
+    using rollout_t = monte_carlo::random_rollout<jump_t, std::mt19937, Choices, Choices>;
+
+    template<typename Choices>
+    using sim_t = monte_carlo::sim<
+                      std::vector<int>, jump_t, double,
+                      visits_t, value_t, visits_t, value_t,
+                      path_walker, Choices, Choices,
+                      rollout_t<Choices>, delta_t, ec_t>;
+
+    using dbuct_t = monte_carlo::dbuct<
+                        std::vector<int>, jump_t, double,
+                        visits_t, value_t, visits_t, value_t,
+                        dispatches_t, dispatches_t,
+                        batch_t,
+                        path_walker, choices_t, choices_t,
+                        rollout_t<choices_t>, delta_t, ec_t>;
+
+    static bool decides(int pos) { return pos == -1 || pos % 5 == 4; }
+
+    struct corridor
+    {
+        std::vector<double> track;
+        std::vector<jump_t> all    = {1, 2, 3};
+        std::vector<jump_t> single = {1};
+        choices_t           all_choices{all};
+        choices_t           single_choices{single};
+        int                 pos    = -1;
+        double              score  = 0.0;
+        size_t              applies = 0;
+
+        corridor(int seed, size_t length) : track(length)
+        {
+            std::mt19937                           rng(seed);
+            std::uniform_real_distribution<double> urd(-10, 10);
+            std::generate(track.begin(), track.end(), [&] { return urd(rng); });
+        }
+
+        // Copies would point their adapters at the original's jumps.
+        corridor(const corridor&) = delete;
+
+        int size() const { return static_cast<int>(track.size()); }
+
+        const std::vector<jump_t>& jumps(int at) const { return decides(at) ? all : single; }
+        const choices_t&           choices() const     { return decides(pos) ? all_choices : single_choices; }
+
+        // search_driver game model
+        std::vector<int> root() const     { return {-1}; }
+        void             restart()        { pos = -1; score = 0.0; }
+        bool             terminal() const { return pos >= size(); }
+        const choices_t& choice_count() const { return choices(); }
+        const choices_t& choice_at() const    { return choices(); }
+        double           reward() const       { return score; }
+
+        void apply(jump_t j)
+        {
+            pos += j;
+            if (pos < size())
+                score += track[pos];
+            ++applies;
+        }
+
+        double optimal() const
+        {
+            std::vector<double> best(track.size() + 1, 0.0);   // best[p + 1]
+            for (int p = size() - 1; p >= -1; --p)
+            {
+                best[p + 1] = -std::numeric_limits<double>::infinity();
+                for (jump_t j : jumps(p))
+                    best[p + 1] = std::max(best[p + 1], p + j < size() ? track[p + j] + best[p + j + 1] : 0.0);
+            }
+            return best[0];
+        }
+
+        // Walks the best mean at each decision point and the forced move
+        // elsewhere; returns the coin sum.
+        double greedy(const visits_t& visits, const value_t& value) const
+        {
+            path_walker      walker;
+            std::vector<int> node = {-1};
+            double           sum  = 0.0;
+            while (node.back() < size())
+            {
+                jump_t best      = 1;
+                double best_mean = -std::numeric_limits<double>::infinity();
+                for (jump_t j : jumps(node.back()))
+                {
+                    const std::vector<int> child = walker.walk(node, j);
+                    const size_t           v     = visits.get_visits(child);
+                    if (v > 0 && value.get_value(child) / static_cast<double>(v) > best_mean)
+                    {
+                        best_mean = value.get_value(child) / static_cast<double>(v);
+                        best      = j;
+                    }
+                }
+                node = walker.walk(node, best);
+                if (node.back() < size())
+                    sum += track[node.back()];
+            }
+            return sum;
+        }
+    };
+
+    // Stored nodes whose last step was forced.
+    static size_t forced_nodes(const visits_t& visits)
+    {
+        size_t n = 0;
+        visits.for_each([&](const std::vector<int>& h, size_t)
+        {
+            if (h.size() >= 2 && !decides(h[h.size() - 2]))
+                ++n;
+        });
+        return n;
+    }
+
+    // Stored nodes reached by a jump the game does not allow.
+    static size_t illegal_nodes(const corridor& game, const visits_t& visits)
+    {
+        size_t n = 0;
+        visits.for_each([&](const std::vector<int>& h, size_t)
+        {
+            for (size_t i = 1; i < h.size(); ++i)
+            {
+                const std::vector<jump_t>& legal = game.jumps(h[i - 1]);
+                if (std::find(legal.begin(), legal.end(), h[i] - h[i - 1]) == legal.end())
+                {
+                    ++n;
+                    break;
+                }
+            }
+        });
+        return n;
+    }
+
+    template<typename Choices, typename ChoicesOf>
+    static void train_sim(corridor& game, visits_t& visits, value_t& value, int seed, int sims,
+                          ChoicesOf choices_of)
+    {
+        std::mt19937       rng(seed);
+        rollout_t<Choices> rollout(rng);
+        path_walker        walker;
+        delta_t            delta;
+        ec_t               ec(30.0);
+
+        sim_t<Choices> s(visits, value, visits, value, walker, rollout, delta, ec, game.root());
+        for (int i = 0; i < sims; ++i)
+        {
+            game.restart();
+            while (!game.terminal())
+                game.apply(s.choose(choices_of(game.pos), choices_of(game.pos)));
+            delta.set_value(game.reward());
+            s.terminate();
+            s.reset(game.root());
+        }
+    }
+};
+
+TEST_F(ForcedMovesTest, SimStoresOnlyDecisionPointsSeed100)
+{
+    corridor game(100, 30);
+
+    visits_t folded_visits, plain_visits;
+    value_t  folded_value, plain_value;
+    train_sim<choices_t>(game, folded_visits, folded_value, 100, 20000,
+                         [&](int) -> const choices_t& { return game.choices(); });
+    train_sim<std::vector<jump_t>>(game, plain_visits, plain_value, 100, 20000,
+                                   [&](int p) -> const std::vector<jump_t>& { return game.jumps(p); });
+
+    EXPECT_GT(forced_nodes(plain_visits), 0u);
+    EXPECT_EQ(forced_nodes(folded_visits), 0u);
+    EXPECT_EQ(illegal_nodes(game, folded_visits), 0u);
+    size_t folded_nodes = 0, plain_nodes = 0;
+    folded_visits.for_each([&](const std::vector<int>&, size_t) { ++folded_nodes; });
+    plain_visits.for_each([&](const std::vector<int>&, size_t) { ++plain_nodes; });
+    EXPECT_LT(folded_nodes, plain_nodes);
+    EXPECT_EQ(folded_visits.get_visits({-1}), 20000u);
+
+    EXPECT_NEAR(game.greedy(plain_visits, plain_value), game.optimal(), 1e-9);
+    EXPECT_NEAR(game.greedy(folded_visits, folded_value), game.optimal(), 1e-9);
+}
+
+// RAVE with folded forced moves: every value delta terminate() reads,
+// including the last path node's AMAF delta, is at a handle the episode
+// actually reached.
+TEST_F(ForcedMovesTest, RaveReadsDeltasAlongTheEpisodeSeed111)
+{
+    struct recording_delta : delta_t
+    {
+        mutable std::vector<std::vector<int>> read;
+
+        double get_value_delta(const std::vector<int>& h) const
+        {
+            read.push_back(h);
+            return delta_t::get_value_delta(h);
+        }
+    };
+
+    using amaf_t     = monte_carlo::amaf_table<std::vector<int>, jump_t, double, std::map>;
+    using rave_t     = monte_carlo::rave<double, ec_t, amaf_t>;
+    using rave_sim_t = monte_carlo::sim<
+                           std::vector<int>, jump_t, double,
+                           visits_t, value_t, visits_t, value_t,
+                           path_walker, choices_t, choices_t,
+                           rollout_t<choices_t>, recording_delta, rave_t>;
+
+    corridor             game(111, 30);
+    visits_t             visits;
+    value_t              value;
+    std::mt19937         rng(111);
+    rollout_t<choices_t> rollout(rng);
+    path_walker          walker;
+    recording_delta      delta;
+    ec_t                 ec(30.0);
+    amaf_t               amaf;
+    rave_t               rave(ec, amaf, 100.0);
+    rave_sim_t           s(visits, value, visits, value, walker, rollout, delta, rave, game.root());
+
+    size_t checked = 0;
+    for (int i = 0; i < 500; ++i)
+    {
+        game.restart();
+        std::vector<int> trajectory = {-1};
+        while (!game.terminal())
+        {
+            game.apply(s.choose(game.choices(), game.choices()));
+            trajectory.push_back(game.pos);
+        }
+        delta.set_value(game.reward());
+        delta.read.clear();
+        s.terminate();
+
+        for (const std::vector<int>& h : delta.read)
+        {
+            ASSERT_LE(h.size(), trajectory.size());
+            EXPECT_TRUE(std::equal(h.begin(), h.end(), trajectory.begin()));
+            ++checked;
+        }
+        s.reset(game.root());
+    }
+
+    EXPECT_GT(checked, 1000u);
+    EXPECT_EQ(forced_nodes(visits), 0u);
+    EXPECT_GT(amaf.get_amaf({-1}, 1).visits, 0u);
+}
+
+// The driver replays folded moves on resume without counting them as
+// frames: a mismatch would walk handles the game does not allow.
+TEST_F(ForcedMovesTest, DriverReplaysFoldedMovesUnderDbuctSeed101)
+{
+    corridor game(101, 30);
+
+    visits_t     visits;
+    value_t      value;
+    dispatches_t dispatches;
+    batch_t      batch(50);
+    std::mt19937 rng(101);
+    rollout_t<choices_t> rollout(rng);
+    path_walker  walker;
+    delta_t      delta;
+    ec_t         ec(30.0);
+
+    monte_carlo::search_driver<dbuct_t, corridor, delta_t> driver(
+        game, delta, visits, value, visits, value, dispatches, dispatches, batch,
+        walker, rollout, delta, ec, game.root());
+    driver.run(30000);
+
+    EXPECT_EQ(forced_nodes(visits), 0u);
+    EXPECT_EQ(illegal_nodes(game, visits), 0u);
+    EXPECT_NEAR(game.greedy(visits, value), game.optimal(), 1e-9);
+}
+
+// Fixed-arity choice sets (std::array, choice_span<T, N>) select over a
+// compile-time count; the search must be the same as over a std::vector.
+class ChoiceArityTest : public EngineReuseTest
+{
+protected:
+    struct four_arms
+    {
+        static constexpr size_t arity = 4;
+
+        size_t size()       const { return arity; }
+        jump_t at(size_t i) const { return static_cast<jump_t>(i + 1); }
+    };
+
+    template<typename Choices>
+    using choice_rollout_t = monte_carlo::random_rollout<jump_t, std::mt19937, Choices, Choices>;
+
+    template<typename Choices>
+    using choice_sim_t = monte_carlo::sim<
+                             int, jump_t, double,
+                             visits_t, value_t, visits_t, value_t,
+                             position_walker, Choices, Choices,
+                             choice_rollout_t<Choices>, delta_t, ec_t>;
+
+    template<typename Choices>
+    using choice_dbuct_t = monte_carlo::dbuct<
+                               int, jump_t, double,
+                               visits_t, value_t, visits_t, value_t,
+                               dispatches_t, dispatches_t,
+                               batch_t,
+                               position_walker, Choices, Choices,
+                               choice_rollout_t<Choices>, delta_t, ec_t>;
+
+    // Trains on the track game with `choices` at every position; returns
+    // the tables' contents.
+    template<bool Dbuct, typename Choices>
+    static std::map<int, std::pair<size_t, double>> train(const std::vector<double>& track,
+                                                          const Choices& choices, int seed, int sims)
+    {
+        visits_t                  visits;
+        value_t                   value;
+        dispatches_t              dispatches;
+        batch_t                   batch(20);
+        std::mt19937              rng(seed);
+        choice_rollout_t<Choices> rollout(rng);
+        position_walker           walker;
+        delta_t                   delta;
+        ec_t                      ec(5.0);
+
+        auto episodes = [&](auto& e)
+        {
+            const int        size = static_cast<int>(track.size());
+            std::vector<int> path = {-1};   // dbuct: positions of the frames
+            for (int i = 0; i < sims; ++i)
+            {
+                int pos  = path.back();
+                int last = pos;
+                while (pos < size)
+                {
+                    bool in_tree = false;
+                    if constexpr (Dbuct)
+                        in_tree = !e.in_rollout();
+                    last = pos;
+                    pos += e.choose(choices, choices);
+                    if (in_tree)
+                        path.push_back(pos);
+                }
+                delta.set_value(last < 0 || last >= size ? 0.0 : track[last]);
+                e.terminate();
+                if constexpr (Dbuct)
+                    path.resize(e.depth());
+                else
+                    e.reset(-1);
+            }
+        };
+
+        if constexpr (Dbuct)
+        {
+            choice_dbuct_t<Choices> d(visits, value, visits, value, dispatches, dispatches, batch,
+                                      walker, rollout, delta, ec, -1);
+            episodes(d);
+        }
+        else
+        {
+            choice_sim_t<Choices> s(visits, value, visits, value, walker, rollout, delta, ec, -1);
+            episodes(s);
+        }
+        return snapshot(visits, value);
+    }
+};
+
+TEST_F(ChoiceArityTest, ArityIsKnownOnlyForFixedSizeChoiceSets)
+{
+    using arms_t = std::vector<jump_t>;
+
+    static_assert(monte_carlo::choice_arity_v<arms_t> == 0);
+    static_assert(monte_carlo::choice_arity_v<std::array<jump_t, 3>> == 3);
+    static_assert(monte_carlo::choice_arity_v<monte_carlo::choice_span<jump_t, 3>> == 3);
+    static_assert(monte_carlo::choice_arity_v<monte_carlo::choice_span<jump_t>> == 0);
+    static_assert(monte_carlo::choice_arity_v<four_arms> == 4);
+    static_assert(monte_carlo::choice_arity_v<monte_carlo::progressive_widening<arms_t>> == 0);
+    static_assert(std::is_same_v<decltype(monte_carlo::selection_count<four_arms>(4)),
+                                 std::integral_constant<size_t, 4>>);
+    static_assert(std::is_same_v<decltype(monte_carlo::selection_count<arms_t>(4)), size_t>);
+
+    const std::array<jump_t, 3>        jumps = {1, 2, 3};
+    monte_carlo::choice_span<jump_t, 3> fixed(jumps);
+    monte_carlo::choice_span<jump_t>    dynamic(jumps);
+    EXPECT_EQ(fixed.size(), 3u);
+    EXPECT_EQ(dynamic.size(), 3u);
+    EXPECT_EQ(fixed.at(2), 3);
+    EXPECT_EQ(dynamic.at(0), 1);
+}
+
+TEST_F(ChoiceArityTest, FixedAritySearchMatchesVectorSeed102)
+{
+    const std::vector<double>   track  = make_track(102, 30);
+    const std::vector<jump_t>   vector = {1, 2, 3};
+    const std::array<jump_t, 3> array  = {1, 2, 3};
+
+    const auto sim_vector = train<false>(track, vector, 102, 3000);
+    EXPECT_EQ(train<false>(track, array, 102, 3000), sim_vector);
+    EXPECT_EQ(train<false>(track, monte_carlo::choice_span<jump_t, 3>(vector), 102, 3000), sim_vector);
+    EXPECT_EQ(train<false>(track, monte_carlo::choice_span<jump_t>(vector), 102, 3000), sim_vector);
+
+    const auto dbuct_vector = train<true>(track, vector, 102, 3000);
+    EXPECT_EQ(train<true>(track, array, 102, 3000), dbuct_vector);
+    EXPECT_EQ(train<true>(track, monte_carlo::choice_span<jump_t, 3>(array), 102, 3000), dbuct_vector);
+    EXPECT_GT(dbuct_vector.size(), 20u);
+}
+
+TEST_F(ChoiceArityTest, StaticArityMemberIsHonouredSeed103)
+{
+    const std::vector<double> track = make_track(103, 40);
+    const std::vector<jump_t> arms  = {1, 2, 3, 4};
+
+    EXPECT_EQ(train<false>(track, four_arms{}, 103, 3000), train<false>(track, arms, 103, 3000));
+    EXPECT_EQ(train<true>(track, four_arms{}, 103, 3000),  train<true>(track, arms, 103, 3000));
+}
+
+// Tables over incremental_hash_map expose prefetch(); the engines hint every
+// child before scoring and sim the whole path before backprop.  Hints must
+// not change the search, and every handle read should have been hinted.
+class PrefetchTest : public EngineReuseTest
+{
+protected:
+    using inc_visits_t  = monte_carlo::visits_table<int, monte_carlo::incremental_hash_map>;
+    using inc_value_t   = monte_carlo::value_table<int, double, monte_carlo::incremental_hash_map>;
+    using inc_compact_t = monte_carlo::compact_stats_table<int, double, monte_carlo::incremental_hash_map,
+                                                           size_t, double>;
+
+    // Records every handle hinted and every handle read.
+    struct recording_visits : inc_visits_t
+    {
+        mutable std::set<int> hinted;
+        mutable std::set<int> read;
+
+        void prefetch(const int& h) const
+        {
+            hinted.insert(h);
+            inc_visits_t::prefetch(h);
+        }
+
+        size_t get_visits(const int& h) const
+        {
+            read.insert(h);
+            return inc_visits_t::get_visits(h);
+        }
+    };
+
+    template<typename Table>
+    static constexpr bool hints = requires (const Table& t, int h) { t.prefetch(h); };
+
+    template<typename Visits, typename Value>
+    using table_sim_t = monte_carlo::sim<
+                            int, jump_t, double,
+                            Visits, Value, Visits, Value,
+                            position_walker,
+                            std::vector<jump_t>, std::vector<jump_t>,
+                            rollout_t, delta_t, ec_t>;
+
+    template<typename Visits, typename Value>
+    using table_dbuct_t = monte_carlo::dbuct<
+                              int, jump_t, double,
+                              Visits, Value, Visits, Value,
+                              dispatches_t, dispatches_t,
+                              batch_t,
+                              position_walker,
+                              std::vector<jump_t>, std::vector<jump_t>,
+                              rollout_t, delta_t, ec_t>;
+
+    template<typename Engine, typename Visits, typename Value>
+    static void train(Visits& visits, Value& value, const std::vector<double>& track, int seed, int sims)
+    {
+        const std::vector<jump_t> jumps = {1, 2, 3};
+        dispatches_t              dispatches;
+        batch_t                   batch(20);
+        std::mt19937              rng(seed);
+        rollout_t                 rollout(rng);
+        position_walker           walker;
+        delta_t                   delta;
+        ec_t                      ec(5.0);
+
+        if constexpr (requires { std::declval<Engine&>().depth(); })
+        {
+            Engine           d(visits, value, visits, value, dispatches, dispatches, batch,
+                               walker, rollout, delta, ec, -1);
+            std::vector<int> path = {-1};
+            for (int i = 0; i < sims; ++i)
+            {
+                play(d, delta, track, jumps, path.back(), [&](int pos) { path.push_back(pos); });
+                path.resize(d.depth());
+            }
+        }
+        else
+        {
+            Engine s(visits, value, visits, value, walker, rollout, delta, ec, -1);
+            for (int i = 0; i < sims; ++i)
+            {
+                play(s, delta, track, jumps, -1, [](int) {});
+                s.reset(-1);
+            }
+        }
+    }
+
+    template<typename Visits, typename Value>
+    static std::map<int, std::pair<size_t, double>> contents(const Visits& visits, const Value& value)
+    {
+        std::map<int, std::pair<size_t, double>> all;
+        visits.for_each([&](int h, size_t v) { all[h] = {v, value.get_value(h)}; });
+        return all;
+    }
+};
+
+TEST_F(PrefetchTest, OnlyMapsWithPrefetchOfferIt)
+{
+    static_assert(hints<inc_visits_t>);
+    static_assert(hints<inc_value_t>);
+    static_assert(hints<inc_compact_t>);
+    static_assert(!hints<visits_t>);
+    static_assert(!hints<value_t>);
+
+    // Hints on empty tables are harmless.
+    inc_visits_t empty;
+    empty.prefetch(7);
+    const auto frozen = monte_carlo::freeze<int, double>(visits_t{}, value_t{});
+    frozen.prefetch(7);
+    EXPECT_EQ(empty.get_visits(7), 0u);
+    EXPECT_EQ(frozen.get_visits(7), 0u);
+}
+
+TEST_F(PrefetchTest, PrefetchingSearchMatchesPlainTablesSeed104)
+{
+    const std::vector<double> track = make_track(104, 30);
+
+    visits_t plain_visits;
+    value_t  plain_value;
+    train<sim_t>(plain_visits, plain_value, track, 104, 3000);
+
+    inc_visits_t inc_visits;
+    inc_value_t  inc_value;
+    train<table_sim_t<inc_visits_t, inc_value_t>>(inc_visits, inc_value, track, 104, 3000);
+    EXPECT_EQ(contents(inc_visits, inc_value), snapshot(plain_visits, plain_value));
+
+    inc_compact_t compact;
+    train<table_sim_t<inc_compact_t, inc_compact_t>>(compact, compact, track, 104, 3000);
+    EXPECT_EQ(contents(compact, compact), snapshot(plain_visits, plain_value));
+
+    visits_t plain_dbuct_visits;
+    value_t  plain_dbuct_value;
+    train<dbuct_t<64>>(plain_dbuct_visits, plain_dbuct_value, track, 104, 3000);
+
+    inc_visits_t inc_dbuct_visits;
+    inc_value_t  inc_dbuct_value;
+    train<table_dbuct_t<inc_visits_t, inc_value_t>>(inc_dbuct_visits, inc_dbuct_value, track, 104, 3000);
+    EXPECT_EQ(contents(inc_dbuct_visits, inc_dbuct_value), snapshot(plain_dbuct_visits, plain_dbuct_value));
+}
+
+TEST_F(PrefetchTest, EveryHandleReadWasHintedFirstSeed105)
+{
+    const std::vector<double> track = make_track(105, 30);
+
+    recording_visits sim_visits;
+    inc_value_t      sim_value;
+    train<table_sim_t<recording_visits, inc_value_t>>(sim_visits, sim_value, track, 105, 2000);
+
+    sim_visits.hinted.insert(-1);   // the root is read before anything is hinted
+    EXPECT_GT(sim_visits.read.size(), 20u);
+    EXPECT_TRUE(std::includes(sim_visits.hinted.begin(), sim_visits.hinted.end(),
+                              sim_visits.read.begin(), sim_visits.read.end()));
+
+    recording_visits dbuct_visits;
+    inc_value_t      dbuct_value;
+    train<table_dbuct_t<recording_visits, inc_value_t>>(dbuct_visits, dbuct_value, track, 105, 2000);
+
+    dbuct_visits.hinted.insert(-1);
+    EXPECT_GT(dbuct_visits.read.size(), 20u);
+    EXPECT_TRUE(std::includes(dbuct_visits.hinted.begin(), dbuct_visits.hinted.end(),
+                              dbuct_visits.read.begin(), dbuct_visits.read.end()));
+}
+
+// ---------------------------------------------------------------------------
+// LocalityLayoutTest
+//
+// relayout_tree copies a trained tree into fresh tables in locality order:
+// root, then each node's visited children as one group, most visited first,
+// expanding the most visited child next.
+// ---------------------------------------------------------------------------
+class LocalityLayoutTest : public PrefetchTest
+{
+protected:
+    // Records the order nodes are first inserted.
+    struct ordered_visits : visits_t
+    {
+        std::vector<int> order;
+
+        void set_visits(const int& h, size_t n)
+        {
+            if (get_visits(h) == 0)
+                order.push_back(h);
+            visits_t::set_visits(h, n);
+        }
+    };
+
+    // The visited children of h, most visited first, skipping those in placed.
+    static std::vector<int> group(const visits_t& visits, int h, const std::set<int>& placed)
+    {
+        std::vector<std::pair<size_t, int>> kids;
+        for (jump_t j : {1, 2, 3})
+            if (visits.get_visits(h + j) != 0 && !placed.contains(h + j))
+                kids.emplace_back(visits.get_visits(h + j), h + j);
+        std::stable_sort(kids.begin(), kids.end(),
+                         [](const auto& a, const auto& b) { return a.first > b.first; });
+        std::vector<int> out;
+        for (const auto& kid : kids)
+            out.push_back(kid.second);
+        return out;
+    }
+
+    const std::vector<jump_t> jumps = {1, 2, 3};
+};
+
+TEST_F(LocalityLayoutTest, CopiesTheTreeAndDropsUnreachableEntriesSeed106)
+{
+    const std::vector<double> track = make_track(106, 30);
+
+    visits_t visits;
+    value_t  value;
+    train<sim_t>(visits, value, track, 106, 3000);
+    const auto before = snapshot(visits, value);
+
+    // An entry no path from the root reaches, as left by an earlier root.
+    visits.set_visits(-50, 7);
+    value.set_value(-50, 1.5);
+
+    visits_t        into_visits;
+    value_t         into_value;
+    position_walker walker;
+    const size_t    placed = monte_carlo::relayout_tree(
+        visits, value, into_visits, into_value, walker,
+        [&](int) -> const std::vector<jump_t>& { return jumps; }, -1);
+
+    EXPECT_EQ(placed, before.size());
+    EXPECT_EQ(snapshot(into_visits, into_value), before);
+
+    // One table serving as both, and squares carried across.
+    inc_compact_t compact;
+    monte_carlo::relayout_tree(visits, value, compact, compact, walker,
+                               [&](int) -> const std::vector<jump_t>& { return jumps; }, -1);
+    EXPECT_EQ(contents(compact, compact), before);
+
+    monte_carlo::value_moments_table<int, double, std::map> moments, into_moments;
+    visits.for_each([&](int h, size_t) { moments.set_value_squares(h, 2.0 * h); });
+    visits_t moments_visits;
+    monte_carlo::relayout_tree(visits, moments, moments_visits, into_moments, walker,
+                               [&](int) -> const std::vector<jump_t>& { return jumps; }, -1);
+    ASSERT_NE(visits.get_visits(5), 0u);
+    EXPECT_EQ(into_moments.get_value_squares(5), 10.0);
+    EXPECT_EQ(into_moments.get_value_squares(-50), 0.0);
+}
+
+TEST_F(LocalityLayoutTest, PlacesSiblingGroupsHottestFirstSeed107)
+{
+    const std::vector<double> track = make_track(107, 30);
+
+    visits_t visits;
+    value_t  value;
+    train<sim_t>(visits, value, track, 107, 3000);
+
+    ordered_visits  into_visits;
+    value_t         into_value;
+    position_walker walker;
+    monte_carlo::relayout_tree(visits, value, into_visits, into_value, walker,
+                               [&](int) -> const std::vector<jump_t>& { return jumps; }, -1);
+
+    // Root, its children, then the children of each node down the most
+    // visited line, each group new to the layout and most visited first.
+    std::vector<int> expected = {-1};
+    std::set<int>    placed   = {-1};
+    for (int h = -1; expected.size() < 12;)
+    {
+        const std::vector<int> kids = group(visits, h, placed);
+        ASSERT_FALSE(kids.empty());
+        expected.insert(expected.end(), kids.begin(), kids.end());
+        placed.insert(kids.begin(), kids.end());
+        h = kids.front();
+    }
+    ASSERT_GE(into_visits.order.size(), expected.size());
+    EXPECT_EQ(std::vector<int>(into_visits.order.begin(),
+                               into_visits.order.begin() + static_cast<std::ptrdiff_t>(expected.size())),
+              expected);
+}
+
+// ---------------------------------------------------------------------------
+// SearchPoolTest
+//
+// search_pool runs many independent search_drivers on a few workers, one
+// slice at a time, until each has used its budget or passed its deadline.
+// ---------------------------------------------------------------------------
+class SearchPoolTest : public SearchDriverTest
+{
+protected:
+    // One search with everything it owns; drivers hold references, so
+    // sessions live behind unique_ptr.
+    struct session
+    {
+        std::vector<double> track;
+        std::vector<jump_t> jumps = {1, 2, 3};
+        visits_t            visits;
+        value_t             value;
+        std::mt19937        rng;
+        rollout_t           rollout;
+        position_walker     walker;
+        delta_t             delta;
+        ec_t                ec{5.0};
+        track_model         game;
+        driver_t<sim_t>     driver;
+
+        explicit session(int seed)
+            : track(make_track(seed, 30))
+            , rng(static_cast<unsigned>(seed))
+            , rollout(rng)
+            , game{track, jumps}
+            , driver(game, delta, visits, value, visits, value, walker, rollout, delta, ec, -1)
+        {}
+    };
+
+    // Records which search ran each slice.
+    struct logging_driver
+    {
+        int                      id;
+        std::vector<int>&        log;
+        std::shared_future<void> gate;
+        size_t                   sims = 0;
+
+        void run(size_t n)
+        {
+            if (gate.valid())
+                gate.wait();
+            log.push_back(id);
+            sims += n;
+        }
+
+        size_t simulations() const { return sims; }
+    };
+};
+
+TEST_F(SearchPoolTest, PooledSearchesMatchSearchingAloneSeed108)
+{
+    std::vector<std::unique_ptr<session>> alone, pooled;
+    for (int k = 0; k < 12; ++k)
+    {
+        alone.push_back(std::make_unique<session>(108 + k));
+        pooled.push_back(std::make_unique<session>(108 + k));
+    }
+
+    std::vector<size_t> tickets;
+    {
+        monte_carlo::search_pool<driver_t<sim_t>> pool(3, 7);
+        for (size_t k = 0; k < pooled.size(); ++k)
+            tickets.push_back(pool.submit(pooled[k]->driver, 200 + 50 * k));
+        pool.wait_all();
+
+        for (size_t k = 0; k < pooled.size(); ++k)
+            EXPECT_EQ(pool.wait(tickets[k]).simulations, 200 + 50 * k);
+    }
+
+    for (size_t k = 0; k < alone.size(); ++k)
+    {
+        alone[k]->driver.run(200 + 50 * k);
+        EXPECT_EQ(snapshot(pooled[k]->visits, pooled[k]->value), snapshot(alone[k]->visits, alone[k]->value));
+    }
+}
+
+TEST_F(SearchPoolTest, DeadlineEndsASearchBeforeItsBudget)
+{
+    using clock_type = std::chrono::steady_clock;
+
+    session late(109), early(110);
+    monte_carlo::search_pool<driver_t<sim_t>> pool(1, 16);
+
+    const size_t past  = pool.submit(early.driver, 1000, clock_type::now() - std::chrono::seconds(1));
+    const size_t timed = pool.submit(late.driver, std::numeric_limits<size_t>::max(),
+                                     clock_type::now() + std::chrono::milliseconds(30));
+
+    EXPECT_EQ(pool.wait(past).simulations, 0u);
+    EXPECT_EQ(early.visits.get_visits(-1), 0u);
+
+    const auto done = pool.wait(timed);
+    EXPECT_GT(done.simulations, 0u);
+    EXPECT_EQ(done.simulations % 16, 0u);
+    EXPECT_GE(done.latency, std::chrono::milliseconds(30));
+}
+
+TEST_F(SearchPoolTest, ADriverRunningShortEndsItsSearch)
+{
+    // Stops running after 25 simulations, as a driver on a solved root does.
+    struct short_driver
+    {
+        size_t sims = 0;
+
+        void run(size_t n) { sims = std::min<size_t>(sims + n, 25); }
+
+        size_t simulations() const { return sims; }
+    };
+
+    short_driver                           driver;
+    monte_carlo::search_pool<short_driver> pool(2, 10);
+    EXPECT_EQ(pool.wait(pool.submit(driver, 1000)).simulations, 25u);
+}
+
+TEST_F(SearchPoolTest, OneWorkerTakesSearchesInTurn)
+{
+    std::vector<int>   log;
+    std::promise<void> go;
+
+    std::vector<logging_driver> drivers;
+    for (int k = 0; k < 4; ++k)
+        drivers.push_back({k, log, k == 0 ? go.get_future().share() : std::shared_future<void>{}});
+
+    monte_carlo::search_pool<logging_driver> pool(1, 10);
+    for (int k = 0; k < 4; ++k)
+        pool.submit(drivers[k], 30 + 10 * k);   // 3, 4, 5 and 6 slices
+    go.set_value();
+    pool.wait_all();
+
+    const std::vector<int> expected = {0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 1, 2, 3, 2, 3, 3};
+    EXPECT_EQ(log, expected);
+}